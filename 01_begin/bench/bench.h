@@ -0,0 +1,80 @@
+/**
+ * @file bench.h
+ * @author l1ang70
+ * @brief A small built-in harness for the benchmarks of 01_begin
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace bench {
+
+class State {
+    using Clock = std::chrono::steady_clock;
+
+    size_t              iterations_;
+    size_t              bytes_processed_    = 0;
+    std::string         skip_reason_{};
+    Clock::time_point   start_;
+
+public:
+    explicit State(size_t iterations) : iterations_(iterations), start_(Clock::now()) {}
+
+    inline size_t iterations() const { return iterations_; }
+
+    // Restart the clock after the setup of a case, so only its loop is measured.
+    inline void resetTimer() { start_ = Clock::now(); }
+    inline double elapsedSeconds() const { return std::chrono::duration<double>(Clock::now() - start_).count(); }
+
+    // Bytes the whole loop moved, reported as a rate next to the time.
+    inline void setBytesProcessed(size_t bytes) { bytes_processed_ = bytes; }
+    inline size_t bytesProcessed() const { return bytes_processed_; }
+
+    // Mark the case as not runnable here, e.g. when no GL context could be created.
+    inline void skip(const std::string &reason) { skip_reason_ = reason; }
+    inline bool skipped() const { return !skip_reason_.empty(); }
+    inline const std::string& skipReason() const { return skip_reason_; }
+};
+
+typedef void (*CaseFunction)(State &state);
+
+bool registerCase(const char *name, CaseFunction function);
+
+// Create a headless GL context once and make it current. Returns false if there is none.
+bool headlessContext();
+
+// Path of a file under resource/ of the working directory, which is bin/ as for the samples.
+std::string resourcePath(const char *relative);
+
+// Keep the optimizer from discarding the computation of value.
+template <typename T>
+inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+}
+
+// Register a function void(bench::State&) as a benchmark case.
+#define BENCH_CASE(function) \
+    static bool function##_registered_ = bench::registerCase(#function, function)
+
+// Register function(state, arg) as the case "function/arg", e.g. once per object count.
+#define BENCH_CASE_ARG(function, arg) \
+    static bool function##_##arg##_registered_ = bench::registerCase(#function "/" #arg, \
+        [](bench::State &state) { function(state, arg); })
+
+#endif // !_BENCH_H_
\ No newline at end of file
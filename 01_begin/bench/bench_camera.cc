@@ -0,0 +1,39 @@
+#include "bench.h"
+#include "header/camera.h"
+
+#include <glm/glm.hpp>
+
+// Mouse look as the camera sample feeds it: every event recomputes the basis in update().
+static void
+CameraMouseMove(bench::State &state) {
+    opengl::Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        // small circles, so the pitch never sticks at its limit
+        camera.processMouseMove((i & 1) ? 3.0f : -2.0f, (i & 2) ? 1.5f : -1.5f);
+        bench::doNotOptimize(camera.front());
+    }
+}
+BENCH_CASE(CameraMouseMove);
+
+// A mouse event followed by the matrices of the frame, the cost of a moving camera.
+static void
+CameraMouseMoveMatrices(bench::State &state) {
+    opengl::Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        camera.processMouseMove((i & 1) ? 3.0f : -2.0f, (i & 2) ? 1.5f : -1.5f);
+        bench::doNotOptimize(camera.viewProjectionMatrix());
+    }
+}
+BENCH_CASE(CameraMouseMoveMatrices);
+
+// The matrices of a frame where the camera did not move, served from the cache.
+static void
+CameraMatricesCached(bench::State &state) {
+    opengl::Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        bench::doNotOptimize(camera.viewMatrix());
+        bench::doNotOptimize(camera.projectionMatrix());
+        bench::doNotOptimize(camera.viewProjectionMatrix());
+    }
+}
+BENCH_CASE(CameraMatricesCached);
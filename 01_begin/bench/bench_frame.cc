@@ -0,0 +1,225 @@
+#include "bench.h"
+#include "header/stb_image.h"
+#include "header/camera.h"
+#include "header/frustum.h"
+#include "header/program.h"
+#include "header/render_state.h"
+#include "header/ring_buffer.h"
+#include "header/shader.h"
+#include "header/transform_store.h"
+#include "header/uniform_buffer.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+// The scene of 01_opengl_camera: textured spinning cubes, the first ten in the classic
+// layout and the rest scattered in front of the camera, drawn into the headless framebuffer.
+class CameraScene {
+    opengl::Program         *program_       = nullptr;
+    opengl::UniformBuffer   *frame_buffer_  = nullptr;
+    unsigned int            vao_            = 0;
+    unsigned int            vbo_            = 0;
+    opengl::RingBuffer      *instance_ring_ = nullptr;
+    unsigned int            texture_        = 0;
+    bool                    instanced_;
+    opengl::Uniform<glm::mat4>  model_uniform_;
+
+    opengl::Camera          camera_{ glm::vec3(0.0f, 0.0f, 3.0f) };
+    uint64_t                frame_generation_   = ~0ull;
+    std::vector<glm::vec3>  positions_;
+    std::vector<float>      x_, y_, z_, radius_;
+    opengl::FrustumCuller   culler_;
+    opengl::TransformStore  transforms_;
+
+public:
+    CameraScene(size_t cube_count, bool instanced);
+    ~CameraScene();
+
+    inline bool valid() const { return program_ && texture_ && (!instanced_ || instance_ring_); }
+
+    // Render one frame at the given time and wait for it.
+    void frame(float time);
+};
+
+CameraScene::CameraScene(size_t cube_count, bool instanced) : instanced_(instanced) {
+    std::string running_path = bench::resourcePath("");
+    program_ = opengl::Program::create();
+    {
+        opengl::Shader vertex_shader((running_path + (instanced ? "shader/camera_instanced.vs" : "shader/camera.vs")).c_str(),
+                                     opengl::VERTEX_SHADER);
+        opengl::Shader fragment_shader((running_path + "shader/camera.fs").c_str(), opengl::FRAGMENT_SHADER);
+
+        program_->attachShader(&vertex_shader);
+        program_->attachShader(&fragment_shader);
+    }
+    if (!program_->link()) {
+        delete program_;
+        program_ = nullptr;
+        return;
+    }
+
+    const float vertices[] = {
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,   0.5f, -0.5f, -0.5f,  1.0f, 0.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,   0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,  -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,   0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,   0.5f, -0.5f,  0.5f,  0.0f, 0.0f,   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,   0.5f, -0.5f, -0.5f,  1.0f, 1.0f,   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    positions_ = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),  glm::vec3( 2.0f,  5.0f, -15.0f), glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f), glm::vec3( 2.4f, -0.4f, -3.5f),  glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),  glm::vec3( 1.5f,  2.0f, -2.5f),  glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+    positions_.resize(std::min(positions_.size(), cube_count));
+    std::mt19937 generator(42);
+    float half_extent = std::cbrt(static_cast<float>(cube_count) * 8.0f) * 0.5f;
+    std::uniform_real_distribution<float> xy(-half_extent, half_extent);
+    std::uniform_real_distribution<float> z(-2.0f * half_extent, 0.0f);
+    while (positions_.size() < cube_count)
+        positions_.push_back(glm::vec3(xy(generator), xy(generator), z(generator)));
+    for (size_t i = 0; i < positions_.size(); i++) {
+        x_.push_back(positions_[i].x);
+        y_.push_back(positions_[i].y);
+        z_.push_back(positions_[i].z);
+        radius_.push_back(std::sqrt(3.0f) * 0.5f);
+        transforms_.add(positions_[i], glm::vec3(1.0f, 0.3f, 0.5f), 0.0f, glm::radians(20.0f * i));
+    }
+
+    opengl::RenderState &state = opengl::RenderState::current();
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
+    state.bindVertexArray(vao_);
+    state.bindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    if (instanced_) {
+        instance_ring_ = opengl::RingBuffer::create(GL_ARRAY_BUFFER, cube_count * sizeof(glm::mat4));
+        if (!instance_ring_)
+            return;
+        state.bindBuffer(GL_ARRAY_BUFFER, instance_ring_->buffer());
+        for (unsigned int column = 0; column < 4; column++) {
+            glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(column * sizeof(glm::vec4)));
+            glEnableVertexAttribArray(2 + column);
+            glVertexAttribDivisor(2 + column, 1);
+        }
+    }
+
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(true);
+    unsigned char *data = stbi_load((running_path + "texture/wall.jpg").c_str(), &width, &height, &channels, 0);
+    if (data) {
+        glGenTextures(1, &texture_);
+        state.bindTexture(0, GL_TEXTURE_2D, texture_);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        stbi_image_free(data);
+    }
+
+    program_->use();
+    program_->setParam1("texture_sampler", 0);
+    if (!instanced_)
+        model_uniform_ = program_->uniform<glm::mat4>("model");
+    frame_buffer_ = opengl::UniformBuffer::create(sizeof(opengl::FrameData), opengl::FRAME_DATA_BINDING);
+    state.setDepthTest(true);
+}
+
+CameraScene::~CameraScene() {
+    opengl::RenderState &state = opengl::RenderState::current();
+    state.deleteVertexArray(vao_);
+    state.deleteBuffer(vbo_);
+    delete instance_ring_;
+    state.deleteTexture(texture_);
+    delete frame_buffer_;
+    delete program_;
+}
+
+void
+CameraScene::frame(float time) {
+    glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    opengl::RenderState &state = opengl::RenderState::current();
+    state.bindTexture(0, GL_TEXTURE_2D, texture_);
+    program_->use();
+    if (camera_.generation() != frame_generation_) {
+        frame_buffer_->update(opengl::FrameData(camera_.viewMatrix(), camera_.projectionMatrix(), camera_.position()));
+        frame_generation_ = camera_.generation();
+    }
+
+    state.bindVertexArray(vao_);
+    if (instanced_) {
+        instance_ring_->beginFrame();
+        opengl::RingAllocation models = instance_ring_->allocate(positions_.size() * sizeof(glm::mat4));
+        if (models.isValid()) {
+            transforms_.computeModels(time, static_cast<float*>(models.data));
+            instance_ring_->flush();
+            state.bindBuffer(GL_ARRAY_BUFFER, instance_ring_->buffer());
+            for (unsigned int column = 0; column < 4; column++) {
+                glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                      (void*)(models.offset + column * sizeof(glm::vec4)));
+            }
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei)positions_.size());
+        }
+        instance_ring_->endFrame();
+    } else {
+        auto &visible = culler_.cullSpheres(camera_.frustum(), x_.data(), y_.data(), z_.data(), radius_.data(), positions_.size());
+        for (uint32_t i : visible) {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), positions_[i]);
+            model = glm::rotate(model, time * glm::radians(20.0f * i), glm::vec3(1.0f, 0.3f, 0.5f));
+            program_->set(model_uniform_, model);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+    }
+    // what the swap would wait for, so one iteration is one whole frame
+    glFinish();
+}
+
+static void
+frameCameraScene(bench::State &state, size_t cube_count, bool instanced) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    CameraScene scene(cube_count, instanced);
+    if (!scene.valid())
+        return state.skip("can not load the camera scene");
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i)
+        scene.frame(i / 60.0f);
+}
+
+static void
+FrameCameraScene(bench::State &state, size_t cube_count) {
+    frameCameraScene(state, cube_count, false);
+}
+
+static void
+FrameCameraSceneInstanced(bench::State &state, size_t cube_count) {
+    frameCameraScene(state, cube_count, true);
+}
+
+BENCH_CASE_ARG(FrameCameraScene, 10);
+BENCH_CASE_ARG(FrameCameraScene, 1000);
+BENCH_CASE_ARG(FrameCameraSceneInstanced, 1000);
+BENCH_CASE_ARG(FrameCameraSceneInstanced, 100000);
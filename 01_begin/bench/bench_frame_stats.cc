@@ -0,0 +1,41 @@
+#include "bench.h"
+#include "header/frame_stats.h"
+
+#include <random>
+#include <vector>
+
+// Frame times around 16 ms with the odd long one, recorded into the histogram: what every
+// frame of a sample pays for its statistics besides the clock read.
+static void
+FrameTimeHistogramRecord(bench::State &state) {
+    std::mt19937 random(3);
+    std::lognormal_distribution<double> frame_ns(16.6, 0.25);
+    std::vector<uint64_t> times(4096);
+    for (auto &ns : times)
+        ns = (uint64_t)frame_ns(random);
+    opengl::FrameTimeHistogram histogram;
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i)
+        histogram.record(times[i % times.size()]);
+    bench::doNotOptimize(histogram.count());
+}
+
+// p50, p95 and p99 of a run of 100000 frames, the cost of a summary at every interval.
+static void
+FrameTimePercentiles(bench::State &state) {
+    std::mt19937 random(3);
+    std::lognormal_distribution<double> frame_ns(16.6, 0.25);
+    opengl::FrameTimeHistogram histogram;
+    for (int i = 0; i < 100000; i++)
+        histogram.record((uint64_t)frame_ns(random));
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        uint64_t sum = histogram.valueAt(0.50) + histogram.valueAt(0.95) + histogram.valueAt(0.99);
+        bench::doNotOptimize(sum);
+    }
+}
+
+BENCH_CASE(FrameTimeHistogramRecord);
+BENCH_CASE(FrameTimePercentiles);
@@ -0,0 +1,88 @@
+#include "bench.h"
+#include "header/camera.h"
+#include "header/frustum.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+#include <vector>
+
+// A field of objects around the default camera of the samples, most of it out of view.
+struct CullScene {
+    std::vector<float> x, y, z, half_x, half_y, half_z;
+    opengl::Frustum    frustum;
+
+    explicit CullScene(size_t count) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> size(0.25f, 2.0f);
+        for (size_t i = 0; i < count; ++i) {
+            x.push_back(position(rng));
+            y.push_back(position(rng));
+            z.push_back(position(rng));
+            half_x.push_back(size(rng));
+            half_y.push_back(size(rng));
+            half_z.push_back(size(rng));
+        }
+        opengl::Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+        frustum = camera.frustum(glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f));
+    }
+};
+
+static void
+cullSpheres(bench::State &state, size_t count, opengl::FrustumCuller::Kernel kernel) {
+    if (!opengl::FrustumCuller::kernelSupported(kernel))
+        return state.skip("kernel not supported on this CPU");
+    CullScene scene(count);
+    opengl::FrustumCuller culler;
+    state.resetTimer();
+    for (size_t n = 0; n < state.iterations(); ++n) {
+        auto &visible = culler.cullSpheres(scene.frustum, scene.x.data(), scene.y.data(), scene.z.data(),
+                                           scene.half_x.data(), count, kernel);
+        bench::doNotOptimize(visible.data());
+    }
+}
+
+static void
+cullBoxes(bench::State &state, size_t count, opengl::FrustumCuller::Kernel kernel) {
+    if (!opengl::FrustumCuller::kernelSupported(kernel))
+        return state.skip("kernel not supported on this CPU");
+    CullScene scene(count);
+    opengl::FrustumCuller culler;
+    state.resetTimer();
+    for (size_t n = 0; n < state.iterations(); ++n) {
+        auto &visible = culler.cullBoxes(scene.frustum, scene.x.data(), scene.y.data(), scene.z.data(),
+                                         scene.half_x.data(), scene.half_y.data(), scene.half_z.data(), count, kernel);
+        bench::doNotOptimize(visible.data());
+    }
+}
+
+static void
+CullSpheresScalar(bench::State &state, size_t count) {
+    cullSpheres(state, count, opengl::FrustumCuller::SCALAR);
+}
+
+static void
+CullSpheresSSE(bench::State &state, size_t count) {
+    cullSpheres(state, count, opengl::FrustumCuller::SSE);
+}
+
+static void
+CullBoxesScalar(bench::State &state, size_t count) {
+    cullBoxes(state, count, opengl::FrustumCuller::SCALAR);
+}
+
+static void
+CullBoxesSSE(bench::State &state, size_t count) {
+    cullBoxes(state, count, opengl::FrustumCuller::SSE);
+}
+
+BENCH_CASE_ARG(CullSpheresScalar, 100000);
+BENCH_CASE_ARG(CullSpheresSSE, 100000);
+BENCH_CASE_ARG(CullBoxesScalar, 100000);
+BENCH_CASE_ARG(CullBoxesSSE, 100000);
+BENCH_CASE_ARG(CullSpheresScalar, 1000000);
+BENCH_CASE_ARG(CullSpheresSSE, 1000000);
+BENCH_CASE_ARG(CullBoxesScalar, 1000000);
+BENCH_CASE_ARG(CullBoxesSSE, 1000000);
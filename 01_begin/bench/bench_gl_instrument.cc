@@ -0,0 +1,46 @@
+#include "bench.h"
+#include "header/gl_instrument.h"
+
+#include <glad/glad.h>
+
+// 64 calls a frame, half a state call the instrument checks for redundancy and half one it
+// only counts and times, without and with the hooks: what --gl-calls adds to every GL call.
+// Only hooked in a build with OPENGL_GL_INSTRUMENT.
+static void
+instrumentCalls(bench::State &state, bool hooked) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    opengl::GLInstrument &instrument = opengl::GLInstrument::current();
+    if (hooked && !opengl::GLInstrument::available())
+        return state.skip("built without OPENGL_GL_INSTRUMENT");
+    if (hooked && !instrument.install())
+        return state.skip("no GL instrument");
+
+    GLint value = 0;
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        for (int call = 0; call < 32; call++) {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glGetIntegerv(GL_UNPACK_ALIGNMENT, &value);
+        }
+        instrument.endFrame();
+    }
+    bench::doNotOptimize(value);
+    if (hooked) {
+        instrument.uninstall();
+        instrument.forget();
+    }
+}
+
+static void
+GLCallsDirect(bench::State &state) {
+    instrumentCalls(state, false);
+}
+
+static void
+GLCallsInstrumented(bench::State &state) {
+    instrumentCalls(state, true);
+}
+
+BENCH_CASE(GLCallsDirect);
+BENCH_CASE(GLCallsInstrumented);
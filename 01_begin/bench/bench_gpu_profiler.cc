@@ -0,0 +1,40 @@
+#include "bench.h"
+#include "header/gpu_profiler.h"
+
+#include <glad/glad.h>
+
+// A scope around nothing, 64 a frame, with the profiler off and on: the cost the render loop
+// pays per scope on the CPU, two glQueryCounter calls when on.
+static void
+profileScopes(bench::State &state, bool enabled) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    opengl::GpuProfiler &profiler = opengl::GpuProfiler::current();
+    if (enabled && !opengl::GpuProfiler::supported())
+        return state.skip("no timer queries");
+    profiler.setEnabled(enabled);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        for (int scope = 0; scope < 64; scope++) {
+            opengl::GpuScope pass("pass");
+        }
+        profiler.endFrame();
+    }
+    glFinish();
+    profiler.clear();
+    profiler.setEnabled(false);
+}
+
+static void
+GpuScopesDisabled(bench::State &state) {
+    profileScopes(state, false);
+}
+
+static void
+GpuScopesEnabled(bench::State &state) {
+    profileScopes(state, true);
+}
+
+BENCH_CASE(GpuScopesDisabled);
+BENCH_CASE(GpuScopesEnabled);
@@ -0,0 +1,21 @@
+#include "header/stb_image.h"
+#include "bench.h"
+
+#include <string>
+
+// Decoding the texture every textured sample loads at startup.
+static void
+ImageLoadWall(bench::State &state) {
+    std::string path = bench::resourcePath("texture/wall.jpg");
+    stbi_set_flip_vertically_on_load(true);
+
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        int width, height, channels;
+        unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+        if (!data)
+            return state.skip("can not load " + path);
+        bench::doNotOptimize(data[0]);
+        stbi_image_free(data);
+    }
+}
+BENCH_CASE(ImageLoadWall);
@@ -0,0 +1,164 @@
+#include "bench.h"
+#include "header/indirect_draw.h"
+#include "header/program.h"
+#include "header/render_state.h"
+#include "header/shader.h"
+#include "header/uniform_buffer.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+// Submission cost of many small meshes: a draw call with a uniform per mesh against one
+// glMultiDrawElementsIndirect. The view-projection is all zeros, so every triangle is
+// clipped and the time is the CPU and vertex work, not llvmpipe rasterizing.
+class IndirectScene {
+    opengl::Program                 *draw_program_      = nullptr;
+    opengl::Program                 *indirect_program_  = nullptr;
+    opengl::Program                 *cull_program_      = nullptr;
+    opengl::UniformBuffer           *frame_buffer_      = nullptr;
+    opengl::MeshArena               *arena_             = nullptr;
+    opengl::IndirectDrawList        *draw_list_         = nullptr;
+    unsigned int                    model_buffer_       = 0;
+    opengl::Uniform<glm::mat4>      model_uniform_;
+    std::vector<glm::mat4>          models_;
+
+    static opengl::Program* link(const std::vector<std::pair<std::string, opengl::ShaderType>> &shaders);
+
+public:
+    explicit IndirectScene(size_t draw_count);
+    ~IndirectScene();
+
+    inline bool valid() const { return draw_program_ && indirect_program_ && draw_list_; }
+
+    void drawPerCall();
+    void drawIndirect(bool cull);
+};
+
+opengl::Program*
+IndirectScene::link(const std::vector<std::pair<std::string, opengl::ShaderType>> &shaders) {
+    std::string running_path = bench::resourcePath("shader/");
+    opengl::Program *program = opengl::Program::create();
+    std::vector<opengl::Shader*> compiled;
+    for (auto &shader : shaders) {
+        compiled.push_back(new opengl::Shader((running_path + shader.first).c_str(), shader.second));
+        program->attachShader(compiled.back());
+    }
+    bool linked = program->link();
+    for (auto *shader : compiled)
+        delete shader;
+    if (!linked) {
+        delete program;
+        return nullptr;
+    }
+    return program;
+}
+
+IndirectScene::IndirectScene(size_t draw_count) {
+    if (!opengl::IndirectDrawList::supported())
+        return;
+    draw_program_ = link({ { "camera.vs", opengl::VERTEX_SHADER }, { "camera.fs", opengl::FRAGMENT_SHADER } });
+    indirect_program_ = link({ { "camera_indirect.vs", opengl::VERTEX_SHADER }, { "camera.fs", opengl::FRAGMENT_SHADER } });
+    cull_program_ = link({ { "cull_draws.cs", opengl::COMPUTE_SHADER } });
+    if (!draw_program_ || !indirect_program_ || !cull_program_)
+        return;
+    model_uniform_ = draw_program_->uniform<glm::mat4>("model");
+
+    // a quad, the smallest mesh that still goes through the index buffer
+    const float vertices[] = {
+        -0.5f, -0.5f, 0.0f,  0.0f, 0.0f,
+         0.5f, -0.5f, 0.0f,  1.0f, 0.0f,
+         0.5f,  0.5f, 0.0f,  1.0f, 1.0f,
+        -0.5f,  0.5f, 0.0f,  0.0f, 1.0f
+    };
+    const uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+    arena_ = opengl::MeshArena::create();
+    if (!arena_)
+        return;
+    uint32_t quad = arena_->add(vertices, 4, indices, 6);
+
+    std::vector<uint32_t> meshes(draw_count, quad);
+    std::vector<glm::vec4> spheres(draw_count, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+    draw_list_ = opengl::IndirectDrawList::create(*arena_, meshes, spheres, cull_program_);
+
+    models_.assign(draw_count, glm::mat4(1.0f));
+    glGenBuffers(1, &model_buffer_);
+    opengl::RenderState &state = opengl::RenderState::current();
+    state.bindBuffer(GL_SHADER_STORAGE_BUFFER, model_buffer_);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, models_.size() * sizeof(glm::mat4), models_.data(), GL_STATIC_DRAW);
+    state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, opengl::DRAW_MODELS_BINDING, model_buffer_);
+
+    frame_buffer_ = opengl::UniformBuffer::create(sizeof(opengl::FrameData), opengl::FRAME_DATA_BINDING);
+    frame_buffer_->update(opengl::FrameData(glm::mat4(0.0f), glm::mat4(0.0f), glm::vec3(0.0f)));
+}
+
+IndirectScene::~IndirectScene() {
+    delete draw_list_;
+    delete arena_;
+    opengl::RenderState::current().deleteBuffer(model_buffer_);
+    delete frame_buffer_;
+    delete cull_program_;
+    delete indirect_program_;
+    delete draw_program_;
+}
+
+void
+IndirectScene::drawPerCall() {
+    draw_program_->use();
+    for (auto &model : models_) {
+        draw_program_->set(model_uniform_, model);
+        arena_->draw(0);
+    }
+    glFinish();
+}
+
+void
+IndirectScene::drawIndirect(bool cull) {
+    if (cull)
+        draw_list_->cull();
+    indirect_program_->use();
+    draw_list_->draw(*arena_);
+    glFinish();
+}
+
+static void
+drawIndirectScene(bench::State &state, size_t draw_count, int mode) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    IndirectScene scene(draw_count);
+    if (!scene.valid())
+        return state.skip("no multi-draw indirect, compute or gl_DrawID");
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        if (mode == 0)
+            scene.drawPerCall();
+        else
+            scene.drawIndirect(mode == 2);
+    }
+}
+
+static void
+DrawPerCall(bench::State &state, size_t draw_count) {
+    drawIndirectScene(state, draw_count, 0);
+}
+
+static void
+DrawMultiIndirect(bench::State &state, size_t draw_count) {
+    drawIndirectScene(state, draw_count, 1);
+}
+
+// Including the compute pass that writes the commands.
+static void
+DrawMultiIndirectCulled(bench::State &state, size_t draw_count) {
+    drawIndirectScene(state, draw_count, 2);
+}
+
+BENCH_CASE_ARG(DrawPerCall, 1000);
+BENCH_CASE_ARG(DrawPerCall, 10000);
+BENCH_CASE_ARG(DrawMultiIndirect, 1000);
+BENCH_CASE_ARG(DrawMultiIndirect, 10000);
+BENCH_CASE_ARG(DrawMultiIndirectCulled, 1000);
+BENCH_CASE_ARG(DrawMultiIndirectCulled, 10000);
@@ -0,0 +1,202 @@
+#include "bench.h"
+#include "header/context.h"
+
+#include <glad/glad.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+struct Case {
+    const char      *name;
+    CaseFunction    function;
+};
+
+static std::vector<Case>&
+cases() {
+    static std::vector<Case> s_cases;
+    return s_cases;
+}
+
+bool
+registerCase(const char *name, CaseFunction function) {
+    cases().push_back({ name, function });
+    return true;
+}
+
+bool
+headlessContext() {
+    // Created on the first call and kept current for every case, it is never destroyed.
+    static opengl::Context *s_context = [] {
+        opengl::ContextOptions options;
+        options.headless = true;
+        return opengl::Context::create(options);
+    }();
+    return s_context != nullptr;
+}
+
+std::string
+resourcePath(const char *relative) {
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, sizeof(cwd)))
+        return std::string("resource/") + relative;
+    return std::string(cwd) + "/resource/" + relative;
+}
+
+struct Result {
+    const char  *name;
+    size_t      iterations;
+    double      real_ns;    // per iteration
+    double      cpu_ns;
+    double      bytes_per_second;   // 0 when the case does not count them
+    std::string skip_reason;
+};
+
+static std::string
+jsonString(const std::string &text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        if ((unsigned char)c < 0x20)
+            continue;
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// The layout of Google Benchmark's --benchmark_format=json, so its compare.py and other
+// tooling can diff two runs.
+static bool
+writeJson(const char *path, const char *executable, const std::vector<Result> &results) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        fprintf(stdout, "[Error] Can not write %s\n", path);
+        return false;
+    }
+    char date[64];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+    std::string renderer = "none", version = "none";
+    if (bench::headlessContext()) {
+        renderer = (const char*)glGetString(GL_RENDERER);
+        version = (const char*)glGetString(GL_VERSION);
+    }
+
+    fprintf(file, "{\n  \"context\": {\n");
+    fprintf(file, "    \"date\": %s,\n", jsonString(date).c_str());
+    fprintf(file, "    \"executable\": %s,\n", jsonString(executable).c_str());
+    fprintf(file, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(file, "    \"gl_renderer\": %s,\n", jsonString(renderer).c_str());
+    fprintf(file, "    \"gl_version\": %s\n", jsonString(version).c_str());
+    fprintf(file, "  },\n  \"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        fprintf(file, "%s\n    {\n      \"name\": %s,\n      \"run_name\": %s,\n      \"run_type\": \"iteration\",\n",
+                i ? "," : "", jsonString(r.name).c_str(), jsonString(r.name).c_str());
+        if (!r.skip_reason.empty()) {
+            fprintf(file, "      \"error_occurred\": true,\n      \"error_message\": %s\n    }",
+                    jsonString(r.skip_reason).c_str());
+            continue;
+        }
+        fprintf(file, "      \"iterations\": %zu,\n      \"real_time\": %.3f,\n      \"cpu_time\": %.3f,\n",
+                r.iterations, r.real_ns, r.cpu_ns);
+        if (r.bytes_per_second > 0.0)
+            fprintf(file, "      \"bytes_per_second\": %.3f,\n", r.bytes_per_second);
+        fprintf(file, "      \"time_unit\": \"ns\"\n    }");
+    }
+    fprintf(file, "\n  ]\n}\n");
+    fclose(file);
+    return true;
+}
+
+static void
+printUsage(const char *executable) {
+    fprintf(stdout, "usage: %s [filter] [--json file]\n"
+                    "  filter    only run the cases whose name contains it\n"
+                    "  --json    also write the results to file as JSON\n"
+                    "  --help    print this and exit\n", executable);
+}
+
+}
+
+// usage: 01_begin_bench [filter] [--json file]
+//   filter    only run the cases whose name contains it
+//   --json    also write the results to file as JSON
+//   --help    print this and exit, any other flag is an error
+int main(int argc, char **argv) {
+    // Every case runs until one batch of iterations takes at least this long.
+    const double min_time = 0.25;
+    const char *filter = nullptr;
+    const char *json_path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            bench::printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stdout, "[Error] --json needs a file\n");
+                return 1;
+            }
+            json_path = argv[++i];
+        } else if (argv[i][0] == '-' || filter) {
+            // a flag is never a filter, it would quietly match no case
+            fprintf(stdout, "[Error] Unknown argument %s\n", argv[i]);
+            bench::printUsage(argv[0]);
+            return 1;
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    std::vector<bench::Result> results;
+    for (auto &c : bench::cases()) {
+        if (filter && !strstr(c.name, filter))
+            continue;
+
+        size_t iterations = 1;
+        while (true) {
+            bench::State state(iterations);
+            std::clock_t cpu_start = std::clock();
+            c.function(state);
+            double elapsed = state.elapsedSeconds();
+            // includes the setup of the case, a close enough match for the loops measured here
+            double cpu_elapsed = (double)(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+            if (state.skipped()) {
+                fprintf(stdout, "%-40s skipped: %s\n", c.name, state.skipReason().c_str());
+                results.push_back({ c.name, 0, 0.0, 0.0, 0.0, state.skipReason() });
+                break;
+            }
+            if (elapsed >= min_time || iterations >= 1000000000) {
+                double bytes_per_second = elapsed > 0.0 ? state.bytesProcessed() / elapsed : 0.0;
+                fprintf(stdout, "%-40s %14.1f ns/iter %12zu iters", c.name, elapsed * 1e9 / iterations, iterations);
+                if (bytes_per_second > 0.0)
+                    fprintf(stdout, " %10.2f GB/s", bytes_per_second * 1e-9);
+                fprintf(stdout, "\n");
+                results.push_back({ c.name, iterations, elapsed * 1e9 / iterations, cpu_elapsed * 1e9 / iterations,
+                                    bytes_per_second, "" });
+                break;
+            }
+            // Aim a bit past min_time, but never grow by more than 10x in one step.
+            double multiplier = elapsed > 0.0 ? min_time * 1.4 / elapsed : 10.0;
+            iterations = std::max(iterations + 1, (size_t)(iterations * std::min(multiplier, 10.0)));
+        }
+    }
+
+    if (filter && results.empty()) {
+        fprintf(stdout, "[Error] No benchmark matches %s\n", filter);
+        return 1;
+    }
+    if (json_path && !bench::writeJson(json_path, argv[0], results))
+        return 1;
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "bench.h"
+#include "header/mesh.h"
+#include "header/program.h"
+#include "header/render_state.h"
+#include "header/shader.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// A UV sphere of rings x segments quads with its triangles shuffled, like geometry exported
+// without any thought for the vertex cache.
+static void
+shuffledSphere(int rings, int segments, std::vector<float> &vertices, std::vector<uint32_t> &indices) {
+    const float pi = 3.14159265f;
+    for (int r = 0; r <= rings; r++) {
+        for (int s = 0; s <= segments; s++) {
+            float theta = pi * r / rings, phi = 2.0f * pi * s / segments;
+            vertices.insert(vertices.end(), { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi),
+                                              (float)s / segments, (float)r / rings });
+        }
+    }
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (int r = 0; r < rings; r++) {
+        for (int s = 0; s < segments; s++) {
+            uint32_t a = r * (segments + 1) + s, b = a + 1, c = a + segments + 1, d = c + 1;
+            triangles.push_back({ a, c, b });
+            triangles.push_back({ b, c, d });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(3));
+    for (auto &triangle : triangles)
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+}
+
+// Weld, Tipsify, overdraw clusters and fetch order of the 64 x 128 sphere, on the CPU.
+static void
+MeshOptimize(bench::State &state) {
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    shuffledSphere(64, 128, vertices, indices);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        std::vector<float> unique;
+        std::vector<uint32_t> remap, welded(indices.size());
+        size_t vertex_count = opengl::Mesh::weldVertices(vertices.data(), vertices.size() / 5, 5, unique, remap);
+        for (size_t k = 0; k < indices.size(); k++)
+            welded[k] = remap[indices[k]];
+        opengl::Mesh::optimizeVertexCache(welded.data(), welded.size(), vertex_count, 16);
+        opengl::Mesh::optimizeOverdraw(welded.data(), welded.size(), unique.data(), vertex_count, 5, 16, 1.05f);
+        opengl::Mesh::optimizeVertexFetch(welded.data(), welded.size(), unique, 5);
+        bench::doNotOptimize(welded.data());
+    }
+}
+
+// A vertex shader heavy enough that transforming a vertex twice shows.
+static const char *MESH_VERTEX_SHADER = R"(#version 330 core
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texture_coordinate;
+out vec2 uv;
+void main() {
+    vec3 p = position;
+    for (int i = 0; i < 32; i++)
+        p += 0.001 * sin(p.yzx * float(i) + texture_coordinate.xyx);
+    uv = texture_coordinate;
+    gl_Position = vec4(p * 0.9, 1.0);
+}
+)";
+
+static const char *MESH_FRAGMENT_SHADER = R"(#version 330 core
+in vec2 uv;
+out vec4 color;
+void main() {
+    color = vec4(uv, 0.5, 1.0);
+}
+)";
+
+// The sphere drawn 8 times into a 64 x 64 viewport, so vertex work dominates the raster.
+static void
+drawSphere(bench::State &state, bool indexed, bool optimize) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    opengl::Program *program = opengl::Program::create();
+    {
+        opengl::Shader *vertex_shader = opengl::Shader::createFromSource(MESH_VERTEX_SHADER, opengl::VERTEX_SHADER);
+        opengl::Shader *fragment_shader = opengl::Shader::createFromSource(MESH_FRAGMENT_SHADER, opengl::FRAGMENT_SHADER);
+        program->attachShader(vertex_shader);
+        program->attachShader(fragment_shader);
+        delete vertex_shader;
+        delete fragment_shader;
+    }
+    if (!program->link()) {
+        delete program;
+        return state.skip("mesh shaders do not link");
+    }
+
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    shuffledSphere(64, 128, vertices, indices);
+    if (!indexed) {
+        // what glDrawArrays needs: every corner of every triangle spelled out
+        std::vector<float> expanded;
+        for (uint32_t index : indices)
+            expanded.insert(expanded.end(), vertices.begin() + index * 5, vertices.begin() + index * 5 + 5);
+        vertices.swap(expanded);
+        indices.resize(vertices.size() / 5);
+        for (size_t k = 0; k < indices.size(); k++)
+            indices[k] = (uint32_t)k;
+    }
+    opengl::MeshOptions options;
+    options.weld = indexed;
+    options.optimize = optimize;
+    opengl::Mesh *mesh = opengl::Mesh::create(vertices.data(), vertices.size() / 5, indices.data(), indices.size(), options);
+    opengl::RenderState &render_state = opengl::RenderState::current();
+    render_state.setViewport(0, 0, 64, 64);
+    program->use();
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        for (int draw = 0; draw < 8; draw++)
+            mesh->draw();
+        glFinish();
+    }
+    delete mesh;
+    delete program;
+}
+
+static void
+DrawSphereNonIndexed(bench::State &state) {
+    drawSphere(state, false, false);
+}
+
+static void
+DrawSphereShuffled(bench::State &state) {
+    drawSphere(state, true, false);
+}
+
+static void
+DrawSphereOptimized(bench::State &state) {
+    drawSphere(state, true, true);
+}
+
+BENCH_CASE(MeshOptimize);
+BENCH_CASE(DrawSphereNonIndexed);
+BENCH_CASE(DrawSphereShuffled);
+BENCH_CASE(DrawSphereOptimized);
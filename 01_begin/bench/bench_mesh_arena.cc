@@ -0,0 +1,110 @@
+#include "bench.h"
+#include "header/mesh_arena.h"
+#include "header/program.h"
+#include "header/range_allocator.h"
+#include "header/render_state.h"
+#include "header/shader.h"
+
+#include <glad/glad.h>
+
+#include <random>
+#include <vector>
+
+// 4096 live ranges of 3 to 3000 units, one freed at random and one allocated per step, as
+// meshes come and go in a streaming scene. Time per pair.
+static void
+RangeAllocatorChurn(bench::State &state) {
+    const size_t live_count = 4096;
+    std::mt19937 random(7);
+    std::uniform_int_distribution<uint32_t> size(3, 3000);
+    opengl::RangeAllocator allocator(live_count * 3000);
+    std::vector<opengl::RangeAllocator::Allocation> live;
+    for (size_t i = 0; i < live_count; i++)
+        live.push_back(allocator.allocate(size(random)));
+    std::vector<uint32_t> picks(65536), sizes(65536);
+    for (size_t i = 0; i < picks.size(); i++) {
+        picks[i] = random() % live_count;
+        sizes[i] = size(random);
+    }
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        size_t step = i % picks.size();
+        allocator.free(live[picks[step]]);
+        live[picks[step]] = allocator.allocate(sizes[step]);
+        bench::doNotOptimize(live[picks[step]]);
+    }
+}
+
+static const char *ARENA_VERTEX_SHADER = R"(#version 330 core
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texture_coordinate;
+out vec2 uv;
+void main() {
+    uv = texture_coordinate;
+    gl_Position = vec4(position, 1.0);
+}
+)";
+
+static const char *ARENA_FRAGMENT_SHADER = R"(#version 330 core
+in vec2 uv;
+out vec4 color;
+void main() {
+    color = vec4(uv, 0.0, 1.0);
+}
+)";
+
+// The 1024 quads of SwitchVertexArrays, sub-allocated from one arena: one vertex array and
+// buffer binding for all of them, a draw is only a base vertex and first index.
+static void
+DrawArenaMeshes(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    opengl::Program *program = opengl::Program::create();
+    {
+        opengl::Shader *vertex_shader = opengl::Shader::createFromSource(ARENA_VERTEX_SHADER, opengl::VERTEX_SHADER);
+        opengl::Shader *fragment_shader = opengl::Shader::createFromSource(ARENA_FRAGMENT_SHADER, opengl::FRAGMENT_SHADER);
+        program->attachShader(vertex_shader);
+        program->attachShader(fragment_shader);
+        delete vertex_shader;
+        delete fragment_shader;
+    }
+    if (!program->link()) {
+        delete program;
+        return state.skip("mesh arena shaders do not link");
+    }
+    opengl::MeshArena *arena = opengl::MeshArena::create();
+    if (!arena) {
+        delete program;
+        return state.skip("no mesh arena");
+    }
+    const size_t mesh_count = 1024;
+    std::vector<uint32_t> meshes;
+    for (size_t i = 0; i < mesh_count; i++) {
+        float x = (float)(i % 32) / 16.0f - 1.0f, y = (float)(i / 32) / 16.0f - 1.0f;
+        float vertices[] = {
+            x,           y,           0.0f, 0.0f, 0.0f,
+            x + 0.05f,   y,           0.0f, 1.0f, 0.0f,
+            x + 0.05f,   y + 0.05f,   0.0f, 1.0f, 1.0f,
+            x,           y + 0.05f,   0.0f, 0.0f, 1.0f,
+        };
+        const uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+        meshes.push_back(arena->add(vertices, 4, indices, 6));
+    }
+    opengl::RenderState::current().setViewport(0, 0, 64, 64);
+    program->use();
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        for (uint32_t mesh : meshes)
+            arena->draw(mesh);
+        glFinish();
+    }
+    glDisable(GL_RASTERIZER_DISCARD);
+    delete arena;
+    delete program;
+}
+
+BENCH_CASE(RangeAllocatorChurn);
+BENCH_CASE(DrawArenaMeshes);
@@ -0,0 +1,116 @@
+#include "bench.h"
+#include "header/mipmap.h"
+#include "header/render_state.h"
+#include "header/texture.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// RGBA noise, the worst case for nothing: every texel is filtered the same way.
+static std::vector<uint8_t>
+rgbaImage(size_t side) {
+    std::mt19937 rng(7);
+    std::vector<uint8_t> pixels(side * side * 4);
+    for (auto &p : pixels)
+        p = (uint8_t)rng();
+    return pixels;
+}
+
+// The whole chain below a side x side sRGB texture, on the CPU.
+static void
+mipChain(bench::State &state, size_t side, opengl::MipFilter filter, opengl::MipChain::Kernel kernel) {
+    if (!opengl::MipChain::kernelSupported(kernel))
+        return state.skip("kernel not supported on this CPU");
+    std::vector<uint8_t> rgba = rgbaImage(side);
+    opengl::MipOptions options;
+    options.filter = filter;
+    options.srgb = true;
+    opengl::MipChain chain;
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        chain.generate(rgba.data(), (int)side, (int)side, 4, options, kernel);
+        bench::doNotOptimize(chain.pixels(chain.levelCount() - 1));
+    }
+}
+
+static void
+MipChainBoxScalar(bench::State &state, size_t side) {
+    mipChain(state, side, opengl::BOX_FILTER, opengl::MipChain::SCALAR);
+}
+
+static void
+MipChainBoxSSE(bench::State &state, size_t side) {
+    mipChain(state, side, opengl::BOX_FILTER, opengl::MipChain::SSE);
+}
+
+static void
+MipChainBoxAVX2(bench::State &state, size_t side) {
+    mipChain(state, side, opengl::BOX_FILTER, opengl::MipChain::AVX2);
+}
+
+static void
+MipChainKaiserScalar(bench::State &state, size_t side) {
+    mipChain(state, side, opengl::KAISER_FILTER, opengl::MipChain::SCALAR);
+}
+
+static void
+MipChainKaiserAVX2(bench::State &state, size_t side) {
+    mipChain(state, side, opengl::KAISER_FILTER, opengl::MipChain::AVX2);
+}
+
+// What the render thread used to pay: glGenerateMipmap on an uploaded sRGB texture, waited for.
+static void
+GenerateMipmapGL(bench::State &state, size_t side) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::vector<uint8_t> rgba = rgbaImage(side);
+    opengl::TextureOptions options;
+    options.srgb = true;
+    opengl::Texture *texture = opengl::Texture::create((int)side, (int)side, 4, options);
+    texture->upload(rgba.data(), 4);
+    glFinish();
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        texture->generateMipmaps();
+        glFinish();
+    }
+    delete texture;
+}
+
+// The levels of a CPU chain uploaded instead, what is left on the render thread.
+static void
+UploadMipChain(bench::State &state, size_t side) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::vector<uint8_t> rgba = rgbaImage(side);
+    opengl::MipOptions mip_options;
+    mip_options.srgb = true;
+    opengl::MipChain chain;
+    chain.generate(rgba.data(), (int)side, (int)side, 4, mip_options);
+    opengl::TextureOptions options;
+    options.srgb = true;
+    opengl::Texture *texture = opengl::Texture::create((int)side, (int)side, 4, options);
+    texture->upload(rgba.data(), 4);
+    glFinish();
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        for (int level = 1; level < chain.levelCount(); level++)
+            texture->upload(chain.pixels(level), 4, 0, -1, level);
+        glFinish();
+    }
+    delete texture;
+}
+
+BENCH_CASE_ARG(MipChainBoxScalar, 1024);
+BENCH_CASE_ARG(MipChainBoxSSE, 1024);
+BENCH_CASE_ARG(MipChainBoxAVX2, 1024);
+BENCH_CASE_ARG(MipChainKaiserScalar, 1024);
+BENCH_CASE_ARG(MipChainKaiserAVX2, 1024);
+BENCH_CASE_ARG(GenerateMipmapGL, 1024);
+BENCH_CASE_ARG(UploadMipChain, 1024);
@@ -0,0 +1,107 @@
+#include "bench.h"
+#include "header/program.h"
+#include "header/program_batch.h"
+#include "header/program_cache.h"
+#include "header/shader.h"
+
+#include <glad/glad.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Full compile and link of the camera program, what every launch paid before the cache.
+static void
+ProgramCompileLink(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::string running_path = bench::resourcePath("shader/");
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        opengl::Program *program = opengl::Program::create();
+        {
+            opengl::Shader vertex_shader((running_path + "camera.vs").c_str(), opengl::VERTEX_SHADER);
+            opengl::Shader fragment_shader((running_path + "camera.fs").c_str(), opengl::FRAGMENT_SHADER);
+
+            program->attachShader(&vertex_shader);
+            program->attachShader(&fragment_shader);
+        }
+        program->link();
+        delete program;
+    }
+}
+BENCH_CASE(ProgramCompileLink);
+
+// Loading the same program from a warm cache.
+static void
+ProgramCacheLoad(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::string running_path = bench::resourcePath("");
+
+    opengl::ProgramCache cache(running_path + "cache/");
+    delete cache.load(running_path + "shader/camera.vs", running_path + "shader/camera.fs");
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i)
+        delete cache.load(running_path + "shader/camera.vs", running_path + "shader/camera.fs");
+}
+BENCH_CASE(ProgramCacheLoad);
+
+
+// Sources of the camera program made unique per call, so no driver-side cache can serve them.
+static std::vector<std::pair<std::string, opengl::ShaderType>>
+uniqueCameraSources() {
+    static size_t s_counter = 0;
+    std::string running_path = bench::resourcePath("shader/");
+    std::string vertex_source, fragment_source;
+    opengl::Shader::readSource((running_path + "camera.vs").c_str(), vertex_source);
+    opengl::Shader::readSource((running_path + "camera.fs").c_str(), fragment_source);
+    std::string tag = "\n// " + std::to_string(s_counter++) + "\n";
+    return { { vertex_source + tag, opengl::VERTEX_SHADER }, { fragment_source + tag, opengl::FRAGMENT_SHADER } };
+}
+
+// Compile and link 16 programs one at a time, waiting for each status.
+static void
+ProgramSequential16(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        for (int n = 0; n < 16; ++n) {
+            auto sources = uniqueCameraSources();
+            opengl::Program *program = opengl::Program::create();
+            {
+                std::unique_ptr<opengl::Shader> vertex_shader(opengl::Shader::createFromSource(sources[0].first, sources[0].second));
+                std::unique_ptr<opengl::Shader> fragment_shader(opengl::Shader::createFromSource(sources[1].first, sources[1].second));
+                vertex_shader->compileSuccess();
+                fragment_shader->compileSuccess();
+
+                program->attachShader(vertex_shader.get());
+                program->attachShader(fragment_shader.get());
+            }
+            program->link();
+            delete program;
+        }
+    }
+}
+BENCH_CASE(ProgramSequential16);
+
+// The same 16 programs submitted at once through ProgramBatch.
+static void
+ProgramBatch16(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        std::vector<std::unique_ptr<opengl::Program>> programs;
+        opengl::ProgramBatch batch;
+        for (int n = 0; n < 16; ++n)
+            programs.emplace_back(batch.add(uniqueCameraSources()));
+        batch.finish();
+    }
+}
+BENCH_CASE(ProgramBatch16);
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "header/render_state.h"
+
+#include <glad/glad.h>
+
+// The binds the sample loops did around every cube: vertex array, texture unit 0, unbind.
+static void
+StateBindsDriver(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    unsigned int vao = 0, texture = 0;
+    glGenVertexArrays(1, &vao);
+    glGenTextures(1, &texture);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        glBindVertexArray(vao);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glBindVertexArray(0);
+    }
+    glFinish();
+
+    // the cache was bypassed, do not let it keep stale bindings
+    opengl::RenderState::current().invalidate();
+    opengl::RenderState::current().deleteVertexArray(vao);
+    opengl::RenderState::current().deleteTexture(texture);
+}
+BENCH_CASE(StateBindsDriver);
+
+// The same requests through the render state cache, only the first reaches the driver.
+static void
+StateBindsCached(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    opengl::RenderState &render_state = opengl::RenderState::current();
+    unsigned int vao = 0, texture = 0;
+    glGenVertexArrays(1, &vao);
+    glGenTextures(1, &texture);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        render_state.bindVertexArray(vao);
+        render_state.bindTexture(0, GL_TEXTURE_2D, texture);
+    }
+    glFinish();
+
+    render_state.deleteVertexArray(vao);
+    render_state.deleteTexture(texture);
+}
+BENCH_CASE(StateBindsCached);
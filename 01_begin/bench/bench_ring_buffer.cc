@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "header/render_state.h"
+#include "header/ring_buffer.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <cstring>
+#include <vector>
+
+// Each iteration streams one frame of per-instance model matrices to the GL, the ways the
+// instanced camera sample could upload them.
+
+// Re-specify the data from a CPU copy every frame.
+static void
+StreamBufferSubData(bench::State &state, size_t count) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    opengl::RenderState &render_state = opengl::RenderState::current();
+    std::vector<glm::mat4> models(count, glm::mat4(1.0f));
+    unsigned int buffer = 0;
+    glGenBuffers(1, &buffer);
+    render_state.bindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        models[i % count][3][0] = (float)i;
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::mat4), models.data());
+        glFlush();
+    }
+    glFinish();
+    render_state.deleteBuffer(buffer);
+}
+
+// Orphan the buffer and map it again, what the sample did before the ring buffer.
+static void
+StreamMapInvalidate(bench::State &state, size_t count) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    opengl::RenderState &render_state = opengl::RenderState::current();
+    std::vector<glm::mat4> models(count, glm::mat4(1.0f));
+    unsigned int buffer = 0;
+    glGenBuffers(1, &buffer);
+    render_state.bindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        models[i % count][3][0] = (float)i;
+        void *data = glMapBufferRange(GL_ARRAY_BUFFER, 0, count * sizeof(glm::mat4),
+                                      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (data) {
+            memcpy(data, models.data(), count * sizeof(glm::mat4));
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glFlush();
+    }
+    glFinish();
+    render_state.deleteBuffer(buffer);
+}
+
+// Write into the frame's segment of the persistently mapped ring.
+static void
+StreamRingBuffer(bench::State &state, size_t count) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::vector<glm::mat4> models(count, glm::mat4(1.0f));
+    opengl::RingBuffer *ring = opengl::RingBuffer::create(GL_ARRAY_BUFFER, count * sizeof(glm::mat4));
+    if (!ring)
+        return state.skip("can not create the ring buffer");
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        models[i % count][3][0] = (float)i;
+        ring->beginFrame();
+        opengl::RingAllocation allocation = ring->allocate(count * sizeof(glm::mat4));
+        if (allocation.isValid())
+            memcpy(allocation.data, models.data(), count * sizeof(glm::mat4));
+        ring->endFrame();
+        glFlush();
+    }
+    glFinish();
+    delete ring;
+}
+
+BENCH_CASE_ARG(StreamBufferSubData, 1000);
+BENCH_CASE_ARG(StreamBufferSubData, 100000);
+BENCH_CASE_ARG(StreamMapInvalidate, 1000);
+BENCH_CASE_ARG(StreamMapInvalidate, 100000);
+BENCH_CASE_ARG(StreamRingBuffer, 1000);
+BENCH_CASE_ARG(StreamRingBuffer, 100000);
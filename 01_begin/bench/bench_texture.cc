@@ -0,0 +1,152 @@
+#include "bench.h"
+#include "header/render_state.h"
+#include "header/texture.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Three channels, the way stb_image returns wall.jpg, in a square of side x side pixels.
+static std::vector<uint8_t>
+rgbImage(size_t side) {
+    std::mt19937 rng(42);
+    std::vector<uint8_t> pixels(side * side * 3);
+    for (auto &p : pixels)
+        p = (uint8_t)rng();
+    return pixels;
+}
+
+static void
+expandRGB(bench::State &state, size_t side, opengl::Texture::Kernel kernel) {
+    if (!opengl::Texture::kernelSupported(kernel))
+        return state.skip("kernel not supported on this CPU");
+    std::vector<uint8_t> rgb = rgbImage(side);
+    std::vector<uint8_t> rgba(side * side * 4);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        opengl::Texture::expandRGB(rgb.data(), rgba.data(), side * side, kernel);
+        bench::doNotOptimize(rgba.data());
+    }
+}
+
+static void
+ExpandRGBScalar(bench::State &state, size_t side) {
+    expandRGB(state, side, opengl::Texture::SCALAR);
+}
+
+static void
+ExpandRGBSSE(bench::State &state, size_t side) {
+    expandRGB(state, side, opengl::Texture::SSE);
+}
+
+static void
+ExpandRGBAVX2(bench::State &state, size_t side) {
+    expandRGB(state, side, opengl::Texture::AVX2);
+}
+
+// One full level 0 upload of RGB pixels per iteration, the ways a 3-channel image can reach GL.
+
+// RGB8 storage, RGB pixels with the unpack alignment of 1 the samples never set.
+static void
+TextureUploadRGB8(bench::State &state, size_t side) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::vector<uint8_t> rgb = rgbImage(side);
+    opengl::TextureOptions options;
+    options.mipmaps = false;
+    options.expand_rgb = false;
+    opengl::Texture *texture = opengl::Texture::create((int)side, (int)side, 3, options);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        texture->upload(rgb.data(), 3);
+        glFinish();
+    }
+    delete texture;
+}
+
+// RGBA8 storage fed RGB pixels, the driver converts each texel.
+static void
+TextureUploadRGBConverted(bench::State &state, size_t side) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::vector<uint8_t> rgb = rgbImage(side);
+    opengl::TextureOptions options;
+    options.mipmaps = false;
+    opengl::Texture *texture = opengl::Texture::create((int)side, (int)side, 3, options);
+    opengl::RenderState &render_state = opengl::RenderState::current();
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        texture->bind(0);
+        render_state.setUnpackAlignment(1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, (int)side, (int)side, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+        glFinish();
+    }
+    delete texture;
+}
+
+// RGBA8 storage, expanded on the CPU first, what Texture::upload() does.
+static void
+TextureUploadExpanded(bench::State &state, size_t side) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::vector<uint8_t> rgb = rgbImage(side);
+    opengl::TextureOptions options;
+    options.mipmaps = false;
+    opengl::Texture *texture = opengl::Texture::create((int)side, (int)side, 3, options);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        texture->upload(rgb.data(), 3);
+        glFinish();
+    }
+    delete texture;
+}
+
+// A texture ready to sample from the JPEG: decode, expand, upload and build the mipmaps.
+static void
+TextureLoadJpeg(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::string path = bench::resourcePath("texture/wall.jpg");
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        opengl::Texture *texture = opengl::Texture::load(path);
+        if (!texture)
+            return state.skip("no wall.jpg");
+        glFinish();
+        delete texture;
+    }
+}
+
+// The same texture cooked to BC1, every level uploaded straight from the mapped file.
+static void
+TextureLoadKTX2(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::string path = bench::resourcePath("texture/wall.ktx2");
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        opengl::Texture *texture = opengl::Texture::loadKTX2(path);
+        if (!texture)
+            return state.skip("no wall.ktx2 or no BC1 support");
+        glFinish();
+        delete texture;
+    }
+}
+
+BENCH_CASE_ARG(ExpandRGBScalar, 1024);
+BENCH_CASE_ARG(ExpandRGBSSE, 1024);
+BENCH_CASE_ARG(ExpandRGBAVX2, 1024);
+BENCH_CASE_ARG(TextureUploadRGB8, 1024);
+BENCH_CASE_ARG(TextureUploadRGBConverted, 1024);
+BENCH_CASE_ARG(TextureUploadExpanded, 1024);
+BENCH_CASE(TextureLoadJpeg);
+BENCH_CASE(TextureLoadKTX2);
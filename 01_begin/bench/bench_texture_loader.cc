@@ -0,0 +1,63 @@
+#include "bench.h"
+#include "header/render_state.h"
+#include "header/stb_image.h"
+#include "header/texture_loader.h"
+
+#include <glad/glad.h>
+
+#include <string>
+
+// What one frame costs the GL thread while the wall texture keeps streaming in: each
+// iteration is a frame that wants a texture.
+
+// The samples before the loader: decode, upload and build the mipmaps in the frame.
+static void
+TextureLoadBlocking(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::string path = bench::resourcePath("texture/wall.jpg");
+    stbi_set_flip_vertically_on_load(true);
+    opengl::RenderState &render_state = opengl::RenderState::current();
+    unsigned int texture = 0;
+    glGenTextures(1, &texture);
+    render_state.bindTexture(0, GL_TEXTURE_2D, texture);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        int width, height, channels;
+        unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        if (!data)
+            return state.skip("can not load " + path);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        stbi_image_free(data);
+        glFinish();
+    }
+    render_state.deleteTexture(texture);
+}
+
+// Queue the texture and let update() upload at most budget_kib per frame, two in flight.
+static void
+TextureLoadAsync(bench::State &state, size_t budget_kib) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::string path = bench::resourcePath("texture/wall.jpg");
+    opengl::TextureLoaderOptions options;
+    options.upload_budget = budget_kib << 10;
+    opengl::TextureLoader *loader = opengl::TextureLoader::create(options);
+    if (!loader)
+        return state.skip("no texture loader");
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        if (loader->pending() < 2)
+            loader->load(path);
+        loader->update();
+        glFinish();
+    }
+    delete loader;
+}
+
+BENCH_CASE(TextureLoadBlocking);
+BENCH_CASE_ARG(TextureLoadAsync, 256);
+BENCH_CASE_ARG(TextureLoadAsync, 4096);
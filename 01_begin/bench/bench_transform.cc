@@ -0,0 +1,85 @@
+#include "bench.h"
+#include "header/transform_store.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+#include <vector>
+
+// Objects scattered like the cubes of the camera sample, each spinning at its own speed.
+static void
+fillStore(opengl::TransformStore &store, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    store.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        store.add(glm::vec3(position(rng), position(rng), position(rng)), glm::vec3(1.0f, 0.3f, 0.5f),
+                  glm::radians(20.0f * i), glm::radians(20.0f * (i % 18)));
+    }
+}
+
+// One glm::translate and glm::rotate per object, as the samples did.
+static void
+TransformGlm(bench::State &state, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::vector<glm::vec3> positions(count);
+    for (auto &p : positions)
+        p = glm::vec3(position(rng), position(rng), position(rng));
+    std::vector<glm::mat4> models(count);
+
+    state.resetTimer();
+    for (size_t n = 0; n < state.iterations(); ++n) {
+        float time = 0.016f * n;
+        for (size_t i = 0; i < count; ++i) {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), positions[i]);
+            float angle = glm::radians(20.0f * i) + glm::radians(20.0f * (i % 18)) * time;
+            models[i] = glm::rotate(model, angle, glm::vec3(1.0f, 0.3f, 0.5f));
+        }
+        bench::doNotOptimize(models.data());
+    }
+}
+
+static void
+transformStore(bench::State &state, size_t count, opengl::TransformStore::Kernel kernel) {
+    if (!opengl::TransformStore::kernelSupported(kernel))
+        return state.skip("kernel not supported on this CPU");
+    opengl::TransformStore store;
+    fillStore(store, count);
+    std::vector<float> models(count * 16);
+
+    state.resetTimer();
+    for (size_t n = 0; n < state.iterations(); ++n) {
+        store.computeModels(0.016f * n, models.data(), kernel);
+        bench::doNotOptimize(models.data());
+    }
+}
+
+static void
+TransformScalar(bench::State &state, size_t count) {
+    transformStore(state, count, opengl::TransformStore::SCALAR);
+}
+
+static void
+TransformSSE(bench::State &state, size_t count) {
+    transformStore(state, count, opengl::TransformStore::SSE);
+}
+
+static void
+TransformAVX2(bench::State &state, size_t count) {
+    transformStore(state, count, opengl::TransformStore::AVX2);
+}
+
+BENCH_CASE_ARG(TransformGlm, 1000);
+BENCH_CASE_ARG(TransformScalar, 1000);
+BENCH_CASE_ARG(TransformSSE, 1000);
+BENCH_CASE_ARG(TransformAVX2, 1000);
+BENCH_CASE_ARG(TransformGlm, 100000);
+BENCH_CASE_ARG(TransformScalar, 100000);
+BENCH_CASE_ARG(TransformSSE, 100000);
+BENCH_CASE_ARG(TransformAVX2, 100000);
+BENCH_CASE_ARG(TransformGlm, 1000000);
+BENCH_CASE_ARG(TransformScalar, 1000000);
+BENCH_CASE_ARG(TransformSSE, 1000000);
+BENCH_CASE_ARG(TransformAVX2, 1000000);
@@ -0,0 +1,101 @@
+#include "bench.h"
+#include "header/program.h"
+#include "header/shader.h"
+#include "header/uniform_buffer.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <string>
+
+// Program of the camera sample, its model uniform is set once per cube per frame.
+static opengl::Program*
+cameraProgram() {
+    static opengl::Program *s_program = nullptr;
+    if (s_program)
+        return s_program;
+
+    std::string running_path = bench::resourcePath("shader/");
+    opengl::Program *program = opengl::Program::create();
+    {
+        opengl::Shader vertex_shader((running_path + "camera.vs").c_str(), opengl::VERTEX_SHADER);
+        opengl::Shader fragment_shader((running_path + "camera.fs").c_str(), opengl::FRAGMENT_SHADER);
+
+        program->attachShader(&vertex_shader);
+        program->attachShader(&fragment_shader);
+    }
+    if (!program->link()) {
+        delete program;
+        return nullptr;
+    }
+    program->use();
+    s_program = program;
+    return s_program;
+}
+
+// What Program::setMatrix4 did before the uniform table: a driver lookup for every set.
+static void
+UniformDriverLookup(bench::State &state) {
+    if (!bench::headlessContext() || !cameraProgram())
+        return state.skip("no GL context or program");
+    GLint program_id = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program_id);
+
+    glm::mat4 value(1.0f);
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        glUniformMatrix4fv(glGetUniformLocation(program_id, "model"), 1, GL_FALSE, &value[0][0]);
+    }
+    glFinish();
+}
+BENCH_CASE(UniformDriverLookup);
+
+// String names resolved through the table built at link time.
+static void
+UniformNameTable(bench::State &state) {
+    if (!bench::headlessContext() || !cameraProgram())
+        return state.skip("no GL context or program");
+    auto program = cameraProgram();
+
+    glm::mat4 value(1.0f);
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        program->setMatrix4("model", value);
+    }
+    glFinish();
+}
+BENCH_CASE(UniformNameTable);
+
+// Handles resolved once, the per-frame path has no lookups at all.
+static void
+UniformHandle(bench::State &state) {
+    if (!bench::headlessContext() || !cameraProgram())
+        return state.skip("no GL context or program");
+    auto program = cameraProgram();
+    auto model = program->uniform<glm::mat4>("model");
+
+    glm::mat4 value(1.0f);
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        program->set(model, value);
+    }
+    glFinish();
+}
+BENCH_CASE(UniformHandle);
+
+// The per-frame block: one buffer write shared by every program drawn in the frame.
+static void
+UniformFrameBuffer(bench::State &state) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    auto frame_buffer = opengl::UniformBuffer::create(sizeof(opengl::FrameData), opengl::FRAME_DATA_BINDING);
+
+    opengl::FrameData frame_data(glm::mat4(1.0f), glm::mat4(1.0f), glm::vec3(0.0f));
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i)
+        frame_buffer->update(frame_data);
+    glFinish();
+    delete frame_buffer;
+}
+BENCH_CASE(UniformFrameBuffer);
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "bench.h"
+#include "header/mesh.h"
+#include "header/program.h"
+#include "header/render_state.h"
+#include "header/shader.h"
+#include "header/vertex_format.h"
+
+#include <glad/glad.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Floats of a full vertex: position, normal, tangent with handedness, texture coordinate, color.
+static const size_t FULL_FLOATS = 16;
+
+// The full vertex as floats, 64 bytes.
+static opengl::VertexFormat
+floatFormat() {
+    return opengl::VertexFormat()
+        .add(0, 3, opengl::FLOAT32)
+        .add(1, 3, opengl::FLOAT32)
+        .add(2, 4, opengl::FLOAT32)
+        .add(3, 2, opengl::FLOAT32)
+        .add(4, 4, opengl::FLOAT32);
+}
+
+// The same packed to 24 bytes: positions on unorm16 across the bounds, octahedral normal and
+// tangent, unorm16 texture coordinates and unorm8 color.
+static opengl::VertexFormat
+quantizedFormat() {
+    return opengl::VertexFormat()
+        .add(0, 3, opengl::UNORM16, true)
+        .add(1, 3, opengl::OCTAHEDRAL16)
+        .add(2, 4, opengl::OCTAHEDRAL8)
+        .add(3, 2, opengl::UNORM16)
+        .add(4, 4, opengl::UNORM8);
+}
+
+// A UV sphere of radius 2 with every attribute, rings x segments quads.
+static void
+fullSphere(int rings, int segments, std::vector<float> &vertices, std::vector<uint32_t> &indices) {
+    const float pi = 3.14159265f;
+    for (int r = 0; r <= rings; r++) {
+        for (int s = 0; s <= segments; s++) {
+            float theta = pi * r / rings, phi = 2.0f * pi * s / segments;
+            float nx = std::sin(theta) * std::cos(phi), ny = std::cos(theta), nz = std::sin(theta) * std::sin(phi);
+            float u = (float)s / segments, v = (float)r / rings;
+            vertices.insert(vertices.end(), { 2.0f * nx, 2.0f * ny, 2.0f * nz, nx, ny, nz,
+                                              -std::sin(phi), 0.0f, std::cos(phi), 1.0f, u, v,
+                                              u, v, 0.5f, 1.0f });
+        }
+    }
+    for (int r = 0; r < rings; r++) {
+        for (int s = 0; s < segments; s++) {
+            uint32_t a = r * (segments + 1) + s, b = a + 1, c = a + segments + 1, d = c + 1;
+            indices.insert(indices.end(), { a, c, b, b, c, d });
+        }
+    }
+}
+
+// Packing the vertices of the 512 x 512 sphere, on the CPU. Bytes are the floats read.
+static void
+VertexEncode(bench::State &state) {
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    fullSphere(512, 512, vertices, indices);
+    size_t vertex_count = vertices.size() / FULL_FLOATS;
+    opengl::VertexFormat format = quantizedFormat();
+    std::vector<uint8_t> packed;
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        format.encode(vertices.data(), vertex_count, packed);
+        bench::doNotOptimize(packed.data());
+    }
+    state.setBytesProcessed(state.iterations() * vertices.size() * sizeof(float));
+}
+
+// Every attribute feeds the color, so none of the fetch can be skipped.
+static const char *FULL_VERTEX_SHADER = R"(
+layout (location = 0) in vec3 position;
+#ifdef QUANTIZED
+layout (location = 1) in vec2 normal_folded;
+layout (location = 2) in vec3 tangent_folded;
+uniform vec3 position_scale;
+uniform vec3 position_bias;
+#else
+layout (location = 1) in vec3 normal;
+layout (location = 2) in vec4 tangent;
+#endif
+layout (location = 3) in vec2 texture_coordinate;
+layout (location = 4) in vec4 color;
+out vec4 shade;
+void main() {
+#ifdef QUANTIZED
+    vec3 p = position * position_scale + position_bias;
+    vec3 n = octahedralDecode(normal_folded);
+    vec4 t = vec4(octahedralDecode(tangent_folded.xy), tangent_folded.z);
+#else
+    vec3 p = position;
+    vec3 n = normal;
+    vec4 t = tangent;
+#endif
+    shade = color * (0.5 + 0.5 * dot(n, vec3(0.6, 0.8, 0.0))) + vec4(texture_coordinate, t.x * t.w, 0.0) * 0.1;
+    gl_Position = vec4(p * 0.4, 1.0);
+}
+)";
+
+static const char *FULL_FRAGMENT_SHADER = R"(#version 330 core
+in vec4 shade;
+out vec4 color;
+void main() {
+    color = shade;
+}
+)";
+
+// The 512 x 512 sphere drawn 4 times into a 64 x 64 viewport, so fetching the vertices is
+// most of the work. Bytes are those of the vertex buffer, once a draw.
+static void
+drawVertices(bench::State &state, bool quantized) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    std::string source = std::string("#version 330 core\n") + (quantized ? "#define QUANTIZED\n" : "") +
+                         opengl::VertexFormat::OCTAHEDRAL_GLSL + FULL_VERTEX_SHADER;
+    opengl::Program *program = opengl::Program::create();
+    {
+        opengl::Shader *vertex_shader = opengl::Shader::createFromSource(source, opengl::VERTEX_SHADER);
+        opengl::Shader *fragment_shader = opengl::Shader::createFromSource(FULL_FRAGMENT_SHADER, opengl::FRAGMENT_SHADER);
+        program->attachShader(vertex_shader);
+        program->attachShader(fragment_shader);
+        delete vertex_shader;
+        delete fragment_shader;
+    }
+    if (!program->link()) {
+        delete program;
+        return state.skip("vertex format shaders do not link");
+    }
+
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    fullSphere(1024, 1024, vertices, indices);
+    // already in strip order, which is as good as the optimizer gets on a regular grid
+    opengl::MeshOptions options;
+    options.weld = false;
+    options.optimize = false;
+    options.format = quantized ? quantizedFormat() : floatFormat();
+    opengl::Mesh *mesh = opengl::Mesh::create(vertices.data(), vertices.size() / FULL_FLOATS, indices.data(),
+                                              indices.size(), options);
+    opengl::RenderState &render_state = opengl::RenderState::current();
+    render_state.setViewport(0, 0, 64, 64);
+    program->use();
+    if (quantized) {
+        const opengl::VertexAttribute &position = mesh->format().attribute(0);
+        glUniform3fv(program->uniformLocation("position_scale"), 1, position.scale);
+        glUniform3fv(program->uniformLocation("position_bias"), 1, position.bias);
+    }
+
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        for (int draw = 0; draw < 4; draw++)
+            mesh->draw();
+        glFinish();
+    }
+    glDisable(GL_RASTERIZER_DISCARD);
+    state.setBytesProcessed(state.iterations() * 4 * mesh->stats().vertices * mesh->stats().vertex_bytes);
+    delete mesh;
+    delete program;
+}
+
+static void
+DrawFloatVertices(bench::State &state) {
+    drawVertices(state, false);
+}
+
+static void
+DrawQuantizedVertices(bench::State &state) {
+    drawVertices(state, true);
+}
+
+BENCH_CASE(VertexEncode);
+BENCH_CASE(DrawFloatVertices);
+BENCH_CASE(DrawQuantizedVertices);
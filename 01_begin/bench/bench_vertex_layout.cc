@@ -0,0 +1,166 @@
+#include "bench.h"
+#include "header/program.h"
+#include "header/render_state.h"
+#include "header/shader.h"
+#include "header/vertex_array_cache.h"
+#include "header/vertex_layout.h"
+
+#include <glad/glad.h>
+
+#include <vector>
+
+using QuadLayout = opengl::VertexLayout<opengl::Attribute<0, float, 3>, opengl::Attribute<1, float, 2>>;
+
+static const size_t MESH_COUNT = 1024;
+
+static const char *LAYOUT_VERTEX_SHADER = R"(#version 330 core
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texture_coordinate;
+out vec2 uv;
+void main() {
+    uv = texture_coordinate;
+    gl_Position = vec4(position, 1.0);
+}
+)";
+
+static const char *LAYOUT_FRAGMENT_SHADER = R"(#version 330 core
+in vec2 uv;
+out vec4 color;
+void main() {
+    color = vec4(uv, 0.0, 1.0);
+}
+)";
+
+// MESH_COUNT meshes of one layout, a quad each in buffers of their own, as many small meshes
+// loaded one by one are. Drawn with rasterizer discard, so the time is switching between them.
+class LayoutScene {
+    opengl::Program             *program_   = nullptr;
+    std::vector<unsigned int>   vertex_arrays_;     // one per mesh, set up attribute by attribute
+    std::vector<unsigned int>   vertex_buffers_;
+    std::vector<unsigned int>   index_buffers_;
+
+public:
+    LayoutScene();
+    ~LayoutScene();
+
+    inline bool valid() const { return program_ != nullptr; }
+
+    // Bind the vertex array of every mesh, as without separate attribute formats.
+    void drawPerMeshVertexArrays();
+    // The one vertex array of the layout from the cache, rebinding the buffers of every mesh.
+    void drawSharedVertexArray();
+};
+
+LayoutScene::LayoutScene() {
+    program_ = opengl::Program::create();
+    {
+        opengl::Shader *vertex_shader = opengl::Shader::createFromSource(LAYOUT_VERTEX_SHADER, opengl::VERTEX_SHADER);
+        opengl::Shader *fragment_shader = opengl::Shader::createFromSource(LAYOUT_FRAGMENT_SHADER, opengl::FRAGMENT_SHADER);
+        program_->attachShader(vertex_shader);
+        program_->attachShader(fragment_shader);
+        delete vertex_shader;
+        delete fragment_shader;
+    }
+    if (!program_->link()) {
+        delete program_;
+        program_ = nullptr;
+        return;
+    }
+
+    opengl::RenderState &state = opengl::RenderState::current();
+    vertex_arrays_.resize(MESH_COUNT);
+    vertex_buffers_.resize(MESH_COUNT);
+    index_buffers_.resize(MESH_COUNT);
+    glGenVertexArrays(MESH_COUNT, vertex_arrays_.data());
+    glGenBuffers(MESH_COUNT, vertex_buffers_.data());
+    glGenBuffers(MESH_COUNT, index_buffers_.data());
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        float x = (float)(i % 32) / 16.0f - 1.0f, y = (float)(i / 32) / 16.0f - 1.0f;
+        float vertices[] = {
+            x,           y,           0.0f, 0.0f, 0.0f,
+            x + 0.05f,   y,           0.0f, 1.0f, 0.0f,
+            x + 0.05f,   y + 0.05f,   0.0f, 1.0f, 1.0f,
+            x,           y + 0.05f,   0.0f, 0.0f, 1.0f,
+        };
+        unsigned short indices[] = { 0, 1, 2, 2, 3, 0 };
+        state.bindVertexArray(vertex_arrays_[i]);
+        state.bindBuffer(GL_ARRAY_BUFFER, vertex_buffers_[i]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffers_[i]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+        opengl::setupVertexAttributes(QuadLayout::descriptor());
+    }
+    state.setViewport(0, 0, 64, 64);
+}
+
+LayoutScene::~LayoutScene() {
+    opengl::RenderState &state = opengl::RenderState::current();
+    for (size_t i = 0; i < vertex_arrays_.size(); i++) {
+        state.deleteVertexArray(vertex_arrays_[i]);
+        state.deleteBuffer(vertex_buffers_[i]);
+        state.deleteBuffer(index_buffers_[i]);
+    }
+    opengl::VertexArrayCache::current().clear();
+    delete program_;
+}
+
+void
+LayoutScene::drawPerMeshVertexArrays() {
+    opengl::RenderState &state = opengl::RenderState::current();
+    program_->use();
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        state.bindVertexArray(vertex_arrays_[i]);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+    }
+    glFinish();
+}
+
+void
+LayoutScene::drawSharedVertexArray() {
+    opengl::RenderState &state = opengl::RenderState::current();
+    program_->use();
+    constexpr opengl::LayoutDescriptor layout = QuadLayout::descriptor();
+    state.bindVertexArray(opengl::VertexArrayCache::current().vertexArray(layout));
+    for (size_t i = 0; i < MESH_COUNT; i++) {
+        state.bindVertexBuffer(0, vertex_buffers_[i], 0, layout.stride);
+        state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffers_[i]);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+    }
+    glFinish();
+}
+
+static void
+drawMeshes(bench::State &state, bool shared) {
+    if (!bench::headlessContext())
+        return state.skip("no GL context");
+    if (shared && !opengl::VertexArrayCache::supported())
+        return state.skip("no separate attribute formats");
+    LayoutScene scene;
+    if (!scene.valid())
+        return state.skip("vertex layout shaders do not link");
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    state.resetTimer();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        if (shared)
+            scene.drawSharedVertexArray();
+        else
+            scene.drawPerMeshVertexArrays();
+    }
+    glDisable(GL_RASTERIZER_DISCARD);
+}
+
+// 1024 meshes of one layout, a vertex array each.
+static void
+SwitchVertexArrays(bench::State &state) {
+    drawMeshes(state, false);
+}
+
+// The same sharing the cached vertex array of the layout, a buffer rebind a mesh.
+static void
+SwitchVertexBuffers(bench::State &state) {
+    drawMeshes(state, true);
+}
+
+BENCH_CASE(SwitchVertexArrays);
+BENCH_CASE(SwitchVertexBuffers);
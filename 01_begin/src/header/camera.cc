@@ -5,20 +5,87 @@
 namespace opengl {
 
 Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch)
-    : position_(position), up_(up), yaw_(yaw), pitch_(pitch),
+    : position_(position), up_(up), world_up_(up), yaw_(yaw), pitch_(pitch),
       front_(glm::vec3(0.0f, 0.0f, -1.0f)), move_speed_(SPEED), 
       mouse_sensitivity_(SENSITIVITY), zoom_(ZOOM) {
     update();
 }
 
-glm::mat4 
+void
+Camera::setViewport(int width, int height) {
+    if (width <= 0 || height <= 0)
+        return;     // minimized, keep the last aspect
+    float aspect = (float)width / (float)height;
+    if (aspect != aspect_) {
+        aspect_ = aspect;
+        projection_dirty_ = true;
+        generation_++;
+    }
+}
+
+void
+Camera::setClipPlanes(float near_plane, float far_plane) {
+    if (near_plane != near_ || far_plane != far_) {
+        near_ = near_plane;
+        far_ = far_plane;
+        projection_dirty_ = true;
+        generation_++;
+    }
+}
+
+const glm::mat4& 
 Camera::viewMatrix() {
-    return glm::lookAt(position_, position_ + front_, up_);
+    refresh();
+    return view_;
+}
+
+const glm::mat4& 
+Camera::inverseViewMatrix() {
+    refresh();
+    return inverse_view_;
+}
+
+const glm::mat4& 
+Camera::projectionMatrix() {
+    refresh();
+    return projection_;
+}
+
+const glm::mat4& 
+Camera::inverseProjectionMatrix() {
+    refresh();
+    return inverse_projection_;
+}
+
+const glm::mat4& 
+Camera::viewProjectionMatrix() {
+    refresh();
+    return view_projection_;
+}
+
+const glm::mat4& 
+Camera::inverseViewProjectionMatrix() {
+    refresh();
+    return inverse_view_projection_;
+}
+
+Frustum
+Camera::frustum() {
+    return Frustum(viewProjectionMatrix());
+}
+
+Frustum
+Camera::frustum(const glm::mat4 &projection) {
+    return Frustum(projection * viewMatrix());
 }
 
 void
 Camera::processKeyboard(MoveDirection direction, float delta_time) {
     float velocity = move_speed_ * delta_time;
+    if (velocity == 0.0f)
+        return;
+    view_dirty_ = true;
+    generation_++;
     if (direction == FORWARD)
         position_ += front_ * velocity;
     if (direction == BACKWARD)
@@ -34,6 +101,7 @@ Camera::processMouseMove(float x_offset, float y_offset, bool constrain_pitch) {
     x_offset *= mouse_sensitivity_;
     y_offset *= mouse_sensitivity_;
 
+    float yaw = yaw_, pitch = pitch_;
     yaw_    += x_offset;
     pitch_  += y_offset;
 
@@ -44,6 +112,9 @@ Camera::processMouseMove(float x_offset, float y_offset, bool constrain_pitch) {
         if (pitch_ < -89.0f)
             pitch_ = -89.0f;
     }
+    // a still mouse or a pitch pressed against the limit changes nothing
+    if (yaw_ == yaw && pitch_ == pitch)
+        return;
 
     // update Front, Right and Up Vectors using the updated Euler angles
     update();
@@ -51,11 +122,16 @@ Camera::processMouseMove(float x_offset, float y_offset, bool constrain_pitch) {
 
 void 
 Camera::processMouseScroll(float y_offset) {
+    float zoom = zoom_;
     zoom_ -= (float)y_offset;
     if (zoom_ < 1.0f)
         zoom_ = 1.0f;
     if (zoom_ > 45.0f)
         zoom_ = 45.0f; 
+    if (zoom_ != zoom) {
+        projection_dirty_ = true;
+        generation_++;
+    }
 }
 
 void
@@ -69,6 +145,27 @@ Camera::update() {
     // also re-calculate the Right and Up vector
     right_  = glm::normalize(glm::cross(front_, world_up_));  // normalize the vectors, because their length gets closer to 0 the more you look up or down which results in slower movement.
     up_     = glm::normalize(glm::cross(right_, front_));
+    view_dirty_ = true;
+    generation_++;
+}
+
+void
+Camera::refresh() {
+    if (!view_dirty_ && !projection_dirty_)
+        return;
+    if (view_dirty_) {
+        view_ = glm::lookAt(position_, position_ + front_, up_);
+        // the view is a rigid transform, its inverse is just the camera basis and position
+        inverse_view_ = glm::mat4(glm::vec4(right_, 0.0f), glm::vec4(up_, 0.0f),
+                                  glm::vec4(-front_, 0.0f), glm::vec4(position_, 1.0f));
+    }
+    if (projection_dirty_) {
+        projection_ = glm::perspective(glm::radians(zoom_), aspect_, near_, far_);
+        inverse_projection_ = glm::inverse(projection_);
+    }
+    view_projection_ = projection_ * view_;
+    inverse_view_projection_ = inverse_view_ * inverse_projection_;
+    view_dirty_ = projection_dirty_ = false;
 }
 
 }
\ No newline at end of file
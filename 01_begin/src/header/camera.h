@@ -12,6 +12,9 @@
 #ifndef _OPENGL_CAMERA_H_
 #define _OPENGL_CAMERA_H_
 
+#include "frustum.h"
+
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace opengl {
@@ -31,7 +34,23 @@ class Camera {
     // Camera options
     float move_speed_;
     float mouse_sensitivity_;
-    float zoom_;
+    float zoom_;    // vertical field of view in degrees
+
+    // Projection
+    float aspect_   = ASPECT;
+    float near_     = NEAR_PLANE;
+    float far_      = FAR_PLANE;
+
+    // Matrices, rebuilt on first use after the view or projection changed
+    bool        view_dirty_         = true;
+    bool        projection_dirty_   = true;
+    uint64_t    generation_         = 0;
+    glm::mat4   view_;
+    glm::mat4   inverse_view_;
+    glm::mat4   projection_;
+    glm::mat4   inverse_projection_;
+    glm::mat4   view_projection_;
+    glm::mat4   inverse_view_projection_;
 
 public:
     enum MoveDirection {
@@ -47,10 +66,34 @@ public:
     constexpr static float SPEED       =  2.5f;
     constexpr static float SENSITIVITY =  0.1f;
     constexpr static float ZOOM        =  45.0f;
+    constexpr static float ASPECT      =  800.0f / 600.0f;
+    constexpr static float NEAR_PLANE  =  0.1f;
+    constexpr static float FAR_PLANE   =  100.0f;
 
     Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), float yaw = YAW, float pitch = PITCH);
 
-    glm::mat4 viewMatrix();
+    inline const glm::vec3& position() const { return position_; }
+    inline const glm::vec3& front() const { return front_; }
+    inline float zoom() const { return zoom_; }
+
+    // Bumped whenever any of the matrices below changes, so per-frame uploads can be skipped
+    // while it stays the same.
+    inline uint64_t generation() const { return generation_; }
+
+    // Set the aspect ratio from the framebuffer size, e.g. in the resize callback.
+    void setViewport(int width, int height);
+    void setClipPlanes(float near_plane, float far_plane);
+
+    const glm::mat4& viewMatrix();
+    const glm::mat4& inverseViewMatrix();
+    const glm::mat4& projectionMatrix();
+    const glm::mat4& inverseProjectionMatrix();
+    const glm::mat4& viewProjectionMatrix();
+    const glm::mat4& inverseViewProjectionMatrix();
+
+    // The planes of what this camera sees through its own projection, or the given one, for culling.
+    Frustum frustum();
+    Frustum frustum(const glm::mat4 &projection);
 
     // processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems).
     void processKeyboard(MoveDirection direction, float delta_time);
@@ -64,6 +107,9 @@ public:
 private:
     void update();
 
+    // Rebuild whichever matrices are out of date.
+    void refresh();
+
 };
 
 }
@@ -0,0 +1,303 @@
+#include "context.h"
+#include "cpu_trace.h"
+#include "gl_instrument.h"
+#include "gpu_profiler.h"
+#include "render_state.h"
+#include "vertex_array_cache.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#ifdef OPENGL_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace opengl {
+
+ContextOptions
+Context::parseOptions(int argc, char **argv) {
+    ContextOptions options;
+    const char *headless = getenv("OPENGL_HEADLESS");
+    if (headless && *headless && strcmp(headless, "0") != 0)
+        options.headless = true;
+    const char *frames = getenv("OPENGL_FRAMES");
+    if (frames && atoi(frames) > 0)
+        options.frames = atoi(frames);
+    const char *gpu_profile = getenv("OPENGL_GPU_PROFILE");
+    if (gpu_profile && *gpu_profile && strcmp(gpu_profile, "0") != 0)
+        options.gpu_profile = true;
+    const char *trace_file = getenv("OPENGL_TRACE_FILE");
+    if (trace_file && *trace_file)
+        options.trace_file = trace_file;
+    const char *frame_stats = getenv("OPENGL_FRAME_STATS");
+    if (frame_stats && *frame_stats)
+        options.frame_stats = frame_stats;
+    const char *frame_stats_interval = getenv("OPENGL_FRAME_STATS_INTERVAL");
+    if (frame_stats_interval && atof(frame_stats_interval) > 0.0)
+        options.frame_stats_interval = atof(frame_stats_interval);
+    const char *gl_calls = getenv("OPENGL_GL_CALLS");
+    if (gl_calls && *gl_calls && strcmp(gl_calls, "0") != 0)
+        options.gl_calls = true;
+    const char *gl_check_errors = getenv("OPENGL_GL_CHECK_ERRORS");
+    if (gl_check_errors && *gl_check_errors && strcmp(gl_check_errors, "0") != 0)
+        options.gl_check_errors = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            options.headless = true;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            int count = atoi(argv[++i]);
+            if (count > 0)
+                options.frames = count;
+        } else if (strcmp(argv[i], "--gpu-profile") == 0) {
+            options.gpu_profile = true;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options.trace_file = argv[++i];
+        } else if (strcmp(argv[i], "--frame-stats") == 0 && i + 1 < argc) {
+            options.frame_stats = argv[++i];
+        } else if (strcmp(argv[i], "--frame-stats-interval") == 0 && i + 1 < argc) {
+            double interval = atof(argv[++i]);
+            if (interval > 0.0)
+                options.frame_stats_interval = interval;
+        } else if (strcmp(argv[i], "--gl-calls") == 0) {
+            options.gl_calls = true;
+        } else if (strcmp(argv[i], "--gl-check-errors") == 0) {
+            options.gl_check_errors = true;
+        }
+    }
+    return options;
+}
+
+Context*
+Context::create(const ContextOptions &options) {
+    Context *context = new Context(options);
+    bool created = options.headless ? context->createHeadless() : context->createWindow();
+    if (!created) {
+        delete context;
+        return nullptr;
+    }
+    GpuProfiler::current().setEnabled(options.gpu_profile);
+    if (options.frame_stats)
+        context->frame_stats_.setOutput(options.frame_stats, options.frame_stats_interval);
+    if (options.gl_calls || options.gl_check_errors)
+        GLInstrument::current().install(options.gl_check_errors);
+    if (options.trace_file) {
+#ifdef OPENGL_TRACE
+        CpuTrace::current().setEnabled(true);
+        OPENGL_TRACE_THREAD("render");
+#else
+        fprintf(stdout, "[Error] Built without OPENGL_TRACE, no CPU trace\n");
+#endif
+    }
+    return context;
+}
+
+bool
+Context::createWindow() {
+    // Initialize the glfw3 library.
+    if (!glfwInit())
+        return false;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    window_ = glfwCreateWindow(options_.width, options_.height, options_.title, NULL, NULL);
+    if (!window_) {
+        fprintf(stdout, "[Error] Failed to create GLFW window\n");
+        glfwTerminate();
+        return false;
+    }
+    glfwMakeContextCurrent(window_);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        fprintf(stdout, "[Error] Failed to initialize GLAD\n");
+        return false;
+    }
+    RenderState::current().invalidate();
+    VertexArrayCache::current().forget();
+    GpuProfiler::current().forget();
+    GLInstrument::current().forget();
+    return true;
+}
+
+bool
+Context::createHeadless() {
+#ifdef OPENGL_HEADLESS_EGL
+    // Prefer Mesa's surfaceless platform, it needs neither a display server nor a GPU.
+    EGLDisplay display = EGL_NO_DISPLAY;
+    auto get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (get_platform_display)
+        display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        fprintf(stdout, "[Error] Failed to initialize EGL\n");
+        return false;
+    }
+    egl_display_ = display;
+
+    const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE,       EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE,    EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint    num_configs = 0;
+    if (!eglChooseConfig(display, config_attribs, &config, 1, &num_configs) || num_configs == 0) {
+        fprintf(stdout, "[Error] No EGL config for desktop OpenGL\n");
+        return false;
+    }
+
+    eglBindAPI(EGL_OPENGL_API);
+    // Same 3.3 core context the windows ask GLFW for.
+    const EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION,          3,
+        EGL_CONTEXT_MINOR_VERSION,          3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK,    EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+    if (context == EGL_NO_CONTEXT) {
+        fprintf(stdout, "[Error] Failed to create an EGL context\n");
+        return false;
+    }
+    egl_context_ = context;
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        fprintf(stdout, "[Error] Failed to make the surfaceless EGL context current\n");
+        return false;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        fprintf(stdout, "[Error] Failed to initialize GLAD\n");
+        return false;
+    }
+    fprintf(stdout, "[Info] Headless GL context: %s, %s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+
+    // There is no default framebuffer without a surface, the samples draw into this one instead.
+    glGenRenderbuffers(1, &color_buffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, color_buffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, options_.width, options_.height);
+    glGenRenderbuffers(1, &depth_buffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, options_.width, options_.height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_buffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_buffer_);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stdout, "[Error] Offscreen framebuffer is incomplete\n");
+        return false;
+    }
+    RenderState::current().invalidate();
+    VertexArrayCache::current().forget();
+    GpuProfiler::current().forget();
+    GLInstrument::current().forget();
+    RenderState::current().setViewport(0, 0, options_.width, options_.height);
+    return true;
+#else
+    fprintf(stdout, "[Error] Built without EGL, no headless context\n");
+    return false;
+#endif
+}
+
+Context::~Context() {
+    // the last interval and the file of the statistics, once the loop is over
+    frame_stats_.finish();
+    // the queries go with the context
+    if (window_ || egl_context_)
+        GpuProfiler::current().clear();
+    if (window_) {
+        glfwTerminate();
+        return;
+    }
+#ifdef OPENGL_HEADLESS_EGL
+    if (egl_context_) {
+        if (framebuffer_) {
+            glDeleteFramebuffers(1, &framebuffer_);
+            glDeleteRenderbuffers(1, &color_buffer_);
+            glDeleteRenderbuffers(1, &depth_buffer_);
+        }
+        eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(egl_display_, egl_context_);
+    }
+    if (egl_display_)
+        eglTerminate(egl_display_);
+#endif
+}
+
+bool
+Context::shouldClose() {
+    // the first check is the top of the render loop, setup is not part of the frame time
+    if (frame_ == 0) {
+        start_ = std::chrono::steady_clock::now();
+        frame_stats_.begin();
+    }
+    if (window_)
+        return glfwWindowShouldClose(window_);
+    return frame_ >= options_.frames;
+}
+
+double
+Context::time() const {
+    if (window_)
+        return glfwGetTime();
+    return frame_ / 60.0;
+}
+
+void
+Context::endFrame() {
+    frame_++;
+    RenderState::current().endFrame();
+    GpuProfiler &profiler = GpuProfiler::current();
+    profiler.begin("swap");
+    if (window_) {
+        // Check and call the event, swapping the buffer.
+        {
+            OPENGL_TRACE_ZONE("glfwPollEvents");
+            glfwPollEvents();
+        }
+        OPENGL_TRACE_ZONE("glfwSwapBuffers");
+        glfwSwapBuffers(window_);
+    } else {
+        // what a swap would do, hand the frame to the driver
+        OPENGL_TRACE_ZONE("glFlush");
+        glFlush();
+    }
+    profiler.end();
+    profiler.endFrame();
+    GLInstrument::current().endFrame();
+    OPENGL_TRACE_FRAME();
+    frame_stats_.endFrame();
+}
+
+void
+Context::report() const {
+    if (frame_ == 0)
+        return;
+    // wait for the last frame, otherwise the time only covers submitting it
+    glFinish();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    fprintf(stdout, "[Info] Rendered %d %s frames in %.1f ms, %.3f ms per frame\n",
+            frame_, headless() ? "headless" : "windowed", elapsed_ms, elapsed_ms / frame_);
+    frame_stats_.report();
+    RenderState::current().report();
+    GpuProfiler::current().report();
+    GLInstrument::current().report();
+#ifdef OPENGL_TRACE
+    if (options_.trace_file) {
+        CpuTrace::current().report();
+        if (CpuTrace::current().write(options_.trace_file))
+            fprintf(stdout, "[Info] CPU trace written to %s\n", options_.trace_file);
+    }
+#endif
+}
+
+}
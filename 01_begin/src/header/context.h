@@ -0,0 +1,107 @@
+/**
+ * @file context.h
+ * @author l1ang70
+ * @brief The GL context of a sample: a GLFW window, or a headless EGL context
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_CONTEXT_H_
+#define _OPENGL_CONTEXT_H_
+
+#include "frame_stats.h"
+
+#include <chrono>
+
+struct GLFWwindow;
+
+namespace opengl {
+
+struct ContextOptions {
+    int         width                   = 800;
+    int         height                  = 600;
+    const char *title                   = "LearnOpenGL";
+    bool        headless                = false;
+    int         frames                  = 100;      // frames rendered before a headless context closes
+    bool        gpu_profile             = false;    // time the GpuProfiler scopes, report() prints them
+    const char *trace_file              = nullptr;  // record the CPU trace zones, report() writes them here
+    const char *frame_stats             = nullptr;  // write the frame time statistics here, JSON or .csv
+    double      frame_stats_interval    = 0.0;      // and every that many seconds when above 0
+    bool        gl_calls                = false;    // count and time every GL call, report() prints them
+    bool        gl_check_errors         = false;    // and check glGetError() after each
+};
+
+// Creates a 3.3 core context and loads glad. Windowed it is a GLFW window as before.
+// Headless it is an EGL surfaceless context (Mesa llvmpipe is enough, no display or GPU)
+// rendering into an offscreen framebuffer, which closes after a fixed number of frames.
+class Context {
+    ContextOptions  options_;
+    GLFWwindow      *window_        = nullptr;
+    void            *egl_display_   = nullptr;
+    void            *egl_context_   = nullptr;
+
+    // Offscreen target of the headless context, bound as the draw framebuffer.
+    unsigned int    framebuffer_    = 0;
+    unsigned int    color_buffer_   = 0;
+    unsigned int    depth_buffer_   = 0;
+
+    int             frame_          = 0;
+    std::chrono::steady_clock::time_point start_;
+    FrameStats      frame_stats_;
+
+private:
+    explicit Context(const ContextOptions &options) : options_(options) {}
+
+    bool createWindow();
+    bool createHeadless();
+
+public:
+    ~Context();
+
+    // Start from the defaults and apply the command line and environment:
+    //   --headless          or OPENGL_HEADLESS=1    use the headless context
+    //   --frames N          or OPENGL_FRAMES=N      number of headless frames
+    //   --gpu-profile       or OPENGL_GPU_PROFILE=1 time the GPU scopes of the frame
+    //   --trace FILE        or OPENGL_TRACE_FILE=FILE
+    //                                               write the CPU trace to FILE (opengl_trace builds)
+    //   --frame-stats FILE  or OPENGL_FRAME_STATS=FILE
+    //                                               write the frame time statistics to FILE on exit
+    //   --frame-stats-interval S or OPENGL_FRAME_STATS_INTERVAL=S
+    //                                               and every S seconds
+    //   --gl-calls          or OPENGL_GL_CALLS=1    count and time the GL calls (opengl_gl_instrument builds)
+    //   --gl-check-errors   or OPENGL_GL_CHECK_ERRORS=1
+    //                                               and log the errors of every GL call
+    // Other arguments are left for the sample.
+    static ContextOptions parseOptions(int argc, char **argv);
+
+    // Returns nullptr if the context can not be created.
+    static Context* create(const ContextOptions &options);
+
+    inline bool headless() const { return options_.headless; }
+    inline GLFWwindow* window() const { return window_; }   // nullptr when headless
+    inline int frame() const { return frame_; }
+    inline const FrameStats& frameStats() const { return frame_stats_; }
+
+    // The render loop condition, also starts the clock of report() on its first call.
+    bool shouldClose();
+
+    // Seconds since creation. Headless it advances 1/60 s per frame, so every run animates the same.
+    double time() const;
+
+    // Windowed: poll events and swap. Headless: count the frame. The swap is the "swap" GPU
+    // scope, then the GpuProfiler moves on to the next frame, the CPU trace marks the frame
+    // and the frame statistics take its time.
+    void endFrame();
+
+    // Print the frames rendered, the average frame time and its percentiles to stdout, the GPU
+    // profile and the hottest GL entry points.
+    // Writes the CPU trace when there is one.
+    void report() const;
+};
+
+}
+
+#endif // !_OPENGL_CONTEXT_H_
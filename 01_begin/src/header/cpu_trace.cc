@@ -0,0 +1,189 @@
+#include "cpu_trace.h"
+
+#include <cstdio>
+
+namespace opengl {
+
+namespace {
+
+// A zone or thread name as a JSON string, the names are literals but may still hold a quote.
+void
+writeString(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const char *c = text; *c; c++) {
+        if (*c == '"' || *c == '\\')
+            fputc('\\', file);
+        if ((unsigned char)*c >= 0x20)
+            fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+}
+
+CpuTrace&
+CpuTrace::current() {
+    static CpuTrace s_trace;
+    return s_trace;
+}
+
+CpuTrace::~CpuTrace() {
+    for (auto &thread : threads_) {
+        Block *block = thread->head;
+        while (block) {
+            Block *next = block->next.load(std::memory_order_relaxed);
+            delete block;
+            block = next;
+        }
+    }
+}
+
+CpuTrace::ThreadBuffer&
+CpuTrace::threadBuffer() {
+    // there is only the one trace, so one buffer a thread
+    static thread_local ThreadBuffer *t_buffer = nullptr;
+    if (t_buffer)
+        return *t_buffer;
+    ThreadBuffer *buffer = new ThreadBuffer();
+    buffer->head = buffer->tail = new Block;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->id = (uint32_t)threads_.size() + 1;
+        buffer->name = "thread " + std::to_string(buffer->id);
+        threads_.emplace_back(buffer);
+    }
+    t_buffer = buffer;
+    return *buffer;
+}
+
+void
+CpuTrace::push(const Event &event) {
+    ThreadBuffer &buffer = threadBuffer();
+    Block *block = buffer.tail;
+    size_t count = block->count.load(std::memory_order_relaxed);
+    if (count == BLOCK_EVENTS) {
+        if (buffer.blocks == MAX_BLOCKS) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // the reader sees the new block only once linked, and each event only once counted
+        Block *next = new Block;
+        block->next.store(next, std::memory_order_release);
+        buffer.tail = block = next;
+        buffer.blocks++;
+        count = 0;
+    }
+    block->events[count] = event;
+    block->count.store(count + 1, std::memory_order_release);
+}
+
+void
+CpuTrace::frame() {
+    if (!enabled())
+        return;
+    uint64_t time = now();
+    push({ "frame", time, time, frame_.fetch_add(1, std::memory_order_relaxed) + 1 });
+}
+
+void
+CpuTrace::setThreadName(const char *name) {
+    ThreadBuffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer.name = name;
+}
+
+size_t
+CpuTrace::eventCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (auto &thread : threads_) {
+        for (Block *block = thread->head; block; block = block->next.load(std::memory_order_acquire))
+            count += block->count.load(std::memory_order_acquire);
+    }
+    return count;
+}
+
+uint64_t
+CpuTrace::droppedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t count = 0;
+    for (auto &thread : threads_)
+        count += thread->dropped.load(std::memory_order_relaxed);
+    return count;
+}
+
+bool
+CpuTrace::write(const std::string &path) const {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        fprintf(stdout, "[Error] Failed to open %s for the CPU trace\n", path.c_str());
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    // timestamps in microseconds from the creation of the trace, the unit Chrome expects
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    const char *separator = "";
+    for (auto &thread : threads_) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                separator, thread->id);
+        writeString(file, thread->name.c_str());
+        fprintf(file, "}}");
+        separator = ",\n";
+        for (Block *block = thread->head; block; block = block->next.load(std::memory_order_acquire)) {
+            size_t count = block->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; i++) {
+                const Event &event = block->events[i];
+                double begin_us = (double)(int64_t)(event.begin_ns - epoch_ns_) * 1e-3;
+                fprintf(file, "%s{\"name\":", separator);
+                writeString(file, event.name);
+                if (event.frame) {
+                    fprintf(file, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%llu}}",
+                            begin_us, thread->id, (unsigned long long)event.frame);
+                } else {
+                    fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}", begin_us,
+                            (event.end_ns - event.begin_ns) * 1e-3, thread->id);
+                }
+            }
+        }
+    }
+    fprintf(file, "\n]}\n");
+    bool written = !ferror(file);
+    if (fclose(file) != 0 || !written) {
+        fprintf(stdout, "[Error] Failed to write the CPU trace to %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void
+CpuTrace::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &thread : threads_) {
+        Block *block = thread->head->next.exchange(nullptr, std::memory_order_relaxed);
+        while (block) {
+            Block *next = block->next.load(std::memory_order_relaxed);
+            delete block;
+            block = next;
+        }
+        thread->head->count.store(0, std::memory_order_relaxed);
+        thread->tail = thread->head;
+        thread->blocks = 1;
+        thread->dropped.store(0, std::memory_order_relaxed);
+    }
+    frame_.store(0, std::memory_order_relaxed);
+}
+
+void
+CpuTrace::report() const {
+    size_t events = eventCount();
+    uint64_t dropped = droppedCount();
+    size_t threads;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        threads = threads_.size();
+    }
+    fprintf(stdout, "[Info] CPU trace: %zu events on %zu threads over %llu frames, %llu dropped\n", events, threads,
+            (unsigned long long)frame_.load(std::memory_order_relaxed), (unsigned long long)dropped);
+}
+
+}
@@ -0,0 +1,153 @@
+/**
+ * @file cpu_trace.h
+ * @author l1ang70
+ * @brief CPU trace zones in per-thread buffers and frame markers, written out as a Chrome trace
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_CPU_TRACE_H_
+#define _OPENGL_CPU_TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace opengl {
+
+// Where the CPU time of a frame goes, on every thread. A zone is a name with the steady clock
+// at both ends, recorded when it closes into a buffer of the thread that ran it: blocks of
+// BLOCK_EVENTS events in a list only that thread appends to, each block publishing its count
+// with a release store, so recording takes no lock and write() can read while threads record.
+// A thread keeps at most MAX_BLOCKS blocks, past that its zones are counted as dropped.
+//
+// write() gives the Chrome trace event JSON that chrome://tracing and ui.perfetto.dev open:
+// a complete event per zone on the track of its thread, zones inside zones nested by time,
+// and an instant event for every frame marker.
+//
+// The OPENGL_TRACE_* macros are the way in. Without OPENGL_TRACE defined (the opengl_trace
+// CMake option) they expand to nothing, so the zones stay in the samples at no cost. With it
+// they record once enabled, the Context enables it for --trace FILE and writes FILE in report().
+class CpuTrace {
+public:
+    struct Event {
+        const char      *name;      // a string literal, only the pointer is kept
+        uint64_t        begin_ns;
+        uint64_t        end_ns;
+        uint64_t        frame;      // 0 for a zone, the frame number for a frame marker
+    };
+
+    constexpr static size_t BLOCK_EVENTS    = 1024;
+    constexpr static size_t MAX_BLOCKS      = 1024;     // 32 MB of events a thread
+
+private:
+    struct Block {
+        Event                   events[BLOCK_EVENTS];
+        std::atomic<size_t>     count       { 0 };
+        std::atomic<Block*>     next        { nullptr };
+    };
+
+    struct ThreadBuffer {
+        uint32_t                id;
+        std::string             name;                   // under the mutex of the trace
+        Block                   *head;
+        Block                   *tail;                  // the owner thread only
+        size_t                  blocks      = 1;        // the owner thread only
+        std::atomic<uint64_t>   dropped     { 0 };
+    };
+
+    std::atomic<bool>                           enabled_    { false };
+    std::atomic<uint64_t>                       frame_      { 0 };
+    uint64_t                                    epoch_ns_;
+    mutable std::mutex                          mutex_;     // guards threads_ and the names
+    std::vector<std::unique_ptr<ThreadBuffer>>  threads_;
+
+private:
+    CpuTrace() : epoch_ns_(now()) {}
+
+    // The buffer of the calling thread, registered on its first event.
+    ThreadBuffer& threadBuffer();
+
+    void push(const Event &event);
+
+public:
+    static CpuTrace& current();
+
+    CpuTrace(const CpuTrace&) = delete;
+    CpuTrace& operator=(const CpuTrace&) = delete;
+    ~CpuTrace();
+
+    static inline uint64_t now() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    inline void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    inline bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Record the zone name from begin_ns to end_ns on the calling thread.
+    inline void zone(const char *name, uint64_t begin_ns, uint64_t end_ns) { push({ name, begin_ns, end_ns, 0 }); }
+
+    // Mark the end of a frame on the calling thread.
+    void frame();
+
+    // Name the track of the calling thread.
+    void setThreadName(const char *name);
+
+    // Events recorded and dropped over every thread.
+    size_t eventCount() const;
+    uint64_t droppedCount() const;
+
+    // Write the events as Chrome trace JSON to path. Returns false when the file can not be written.
+    bool write(const std::string &path) const;
+
+    // Forget every event, while no other thread records. The threads and their names stay.
+    void clear();
+
+    // Print the events, threads and frames recorded to stdout.
+    void report() const;
+};
+
+// Zone of the current CpuTrace for the lifetime of the object, nothing when it is not enabled.
+class TraceZone {
+    const char  *name_;
+    uint64_t    begin_ns_;
+
+public:
+    explicit TraceZone(const char *name)
+        : name_(CpuTrace::current().enabled() ? name : nullptr), begin_ns_(name_ ? CpuTrace::now() : 0) {}
+    ~TraceZone() {
+        if (name_)
+            CpuTrace::current().zone(name_, begin_ns_, CpuTrace::now());
+    }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+};
+
+}
+
+#ifdef OPENGL_TRACE
+#define OPENGL_TRACE_JOIN_(a, b)    a##b
+#define OPENGL_TRACE_JOIN(a, b)     OPENGL_TRACE_JOIN_(a, b)
+// Time the rest of the enclosing block as the zone name, a string literal.
+#define OPENGL_TRACE_ZONE(name)     ::opengl::TraceZone OPENGL_TRACE_JOIN(trace_zone_, __LINE__)(name)
+// Mark the end of a frame.
+#define OPENGL_TRACE_FRAME()        ::opengl::CpuTrace::current().frame()
+// Name the track of the calling thread.
+#define OPENGL_TRACE_THREAD(name)   ::opengl::CpuTrace::current().setThreadName(name)
+#else
+#define OPENGL_TRACE_ZONE(name)     ((void)0)
+#define OPENGL_TRACE_FRAME()        ((void)0)
+#define OPENGL_TRACE_THREAD(name)   ((void)0)
+#endif
+
+#endif // !_OPENGL_CPU_TRACE_H_
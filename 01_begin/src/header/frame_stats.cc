@@ -0,0 +1,240 @@
+#include "frame_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace opengl {
+
+namespace {
+
+// Weight of a frame in the moving average stutters are measured against, about the last 16.
+constexpr double AVERAGE_WEIGHT = 1.0 / 16.0;
+
+}
+
+FrameTimeHistogram::FrameTimeHistogram() : counts_(bucketOf(MAX_NS) + 1, 0) {}
+
+size_t
+FrameTimeHistogram::bucketOf(uint64_t ns) {
+    ns = std::min(ns, MAX_NS);
+    int msb = ns ? 63 - __builtin_clzll(ns) : 0;
+    // the top SUB_BITS + 1 bits of the duration, below 2^(SUB_BITS + 1) ns that is all of it
+    int shift = std::max(msb - SUB_BITS, 0);
+    return ((size_t)shift << SUB_BITS) + (size_t)(ns >> shift);
+}
+
+uint64_t
+FrameTimeHistogram::bucketFloor(size_t bucket) {
+    int shift = std::max((int)(bucket >> SUB_BITS) - 1, 0);
+    return (uint64_t)(bucket - ((size_t)shift << SUB_BITS)) << shift;
+}
+
+uint64_t
+FrameTimeHistogram::bucketWidth(size_t bucket) {
+    int shift = std::max((int)(bucket >> SUB_BITS) - 1, 0);
+    return 1ull << shift;
+}
+
+void
+FrameTimeHistogram::record(uint64_t ns) {
+    counts_[bucketOf(ns)]++;
+    min_ns_ = count_ == 0 ? ns : std::min(min_ns_, ns);
+    max_ns_ = std::max(max_ns_, ns);
+    sum_ns_ += (double)ns;
+    count_++;
+}
+
+void
+FrameTimeHistogram::clear() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    min_ns_ = 0;
+    max_ns_ = 0;
+    sum_ns_ = 0.0;
+}
+
+uint64_t
+FrameTimeHistogram::valueAt(double percentile) const {
+    if (count_ == 0)
+        return 0;
+    uint64_t rank = std::max<uint64_t>((uint64_t)std::ceil(percentile * count_), 1);
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts_.size(); bucket++) {
+        seen += counts_[bucket];
+        if (seen >= rank) {
+            // the middle of the bucket, but never out of what was recorded
+            uint64_t value = bucketFloor(bucket) + bucketWidth(bucket) / 2;
+            return std::min(std::max(value, min_ns_), max_ns_);
+        }
+    }
+    return max_ns_;
+}
+
+void
+FrameStats::setOutput(const std::string &path, double interval_s) {
+    path_ = path;
+    interval_s_ = interval_s;
+}
+
+void
+FrameStats::begin() {
+    if (running_)
+        return;
+    begin_ = last_ = interval_begin_ = Clock::now();
+    running_ = true;
+}
+
+void
+FrameStats::endFrame() {
+    if (!running_)
+        return begin();
+    Clock::time_point now = Clock::now();
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_).count();
+    last_ = now;
+
+    if (total_.count() >= STUTTER_WARMUP && ns > STUTTER_FACTOR * average_ns_) {
+        stutters_++;
+        interval_stutters_++;
+    }
+    if (ns > budget_ms_ * 1e6) {
+        over_budget_++;
+        interval_over_budget_++;
+    }
+    average_ns_ = total_.count() == 0 ? (double)ns : average_ns_ + AVERAGE_WEIGHT * ((double)ns - average_ns_);
+    total_.record(ns);
+    interval_.record(ns);
+
+    if (interval_s_ > 0.0 && std::chrono::duration<double>(now - interval_begin_).count() >= interval_s_) {
+        closeInterval(now);
+        if (!path_.empty())
+            write(path_);
+    }
+}
+
+void
+FrameStats::finish() {
+    if (!running_)
+        return;
+    if (interval_s_ > 0.0 && interval_.count() > 0)
+        closeInterval(last_);
+    if (!path_.empty() && write(path_))
+        fprintf(stdout, "[Info] Frame statistics written to %s\n", path_.c_str());
+}
+
+void
+FrameStats::closeInterval(Clock::time_point now) {
+    intervals_.push_back(summarize(interval_, std::chrono::duration<double>(interval_begin_ - begin_).count(),
+                                   std::chrono::duration<double>(now - interval_begin_).count(), interval_stutters_,
+                                   interval_over_budget_));
+    interval_.clear();
+    interval_stutters_ = 0;
+    interval_over_budget_ = 0;
+    interval_begin_ = now;
+}
+
+FrameTimeSummary
+FrameStats::summarize(const FrameTimeHistogram &histogram, double start_s, double seconds, uint64_t stutters,
+                      uint64_t over_budget) const {
+    FrameTimeSummary summary;
+    summary.start_s = start_s;
+    summary.seconds = seconds;
+    summary.frames = histogram.count();
+    summary.min_ms = histogram.minNs() * 1e-6;
+    summary.mean_ms = histogram.meanNs() * 1e-6;
+    summary.p50_ms = histogram.valueAt(0.50) * 1e-6;
+    summary.p95_ms = histogram.valueAt(0.95) * 1e-6;
+    summary.p99_ms = histogram.valueAt(0.99) * 1e-6;
+    summary.max_ms = histogram.maxNs() * 1e-6;
+    summary.stutters = stutters;
+    summary.over_budget = over_budget;
+    return summary;
+}
+
+FrameTimeSummary
+FrameStats::summary() const {
+    return summarize(total_, 0.0, std::chrono::duration<double>(last_ - begin_).count(), stutters_, over_budget_);
+}
+
+bool
+FrameStats::write(const std::string &path) const {
+    bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    if (!(csv ? writeCsv(path) : writeJson(path))) {
+        fprintf(stdout, "[Error] Failed to write the frame statistics to %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+void
+writeSummaryJson(FILE *file, const FrameTimeSummary &s) {
+    fprintf(file, "{\"start_s\": %.6f, \"seconds\": %.6f, \"frames\": %llu, \"min_ms\": %.4f, \"mean_ms\": %.4f, "
+                  "\"p50_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f, \"stutters\": %llu, "
+                  "\"over_budget\": %llu}",
+            s.start_s, s.seconds, (unsigned long long)s.frames, s.min_ms, s.mean_ms, s.p50_ms, s.p95_ms, s.p99_ms,
+            s.max_ms, (unsigned long long)s.stutters, (unsigned long long)s.over_budget);
+}
+
+}
+
+bool
+FrameStats::writeJson(const std::string &path) const {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    fprintf(file, "{\n  \"budget_ms\": %.4f,\n  \"stutter_factor\": %.1f,\n  \"total\": ", budget_ms_, STUTTER_FACTOR);
+    writeSummaryJson(file, summary());
+    fprintf(file, ",\n  \"intervals\": [");
+    for (size_t i = 0; i < intervals_.size(); i++) {
+        fprintf(file, "%s\n    ", i ? "," : "");
+        writeSummaryJson(file, intervals_[i]);
+    }
+    fprintf(file, "%s],\n", intervals_.empty() ? "" : "\n  ");
+    // the buckets that hold frames, as [floor ms, width ms, frames], enough to merge runs or plot them
+    fprintf(file, "  \"histogram\": [");
+    const char *separator = "";
+    const std::vector<uint64_t> &counts = total_.counts();
+    for (size_t bucket = 0; bucket < counts.size(); bucket++) {
+        if (!counts[bucket])
+            continue;
+        fprintf(file, "%s[%.6f, %.6f, %llu]", separator, FrameTimeHistogram::bucketFloor(bucket) * 1e-6,
+                FrameTimeHistogram::bucketWidth(bucket) * 1e-6, (unsigned long long)counts[bucket]);
+        separator = ", ";
+    }
+    fprintf(file, "]\n}\n");
+    bool written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
+
+bool
+FrameStats::writeCsv(const std::string &path) const {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    fprintf(file, "span,start_s,seconds,frames,min_ms,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,stutters,over_budget\n");
+    auto row = [file](const char *span, const FrameTimeSummary &s) {
+        fprintf(file, "%s,%.6f,%.6f,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%llu,%llu\n", span, s.start_s, s.seconds,
+                (unsigned long long)s.frames, s.min_ms, s.mean_ms, s.p50_ms, s.p95_ms, s.p99_ms, s.max_ms,
+                (unsigned long long)s.stutters, (unsigned long long)s.over_budget);
+    };
+    for (size_t i = 0; i < intervals_.size(); i++)
+        row(std::to_string(i + 1).c_str(), intervals_[i]);
+    row("total", summary());
+    bool written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
+
+void
+FrameStats::report() const {
+    if (total_.count() == 0)
+        return;
+    FrameTimeSummary s = summary();
+    fprintf(stdout, "[Info] Frame times: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms, %llu stutters, "
+                    "%llu of %llu frames over %.2f ms\n",
+            s.p50_ms, s.p95_ms, s.p99_ms, s.max_ms, (unsigned long long)s.stutters, (unsigned long long)s.over_budget,
+            (unsigned long long)s.frames, budget_ms_);
+}
+
+}
@@ -0,0 +1,145 @@
+/**
+ * @file frame_stats.h
+ * @author l1ang70
+ * @brief Frame times on the steady clock in a log-linear histogram, percentiles and stutters, JSON or CSV summaries
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_FRAME_STATS_H_
+#define _OPENGL_FRAME_STATS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace opengl {
+
+// Counts of durations in nanoseconds, HdrHistogram style: below 2^SUB_BITS ns a bucket a
+// nanosecond, above it every power of two split into 2^SUB_BITS buckets, so a bucket is never
+// wider than 1/128 of what it holds whatever the scale. Up to MAX_NS, longer is counted there.
+class FrameTimeHistogram {
+    std::vector<uint64_t>   counts_;
+    uint64_t                count_      = 0;
+    uint64_t                min_ns_     = 0;
+    uint64_t                max_ns_     = 0;
+    double                  sum_ns_     = 0.0;
+
+public:
+    constexpr static int        SUB_BITS    = 7;
+    constexpr static uint64_t   MAX_NS      = (1ull << 40) - 1;     // 18 minutes
+
+    FrameTimeHistogram();
+
+    static size_t bucketOf(uint64_t ns);
+    // The smallest duration in the bucket and the number of nanoseconds it spans.
+    static uint64_t bucketFloor(size_t bucket);
+    static uint64_t bucketWidth(size_t bucket);
+
+    void record(uint64_t ns);
+    void clear();
+
+    // The duration percentile (0 to 1) of the counts are at or under, to within its bucket.
+    uint64_t valueAt(double percentile) const;
+
+    inline uint64_t count() const { return count_; }
+    inline uint64_t minNs() const { return min_ns_; }
+    inline uint64_t maxNs() const { return max_ns_; }
+    inline double meanNs() const { return count_ ? sum_ns_ / count_ : 0.0; }
+    inline const std::vector<uint64_t>& counts() const { return counts_; }
+};
+
+// The frames of a span of the run, times in milliseconds.
+struct FrameTimeSummary {
+    double      start_s;        // since the first frame began
+    double      seconds;
+    uint64_t    frames;
+    double      min_ms;
+    double      mean_ms;
+    double      p50_ms;
+    double      p95_ms;
+    double      p99_ms;
+    double      max_ms;
+    uint64_t    stutters;
+    uint64_t    over_budget;
+};
+
+// Frame to frame times of the render loop on std::chrono::steady_clock, which is monotonic
+// and counts nanoseconds, where glfwGetTime() into a float loses the milliseconds after a few
+// hours. begin() starts the clock, every endFrame() closes a frame.
+//
+// A stutter is a frame over STUTTER_FACTOR times the moving average of those before it,
+// counted once there are STUTTER_WARMUP frames to average; a frame over budget is longer than
+// the budget, 1/60 s by default. Both count against the run and the current interval.
+//
+// With an output path summaries go out as JSON, or as CSV when the path ends in .csv: the
+// whole run, and with an interval one summary each time that many seconds have passed. The
+// file is written again at every interval and by finish(), so it is whole whenever the run
+// stops. Runs of two builds under the same load compare line by line.
+class FrameStats {
+    using Clock = std::chrono::steady_clock;
+
+    double                          budget_ms_;
+    std::string                     path_;
+    double                          interval_s_             = 0.0;
+    Clock::time_point               begin_;
+    Clock::time_point               last_;
+    Clock::time_point               interval_begin_;
+    bool                            running_                = false;
+    double                          average_ns_             = 0.0;
+    FrameTimeHistogram              total_;
+    FrameTimeHistogram              interval_;
+    uint64_t                        stutters_               = 0;
+    uint64_t                        over_budget_            = 0;
+    uint64_t                        interval_stutters_      = 0;
+    uint64_t                        interval_over_budget_   = 0;
+    std::vector<FrameTimeSummary>   intervals_;
+
+private:
+    FrameTimeSummary summarize(const FrameTimeHistogram &histogram, double start_s, double seconds,
+                               uint64_t stutters, uint64_t over_budget) const;
+
+    // Close the current interval into intervals_.
+    void closeInterval(Clock::time_point now);
+
+    bool writeJson(const std::string &path) const;
+    bool writeCsv(const std::string &path) const;
+
+public:
+    constexpr static double     STUTTER_FACTOR  = 2.0;
+    constexpr static uint64_t   STUTTER_WARMUP  = 16;
+
+    explicit FrameStats(double budget_ms = 1000.0 / 60.0) : budget_ms_(budget_ms) {}
+
+    // Write the summaries to path, and every interval_s seconds when above 0.
+    void setOutput(const std::string &path, double interval_s = 0.0);
+
+    // Start the clock of the first frame. Does nothing when already running.
+    void begin();
+
+    // Close the frame since the last endFrame(), or begin().
+    void endFrame();
+
+    // Close the interval going on and write the output, if there is one.
+    void finish();
+
+    // The whole run.
+    FrameTimeSummary summary() const;
+    inline const std::vector<FrameTimeSummary>& intervals() const { return intervals_; }
+    inline const FrameTimeHistogram& histogram() const { return total_; }
+
+    // Write the summaries to path, as CSV when it ends in .csv and JSON otherwise.
+    bool write(const std::string &path) const;
+
+    // Print the percentiles, maximum, stutters and frames over budget of the run to stdout.
+    void report() const;
+};
+
+}
+
+#endif // !_OPENGL_FRAME_STATS_H_
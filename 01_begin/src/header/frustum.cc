@@ -0,0 +1,189 @@
+#include "frustum.h"
+#include "cpu_trace.h"
+
+#include <cmath>
+#include <cstdio>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FRUSTUM_SSE 1
+#include <immintrin.h>
+#endif
+
+namespace opengl {
+
+Frustum::Frustum(const glm::mat4 &view_projection) {
+    // Gribb/Hartmann: with GL clip space -w <= x, y, z <= w every plane is the last row
+    // plus or minus one of the others. glm is column-major, so row i is m[0][i]..m[3][i].
+    auto row = [&view_projection](int i) {
+        return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+    };
+    planes[LEFT_PLANE]      = row(3) + row(0);
+    planes[RIGHT_PLANE]     = row(3) - row(0);
+    planes[BOTTOM_PLANE]    = row(3) + row(1);
+    planes[TOP_PLANE]       = row(3) - row(1);
+    planes[NEAR_PLANE]      = row(3) + row(2);
+    planes[FAR_PLANE]       = row(3) - row(2);
+    for (auto &plane : planes)
+        plane /= glm::length(glm::vec3(plane));
+}
+
+bool
+Frustum::intersectsSphere(const glm::vec3 &center, float radius) const {
+    for (auto &plane : planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+bool
+Frustum::intersectsBox(const glm::vec3 &center, const glm::vec3 &half_extent) const {
+    for (auto &plane : planes) {
+        // distance of the box corner furthest along the plane normal
+        float radius = glm::dot(glm::abs(glm::vec3(plane)), half_extent);
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+void
+CullStats::report() const {
+    if (frames == 0)
+        return;
+    double percent = tested ? 100.0 * culled() / tested : 0.0;
+    fprintf(stdout, "[Info] Frustum culling: %zu frames, %.1f objects drawn and %.1f culled per frame (%.1f%% culled)\n",
+            frames, (double)visible / frames, (double)culled() / frames, percent);
+}
+
+namespace {
+
+// One bounding volume per lane: the sphere radius, or for boxes the projected half extent.
+struct Volumes {
+    const float *x, *y, *z;
+    const float *rx, *ry, *rz;  // ry and rz are null for spheres
+};
+
+inline bool
+visibleScalar(const Frustum &frustum, const Volumes &v, size_t i) {
+    glm::vec3 center(v.x[i], v.y[i], v.z[i]);
+    if (!v.ry)
+        return frustum.intersectsSphere(center, v.rx[i]);
+    return frustum.intersectsBox(center, glm::vec3(v.rx[i], v.ry[i], v.rz[i]));
+}
+
+uint32_t*
+cullScalar(const Frustum &frustum, const Volumes &v, size_t begin, size_t end, uint32_t *out) {
+    for (size_t i = begin; i < end; ++i) {
+        if (visibleScalar(frustum, v, i))
+            *out++ = (uint32_t)i;
+    }
+    return out;
+}
+
+#ifdef FRUSTUM_SSE
+
+// Returns the index it stopped at, the rest is for the scalar loop.
+size_t
+cullSSE(const Frustum &frustum, const Volumes &v, size_t begin, size_t end, uint32_t *&out) {
+    __m128 nx[Frustum::PLANE_COUNT], ny[Frustum::PLANE_COUNT], nz[Frustum::PLANE_COUNT];
+    __m128 nw[Frustum::PLANE_COUNT], ax[Frustum::PLANE_COUNT], ay[Frustum::PLANE_COUNT], az[Frustum::PLANE_COUNT];
+    for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+        const glm::vec4 &plane = frustum.planes[p];
+        nx[p] = _mm_set1_ps(plane.x);
+        ny[p] = _mm_set1_ps(plane.y);
+        nz[p] = _mm_set1_ps(plane.z);
+        nw[p] = _mm_set1_ps(plane.w);
+        ax[p] = _mm_set1_ps(std::fabs(plane.x));
+        ay[p] = _mm_set1_ps(std::fabs(plane.y));
+        az[p] = _mm_set1_ps(std::fabs(plane.z));
+    }
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_loadu_ps(v.x + i), y = _mm_loadu_ps(v.y + i), z = _mm_loadu_ps(v.z + i);
+        __m128 rx = _mm_loadu_ps(v.rx + i);
+        __m128 ry = v.ry ? _mm_loadu_ps(v.ry + i) : _mm_setzero_ps();
+        __m128 rz = v.ry ? _mm_loadu_ps(v.rz + i) : _mm_setzero_ps();
+
+        // lanes stay set while the volume reaches inside every plane: distance >= -radius
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y)),
+                                         _mm_add_ps(_mm_mul_ps(nz[p], z), nw[p]));
+            __m128 radius = v.ry ? _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], rx), _mm_mul_ps(ay[p], ry)), _mm_mul_ps(az[p], rz))
+                                 : rx;
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        // append the indices of the set lanes in order, writing every lane but only
+        // advancing past the visible ones keeps the loop free of branches
+        unsigned mask = (unsigned)_mm_movemask_ps(inside);
+        for (unsigned lane = 0; lane < 4; ++lane) {
+            *out = (uint32_t)(i + lane);
+            out += (mask >> lane) & 1;
+        }
+    }
+    return i;
+}
+
+#endif // FRUSTUM_SSE
+
+const std::vector<uint32_t>&
+cull(const Frustum &frustum, const Volumes &v, size_t count, FrustumCuller::Kernel kernel,
+     std::vector<uint32_t> &visible, CullStats &stats) {
+    OPENGL_TRACE_ZONE("frustum cull");
+    if (kernel == FrustumCuller::BEST)
+        kernel = FrustumCuller::kernelSupported(FrustumCuller::SSE) ? FrustumCuller::SSE : FrustumCuller::SCALAR;
+
+    // sized for the worst case up front, so the kernels write without bounds checks
+    visible.resize(count);
+    uint32_t *out = visible.data();
+    size_t done = 0;
+#ifdef FRUSTUM_SSE
+    if (kernel == FrustumCuller::SSE)
+        done = cullSSE(frustum, v, done, count, out);
+#endif
+    out = cullScalar(frustum, v, done, count, out);
+    visible.resize(out - visible.data());
+
+    stats.frames++;
+    stats.tested += count;
+    stats.visible += visible.size();
+    return visible;
+}
+
+}
+
+bool
+FrustumCuller::kernelSupported(Kernel kernel) {
+    switch (kernel) {
+    case SCALAR:
+    case BEST:
+        return true;
+    case SSE:
+#ifdef FRUSTUM_SSE
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+const std::vector<uint32_t>&
+FrustumCuller::cullSpheres(const Frustum &frustum, const float *center_x, const float *center_y,
+                           const float *center_z, const float *radius, size_t count, Kernel kernel) {
+    Volumes volumes{ center_x, center_y, center_z, radius, nullptr, nullptr };
+    return cull(frustum, volumes, count, kernel, visible_, stats_);
+}
+
+const std::vector<uint32_t>&
+FrustumCuller::cullBoxes(const Frustum &frustum, const float *center_x, const float *center_y,
+                         const float *center_z, const float *half_x, const float *half_y,
+                         const float *half_z, size_t count, Kernel kernel) {
+    Volumes volumes{ center_x, center_y, center_z, half_x, half_y, half_z };
+    return cull(frustum, volumes, count, kernel, visible_, stats_);
+}
+
+}
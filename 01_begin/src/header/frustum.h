@@ -0,0 +1,92 @@
+/**
+ * @file frustum.h
+ * @author l1ang70
+ * @brief View-frustum planes and batched visibility culling
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_FRUSTUM_H_
+#define _OPENGL_FRUSTUM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace opengl {
+
+// The six planes of a projection * view matrix, each normalized with its normal pointing
+// into the frustum: a point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0.
+struct Frustum {
+    enum Plane {
+        LEFT_PLANE,
+        RIGHT_PLANE,
+        BOTTOM_PLANE,
+        TOP_PLANE,
+        NEAR_PLANE,
+        FAR_PLANE,
+        PLANE_COUNT
+    };
+
+    glm::vec4 planes[PLANE_COUNT];
+
+    Frustum() = default;
+    explicit Frustum(const glm::mat4 &view_projection);
+
+    // Conservative tests: false only when the volume is entirely outside one plane.
+    bool intersectsSphere(const glm::vec3 &center, float radius) const;
+    bool intersectsBox(const glm::vec3 &center, const glm::vec3 &half_extent) const;
+};
+
+// Objects tested and drawn since the last reset, summed over frames.
+struct CullStats {
+    size_t frames  = 0;
+    size_t tested  = 0;
+    size_t visible = 0;
+
+    inline size_t culled() const { return tested - visible; }
+    inline void reset() { frames = tested = visible = 0; }
+
+    // Print the per-frame averages to stdout.
+    void report() const;
+};
+
+// Culls many bounding volumes at once and keeps a compact list of the visible indices for
+// the draw loop. The volumes are passed as separate arrays so 4 can be tested per step.
+class FrustumCuller {
+    std::vector<uint32_t>   visible_;
+    CullStats               stats_{};
+
+public:
+    enum Kernel {
+        SCALAR,
+        SSE,
+        BEST    // the widest kernel this CPU runs
+    };
+
+    FrustumCuller() = default;
+
+    static bool kernelSupported(Kernel kernel);
+
+    // Each call counts as one frame in stats(). Returns visible().
+    const std::vector<uint32_t>& cullSpheres(const Frustum &frustum, const float *center_x, const float *center_y,
+                                             const float *center_z, const float *radius, size_t count,
+                                             Kernel kernel = BEST);
+    const std::vector<uint32_t>& cullBoxes(const Frustum &frustum, const float *center_x, const float *center_y,
+                                           const float *center_z, const float *half_x, const float *half_y,
+                                           const float *half_z, size_t count, Kernel kernel = BEST);
+
+    // Indices of the objects that passed the last cull, in ascending order.
+    inline const std::vector<uint32_t>& visible() const { return visible_; }
+
+    inline const CullStats& stats() const { return stats_; }
+    inline void resetStats() { stats_.reset(); }
+};
+
+}
+
+#endif // !_OPENGL_FRUSTUM_H_
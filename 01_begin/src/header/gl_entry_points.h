@@ -0,0 +1,1071 @@
+/**
+ * @file gl_entry_points.h
+ * @author l1ang70
+ * @brief The entry points of GL 1.0 to 4.6 in glad/glad.h, as an X macro
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_GL_ENTRY_POINTS_H_
+#define _OPENGL_GL_ENTRY_POINTS_H_
+
+// X(name) for every glad_name function pointer of the GL_VERSION_1_0 to GL_VERSION_4_6
+// blocks of glad/glad.h, in their order. The list is generated from the header the loader
+// was built with. After glad is generated again, run this in the repository root and drop
+// the backslash of the last line:
+//   awk '/^#ifndef GL_VERSION_1_0$/{on=1} on&&/^GLAPI PFN/{print} /^#define GL_VERSION_4_6 1$/{last=1}
+//        last&&/^#endif/{exit}' include/glad/glad.h | sed 's/.*glad_\(gl[A-Za-z0-9_]*\);/    X(\1) \\/'
+#define OPENGL_GL_ENTRY_POINTS(X) \
+    X(glCullFace) \
+    X(glFrontFace) \
+    X(glHint) \
+    X(glLineWidth) \
+    X(glPointSize) \
+    X(glPolygonMode) \
+    X(glScissor) \
+    X(glTexParameterf) \
+    X(glTexParameterfv) \
+    X(glTexParameteri) \
+    X(glTexParameteriv) \
+    X(glTexImage1D) \
+    X(glTexImage2D) \
+    X(glDrawBuffer) \
+    X(glClear) \
+    X(glClearColor) \
+    X(glClearStencil) \
+    X(glClearDepth) \
+    X(glStencilMask) \
+    X(glColorMask) \
+    X(glDepthMask) \
+    X(glDisable) \
+    X(glEnable) \
+    X(glFinish) \
+    X(glFlush) \
+    X(glBlendFunc) \
+    X(glLogicOp) \
+    X(glStencilFunc) \
+    X(glStencilOp) \
+    X(glDepthFunc) \
+    X(glPixelStoref) \
+    X(glPixelStorei) \
+    X(glReadBuffer) \
+    X(glReadPixels) \
+    X(glGetBooleanv) \
+    X(glGetDoublev) \
+    X(glGetError) \
+    X(glGetFloatv) \
+    X(glGetIntegerv) \
+    X(glGetString) \
+    X(glGetTexImage) \
+    X(glGetTexParameterfv) \
+    X(glGetTexParameteriv) \
+    X(glGetTexLevelParameterfv) \
+    X(glGetTexLevelParameteriv) \
+    X(glIsEnabled) \
+    X(glDepthRange) \
+    X(glViewport) \
+    X(glNewList) \
+    X(glEndList) \
+    X(glCallList) \
+    X(glCallLists) \
+    X(glDeleteLists) \
+    X(glGenLists) \
+    X(glListBase) \
+    X(glBegin) \
+    X(glBitmap) \
+    X(glColor3b) \
+    X(glColor3bv) \
+    X(glColor3d) \
+    X(glColor3dv) \
+    X(glColor3f) \
+    X(glColor3fv) \
+    X(glColor3i) \
+    X(glColor3iv) \
+    X(glColor3s) \
+    X(glColor3sv) \
+    X(glColor3ub) \
+    X(glColor3ubv) \
+    X(glColor3ui) \
+    X(glColor3uiv) \
+    X(glColor3us) \
+    X(glColor3usv) \
+    X(glColor4b) \
+    X(glColor4bv) \
+    X(glColor4d) \
+    X(glColor4dv) \
+    X(glColor4f) \
+    X(glColor4fv) \
+    X(glColor4i) \
+    X(glColor4iv) \
+    X(glColor4s) \
+    X(glColor4sv) \
+    X(glColor4ub) \
+    X(glColor4ubv) \
+    X(glColor4ui) \
+    X(glColor4uiv) \
+    X(glColor4us) \
+    X(glColor4usv) \
+    X(glEdgeFlag) \
+    X(glEdgeFlagv) \
+    X(glEnd) \
+    X(glIndexd) \
+    X(glIndexdv) \
+    X(glIndexf) \
+    X(glIndexfv) \
+    X(glIndexi) \
+    X(glIndexiv) \
+    X(glIndexs) \
+    X(glIndexsv) \
+    X(glNormal3b) \
+    X(glNormal3bv) \
+    X(glNormal3d) \
+    X(glNormal3dv) \
+    X(glNormal3f) \
+    X(glNormal3fv) \
+    X(glNormal3i) \
+    X(glNormal3iv) \
+    X(glNormal3s) \
+    X(glNormal3sv) \
+    X(glRasterPos2d) \
+    X(glRasterPos2dv) \
+    X(glRasterPos2f) \
+    X(glRasterPos2fv) \
+    X(glRasterPos2i) \
+    X(glRasterPos2iv) \
+    X(glRasterPos2s) \
+    X(glRasterPos2sv) \
+    X(glRasterPos3d) \
+    X(glRasterPos3dv) \
+    X(glRasterPos3f) \
+    X(glRasterPos3fv) \
+    X(glRasterPos3i) \
+    X(glRasterPos3iv) \
+    X(glRasterPos3s) \
+    X(glRasterPos3sv) \
+    X(glRasterPos4d) \
+    X(glRasterPos4dv) \
+    X(glRasterPos4f) \
+    X(glRasterPos4fv) \
+    X(glRasterPos4i) \
+    X(glRasterPos4iv) \
+    X(glRasterPos4s) \
+    X(glRasterPos4sv) \
+    X(glRectd) \
+    X(glRectdv) \
+    X(glRectf) \
+    X(glRectfv) \
+    X(glRecti) \
+    X(glRectiv) \
+    X(glRects) \
+    X(glRectsv) \
+    X(glTexCoord1d) \
+    X(glTexCoord1dv) \
+    X(glTexCoord1f) \
+    X(glTexCoord1fv) \
+    X(glTexCoord1i) \
+    X(glTexCoord1iv) \
+    X(glTexCoord1s) \
+    X(glTexCoord1sv) \
+    X(glTexCoord2d) \
+    X(glTexCoord2dv) \
+    X(glTexCoord2f) \
+    X(glTexCoord2fv) \
+    X(glTexCoord2i) \
+    X(glTexCoord2iv) \
+    X(glTexCoord2s) \
+    X(glTexCoord2sv) \
+    X(glTexCoord3d) \
+    X(glTexCoord3dv) \
+    X(glTexCoord3f) \
+    X(glTexCoord3fv) \
+    X(glTexCoord3i) \
+    X(glTexCoord3iv) \
+    X(glTexCoord3s) \
+    X(glTexCoord3sv) \
+    X(glTexCoord4d) \
+    X(glTexCoord4dv) \
+    X(glTexCoord4f) \
+    X(glTexCoord4fv) \
+    X(glTexCoord4i) \
+    X(glTexCoord4iv) \
+    X(glTexCoord4s) \
+    X(glTexCoord4sv) \
+    X(glVertex2d) \
+    X(glVertex2dv) \
+    X(glVertex2f) \
+    X(glVertex2fv) \
+    X(glVertex2i) \
+    X(glVertex2iv) \
+    X(glVertex2s) \
+    X(glVertex2sv) \
+    X(glVertex3d) \
+    X(glVertex3dv) \
+    X(glVertex3f) \
+    X(glVertex3fv) \
+    X(glVertex3i) \
+    X(glVertex3iv) \
+    X(glVertex3s) \
+    X(glVertex3sv) \
+    X(glVertex4d) \
+    X(glVertex4dv) \
+    X(glVertex4f) \
+    X(glVertex4fv) \
+    X(glVertex4i) \
+    X(glVertex4iv) \
+    X(glVertex4s) \
+    X(glVertex4sv) \
+    X(glClipPlane) \
+    X(glColorMaterial) \
+    X(glFogf) \
+    X(glFogfv) \
+    X(glFogi) \
+    X(glFogiv) \
+    X(glLightf) \
+    X(glLightfv) \
+    X(glLighti) \
+    X(glLightiv) \
+    X(glLightModelf) \
+    X(glLightModelfv) \
+    X(glLightModeli) \
+    X(glLightModeliv) \
+    X(glLineStipple) \
+    X(glMaterialf) \
+    X(glMaterialfv) \
+    X(glMateriali) \
+    X(glMaterialiv) \
+    X(glPolygonStipple) \
+    X(glShadeModel) \
+    X(glTexEnvf) \
+    X(glTexEnvfv) \
+    X(glTexEnvi) \
+    X(glTexEnviv) \
+    X(glTexGend) \
+    X(glTexGendv) \
+    X(glTexGenf) \
+    X(glTexGenfv) \
+    X(glTexGeni) \
+    X(glTexGeniv) \
+    X(glFeedbackBuffer) \
+    X(glSelectBuffer) \
+    X(glRenderMode) \
+    X(glInitNames) \
+    X(glLoadName) \
+    X(glPassThrough) \
+    X(glPopName) \
+    X(glPushName) \
+    X(glClearAccum) \
+    X(glClearIndex) \
+    X(glIndexMask) \
+    X(glAccum) \
+    X(glPopAttrib) \
+    X(glPushAttrib) \
+    X(glMap1d) \
+    X(glMap1f) \
+    X(glMap2d) \
+    X(glMap2f) \
+    X(glMapGrid1d) \
+    X(glMapGrid1f) \
+    X(glMapGrid2d) \
+    X(glMapGrid2f) \
+    X(glEvalCoord1d) \
+    X(glEvalCoord1dv) \
+    X(glEvalCoord1f) \
+    X(glEvalCoord1fv) \
+    X(glEvalCoord2d) \
+    X(glEvalCoord2dv) \
+    X(glEvalCoord2f) \
+    X(glEvalCoord2fv) \
+    X(glEvalMesh1) \
+    X(glEvalPoint1) \
+    X(glEvalMesh2) \
+    X(glEvalPoint2) \
+    X(glAlphaFunc) \
+    X(glPixelZoom) \
+    X(glPixelTransferf) \
+    X(glPixelTransferi) \
+    X(glPixelMapfv) \
+    X(glPixelMapuiv) \
+    X(glPixelMapusv) \
+    X(glCopyPixels) \
+    X(glDrawPixels) \
+    X(glGetClipPlane) \
+    X(glGetLightfv) \
+    X(glGetLightiv) \
+    X(glGetMapdv) \
+    X(glGetMapfv) \
+    X(glGetMapiv) \
+    X(glGetMaterialfv) \
+    X(glGetMaterialiv) \
+    X(glGetPixelMapfv) \
+    X(glGetPixelMapuiv) \
+    X(glGetPixelMapusv) \
+    X(glGetPolygonStipple) \
+    X(glGetTexEnvfv) \
+    X(glGetTexEnviv) \
+    X(glGetTexGendv) \
+    X(glGetTexGenfv) \
+    X(glGetTexGeniv) \
+    X(glIsList) \
+    X(glFrustum) \
+    X(glLoadIdentity) \
+    X(glLoadMatrixf) \
+    X(glLoadMatrixd) \
+    X(glMatrixMode) \
+    X(glMultMatrixf) \
+    X(glMultMatrixd) \
+    X(glOrtho) \
+    X(glPopMatrix) \
+    X(glPushMatrix) \
+    X(glRotated) \
+    X(glRotatef) \
+    X(glScaled) \
+    X(glScalef) \
+    X(glTranslated) \
+    X(glTranslatef) \
+    X(glDrawArrays) \
+    X(glDrawElements) \
+    X(glGetPointerv) \
+    X(glPolygonOffset) \
+    X(glCopyTexImage1D) \
+    X(glCopyTexImage2D) \
+    X(glCopyTexSubImage1D) \
+    X(glCopyTexSubImage2D) \
+    X(glTexSubImage1D) \
+    X(glTexSubImage2D) \
+    X(glBindTexture) \
+    X(glDeleteTextures) \
+    X(glGenTextures) \
+    X(glIsTexture) \
+    X(glArrayElement) \
+    X(glColorPointer) \
+    X(glDisableClientState) \
+    X(glEdgeFlagPointer) \
+    X(glEnableClientState) \
+    X(glIndexPointer) \
+    X(glInterleavedArrays) \
+    X(glNormalPointer) \
+    X(glTexCoordPointer) \
+    X(glVertexPointer) \
+    X(glAreTexturesResident) \
+    X(glPrioritizeTextures) \
+    X(glIndexub) \
+    X(glIndexubv) \
+    X(glPopClientAttrib) \
+    X(glPushClientAttrib) \
+    X(glDrawRangeElements) \
+    X(glTexImage3D) \
+    X(glTexSubImage3D) \
+    X(glCopyTexSubImage3D) \
+    X(glActiveTexture) \
+    X(glSampleCoverage) \
+    X(glCompressedTexImage3D) \
+    X(glCompressedTexImage2D) \
+    X(glCompressedTexImage1D) \
+    X(glCompressedTexSubImage3D) \
+    X(glCompressedTexSubImage2D) \
+    X(glCompressedTexSubImage1D) \
+    X(glGetCompressedTexImage) \
+    X(glClientActiveTexture) \
+    X(glMultiTexCoord1d) \
+    X(glMultiTexCoord1dv) \
+    X(glMultiTexCoord1f) \
+    X(glMultiTexCoord1fv) \
+    X(glMultiTexCoord1i) \
+    X(glMultiTexCoord1iv) \
+    X(glMultiTexCoord1s) \
+    X(glMultiTexCoord1sv) \
+    X(glMultiTexCoord2d) \
+    X(glMultiTexCoord2dv) \
+    X(glMultiTexCoord2f) \
+    X(glMultiTexCoord2fv) \
+    X(glMultiTexCoord2i) \
+    X(glMultiTexCoord2iv) \
+    X(glMultiTexCoord2s) \
+    X(glMultiTexCoord2sv) \
+    X(glMultiTexCoord3d) \
+    X(glMultiTexCoord3dv) \
+    X(glMultiTexCoord3f) \
+    X(glMultiTexCoord3fv) \
+    X(glMultiTexCoord3i) \
+    X(glMultiTexCoord3iv) \
+    X(glMultiTexCoord3s) \
+    X(glMultiTexCoord3sv) \
+    X(glMultiTexCoord4d) \
+    X(glMultiTexCoord4dv) \
+    X(glMultiTexCoord4f) \
+    X(glMultiTexCoord4fv) \
+    X(glMultiTexCoord4i) \
+    X(glMultiTexCoord4iv) \
+    X(glMultiTexCoord4s) \
+    X(glMultiTexCoord4sv) \
+    X(glLoadTransposeMatrixf) \
+    X(glLoadTransposeMatrixd) \
+    X(glMultTransposeMatrixf) \
+    X(glMultTransposeMatrixd) \
+    X(glBlendFuncSeparate) \
+    X(glMultiDrawArrays) \
+    X(glMultiDrawElements) \
+    X(glPointParameterf) \
+    X(glPointParameterfv) \
+    X(glPointParameteri) \
+    X(glPointParameteriv) \
+    X(glFogCoordf) \
+    X(glFogCoordfv) \
+    X(glFogCoordd) \
+    X(glFogCoorddv) \
+    X(glFogCoordPointer) \
+    X(glSecondaryColor3b) \
+    X(glSecondaryColor3bv) \
+    X(glSecondaryColor3d) \
+    X(glSecondaryColor3dv) \
+    X(glSecondaryColor3f) \
+    X(glSecondaryColor3fv) \
+    X(glSecondaryColor3i) \
+    X(glSecondaryColor3iv) \
+    X(glSecondaryColor3s) \
+    X(glSecondaryColor3sv) \
+    X(glSecondaryColor3ub) \
+    X(glSecondaryColor3ubv) \
+    X(glSecondaryColor3ui) \
+    X(glSecondaryColor3uiv) \
+    X(glSecondaryColor3us) \
+    X(glSecondaryColor3usv) \
+    X(glSecondaryColorPointer) \
+    X(glWindowPos2d) \
+    X(glWindowPos2dv) \
+    X(glWindowPos2f) \
+    X(glWindowPos2fv) \
+    X(glWindowPos2i) \
+    X(glWindowPos2iv) \
+    X(glWindowPos2s) \
+    X(glWindowPos2sv) \
+    X(glWindowPos3d) \
+    X(glWindowPos3dv) \
+    X(glWindowPos3f) \
+    X(glWindowPos3fv) \
+    X(glWindowPos3i) \
+    X(glWindowPos3iv) \
+    X(glWindowPos3s) \
+    X(glWindowPos3sv) \
+    X(glBlendColor) \
+    X(glBlendEquation) \
+    X(glGenQueries) \
+    X(glDeleteQueries) \
+    X(glIsQuery) \
+    X(glBeginQuery) \
+    X(glEndQuery) \
+    X(glGetQueryiv) \
+    X(glGetQueryObjectiv) \
+    X(glGetQueryObjectuiv) \
+    X(glBindBuffer) \
+    X(glDeleteBuffers) \
+    X(glGenBuffers) \
+    X(glIsBuffer) \
+    X(glBufferData) \
+    X(glBufferSubData) \
+    X(glGetBufferSubData) \
+    X(glMapBuffer) \
+    X(glUnmapBuffer) \
+    X(glGetBufferParameteriv) \
+    X(glGetBufferPointerv) \
+    X(glBlendEquationSeparate) \
+    X(glDrawBuffers) \
+    X(glStencilOpSeparate) \
+    X(glStencilFuncSeparate) \
+    X(glStencilMaskSeparate) \
+    X(glAttachShader) \
+    X(glBindAttribLocation) \
+    X(glCompileShader) \
+    X(glCreateProgram) \
+    X(glCreateShader) \
+    X(glDeleteProgram) \
+    X(glDeleteShader) \
+    X(glDetachShader) \
+    X(glDisableVertexAttribArray) \
+    X(glEnableVertexAttribArray) \
+    X(glGetActiveAttrib) \
+    X(glGetActiveUniform) \
+    X(glGetAttachedShaders) \
+    X(glGetAttribLocation) \
+    X(glGetProgramiv) \
+    X(glGetProgramInfoLog) \
+    X(glGetShaderiv) \
+    X(glGetShaderInfoLog) \
+    X(glGetShaderSource) \
+    X(glGetUniformLocation) \
+    X(glGetUniformfv) \
+    X(glGetUniformiv) \
+    X(glGetVertexAttribdv) \
+    X(glGetVertexAttribfv) \
+    X(glGetVertexAttribiv) \
+    X(glGetVertexAttribPointerv) \
+    X(glIsProgram) \
+    X(glIsShader) \
+    X(glLinkProgram) \
+    X(glShaderSource) \
+    X(glUseProgram) \
+    X(glUniform1f) \
+    X(glUniform2f) \
+    X(glUniform3f) \
+    X(glUniform4f) \
+    X(glUniform1i) \
+    X(glUniform2i) \
+    X(glUniform3i) \
+    X(glUniform4i) \
+    X(glUniform1fv) \
+    X(glUniform2fv) \
+    X(glUniform3fv) \
+    X(glUniform4fv) \
+    X(glUniform1iv) \
+    X(glUniform2iv) \
+    X(glUniform3iv) \
+    X(glUniform4iv) \
+    X(glUniformMatrix2fv) \
+    X(glUniformMatrix3fv) \
+    X(glUniformMatrix4fv) \
+    X(glValidateProgram) \
+    X(glVertexAttrib1d) \
+    X(glVertexAttrib1dv) \
+    X(glVertexAttrib1f) \
+    X(glVertexAttrib1fv) \
+    X(glVertexAttrib1s) \
+    X(glVertexAttrib1sv) \
+    X(glVertexAttrib2d) \
+    X(glVertexAttrib2dv) \
+    X(glVertexAttrib2f) \
+    X(glVertexAttrib2fv) \
+    X(glVertexAttrib2s) \
+    X(glVertexAttrib2sv) \
+    X(glVertexAttrib3d) \
+    X(glVertexAttrib3dv) \
+    X(glVertexAttrib3f) \
+    X(glVertexAttrib3fv) \
+    X(glVertexAttrib3s) \
+    X(glVertexAttrib3sv) \
+    X(glVertexAttrib4Nbv) \
+    X(glVertexAttrib4Niv) \
+    X(glVertexAttrib4Nsv) \
+    X(glVertexAttrib4Nub) \
+    X(glVertexAttrib4Nubv) \
+    X(glVertexAttrib4Nuiv) \
+    X(glVertexAttrib4Nusv) \
+    X(glVertexAttrib4bv) \
+    X(glVertexAttrib4d) \
+    X(glVertexAttrib4dv) \
+    X(glVertexAttrib4f) \
+    X(glVertexAttrib4fv) \
+    X(glVertexAttrib4iv) \
+    X(glVertexAttrib4s) \
+    X(glVertexAttrib4sv) \
+    X(glVertexAttrib4ubv) \
+    X(glVertexAttrib4uiv) \
+    X(glVertexAttrib4usv) \
+    X(glVertexAttribPointer) \
+    X(glUniformMatrix2x3fv) \
+    X(glUniformMatrix3x2fv) \
+    X(glUniformMatrix2x4fv) \
+    X(glUniformMatrix4x2fv) \
+    X(glUniformMatrix3x4fv) \
+    X(glUniformMatrix4x3fv) \
+    X(glColorMaski) \
+    X(glGetBooleani_v) \
+    X(glGetIntegeri_v) \
+    X(glEnablei) \
+    X(glDisablei) \
+    X(glIsEnabledi) \
+    X(glBeginTransformFeedback) \
+    X(glEndTransformFeedback) \
+    X(glBindBufferRange) \
+    X(glBindBufferBase) \
+    X(glTransformFeedbackVaryings) \
+    X(glGetTransformFeedbackVarying) \
+    X(glClampColor) \
+    X(glBeginConditionalRender) \
+    X(glEndConditionalRender) \
+    X(glVertexAttribIPointer) \
+    X(glGetVertexAttribIiv) \
+    X(glGetVertexAttribIuiv) \
+    X(glVertexAttribI1i) \
+    X(glVertexAttribI2i) \
+    X(glVertexAttribI3i) \
+    X(glVertexAttribI4i) \
+    X(glVertexAttribI1ui) \
+    X(glVertexAttribI2ui) \
+    X(glVertexAttribI3ui) \
+    X(glVertexAttribI4ui) \
+    X(glVertexAttribI1iv) \
+    X(glVertexAttribI2iv) \
+    X(glVertexAttribI3iv) \
+    X(glVertexAttribI4iv) \
+    X(glVertexAttribI1uiv) \
+    X(glVertexAttribI2uiv) \
+    X(glVertexAttribI3uiv) \
+    X(glVertexAttribI4uiv) \
+    X(glVertexAttribI4bv) \
+    X(glVertexAttribI4sv) \
+    X(glVertexAttribI4ubv) \
+    X(glVertexAttribI4usv) \
+    X(glGetUniformuiv) \
+    X(glBindFragDataLocation) \
+    X(glGetFragDataLocation) \
+    X(glUniform1ui) \
+    X(glUniform2ui) \
+    X(glUniform3ui) \
+    X(glUniform4ui) \
+    X(glUniform1uiv) \
+    X(glUniform2uiv) \
+    X(glUniform3uiv) \
+    X(glUniform4uiv) \
+    X(glTexParameterIiv) \
+    X(glTexParameterIuiv) \
+    X(glGetTexParameterIiv) \
+    X(glGetTexParameterIuiv) \
+    X(glClearBufferiv) \
+    X(glClearBufferuiv) \
+    X(glClearBufferfv) \
+    X(glClearBufferfi) \
+    X(glGetStringi) \
+    X(glIsRenderbuffer) \
+    X(glBindRenderbuffer) \
+    X(glDeleteRenderbuffers) \
+    X(glGenRenderbuffers) \
+    X(glRenderbufferStorage) \
+    X(glGetRenderbufferParameteriv) \
+    X(glIsFramebuffer) \
+    X(glBindFramebuffer) \
+    X(glDeleteFramebuffers) \
+    X(glGenFramebuffers) \
+    X(glCheckFramebufferStatus) \
+    X(glFramebufferTexture1D) \
+    X(glFramebufferTexture2D) \
+    X(glFramebufferTexture3D) \
+    X(glFramebufferRenderbuffer) \
+    X(glGetFramebufferAttachmentParameteriv) \
+    X(glGenerateMipmap) \
+    X(glBlitFramebuffer) \
+    X(glRenderbufferStorageMultisample) \
+    X(glFramebufferTextureLayer) \
+    X(glMapBufferRange) \
+    X(glFlushMappedBufferRange) \
+    X(glBindVertexArray) \
+    X(glDeleteVertexArrays) \
+    X(glGenVertexArrays) \
+    X(glIsVertexArray) \
+    X(glDrawArraysInstanced) \
+    X(glDrawElementsInstanced) \
+    X(glTexBuffer) \
+    X(glPrimitiveRestartIndex) \
+    X(glCopyBufferSubData) \
+    X(glGetUniformIndices) \
+    X(glGetActiveUniformsiv) \
+    X(glGetActiveUniformName) \
+    X(glGetUniformBlockIndex) \
+    X(glGetActiveUniformBlockiv) \
+    X(glGetActiveUniformBlockName) \
+    X(glUniformBlockBinding) \
+    X(glDrawElementsBaseVertex) \
+    X(glDrawRangeElementsBaseVertex) \
+    X(glDrawElementsInstancedBaseVertex) \
+    X(glMultiDrawElementsBaseVertex) \
+    X(glProvokingVertex) \
+    X(glFenceSync) \
+    X(glIsSync) \
+    X(glDeleteSync) \
+    X(glClientWaitSync) \
+    X(glWaitSync) \
+    X(glGetInteger64v) \
+    X(glGetSynciv) \
+    X(glGetInteger64i_v) \
+    X(glGetBufferParameteri64v) \
+    X(glFramebufferTexture) \
+    X(glTexImage2DMultisample) \
+    X(glTexImage3DMultisample) \
+    X(glGetMultisamplefv) \
+    X(glSampleMaski) \
+    X(glBindFragDataLocationIndexed) \
+    X(glGetFragDataIndex) \
+    X(glGenSamplers) \
+    X(glDeleteSamplers) \
+    X(glIsSampler) \
+    X(glBindSampler) \
+    X(glSamplerParameteri) \
+    X(glSamplerParameteriv) \
+    X(glSamplerParameterf) \
+    X(glSamplerParameterfv) \
+    X(glSamplerParameterIiv) \
+    X(glSamplerParameterIuiv) \
+    X(glGetSamplerParameteriv) \
+    X(glGetSamplerParameterIiv) \
+    X(glGetSamplerParameterfv) \
+    X(glGetSamplerParameterIuiv) \
+    X(glQueryCounter) \
+    X(glGetQueryObjecti64v) \
+    X(glGetQueryObjectui64v) \
+    X(glVertexAttribDivisor) \
+    X(glVertexAttribP1ui) \
+    X(glVertexAttribP1uiv) \
+    X(glVertexAttribP2ui) \
+    X(glVertexAttribP2uiv) \
+    X(glVertexAttribP3ui) \
+    X(glVertexAttribP3uiv) \
+    X(glVertexAttribP4ui) \
+    X(glVertexAttribP4uiv) \
+    X(glVertexP2ui) \
+    X(glVertexP2uiv) \
+    X(glVertexP3ui) \
+    X(glVertexP3uiv) \
+    X(glVertexP4ui) \
+    X(glVertexP4uiv) \
+    X(glTexCoordP1ui) \
+    X(glTexCoordP1uiv) \
+    X(glTexCoordP2ui) \
+    X(glTexCoordP2uiv) \
+    X(glTexCoordP3ui) \
+    X(glTexCoordP3uiv) \
+    X(glTexCoordP4ui) \
+    X(glTexCoordP4uiv) \
+    X(glMultiTexCoordP1ui) \
+    X(glMultiTexCoordP1uiv) \
+    X(glMultiTexCoordP2ui) \
+    X(glMultiTexCoordP2uiv) \
+    X(glMultiTexCoordP3ui) \
+    X(glMultiTexCoordP3uiv) \
+    X(glMultiTexCoordP4ui) \
+    X(glMultiTexCoordP4uiv) \
+    X(glNormalP3ui) \
+    X(glNormalP3uiv) \
+    X(glColorP3ui) \
+    X(glColorP3uiv) \
+    X(glColorP4ui) \
+    X(glColorP4uiv) \
+    X(glSecondaryColorP3ui) \
+    X(glSecondaryColorP3uiv) \
+    X(glMinSampleShading) \
+    X(glBlendEquationi) \
+    X(glBlendEquationSeparatei) \
+    X(glBlendFunci) \
+    X(glBlendFuncSeparatei) \
+    X(glDrawArraysIndirect) \
+    X(glDrawElementsIndirect) \
+    X(glUniform1d) \
+    X(glUniform2d) \
+    X(glUniform3d) \
+    X(glUniform4d) \
+    X(glUniform1dv) \
+    X(glUniform2dv) \
+    X(glUniform3dv) \
+    X(glUniform4dv) \
+    X(glUniformMatrix2dv) \
+    X(glUniformMatrix3dv) \
+    X(glUniformMatrix4dv) \
+    X(glUniformMatrix2x3dv) \
+    X(glUniformMatrix2x4dv) \
+    X(glUniformMatrix3x2dv) \
+    X(glUniformMatrix3x4dv) \
+    X(glUniformMatrix4x2dv) \
+    X(glUniformMatrix4x3dv) \
+    X(glGetUniformdv) \
+    X(glGetSubroutineUniformLocation) \
+    X(glGetSubroutineIndex) \
+    X(glGetActiveSubroutineUniformiv) \
+    X(glGetActiveSubroutineUniformName) \
+    X(glGetActiveSubroutineName) \
+    X(glUniformSubroutinesuiv) \
+    X(glGetUniformSubroutineuiv) \
+    X(glGetProgramStageiv) \
+    X(glPatchParameteri) \
+    X(glPatchParameterfv) \
+    X(glBindTransformFeedback) \
+    X(glDeleteTransformFeedbacks) \
+    X(glGenTransformFeedbacks) \
+    X(glIsTransformFeedback) \
+    X(glPauseTransformFeedback) \
+    X(glResumeTransformFeedback) \
+    X(glDrawTransformFeedback) \
+    X(glDrawTransformFeedbackStream) \
+    X(glBeginQueryIndexed) \
+    X(glEndQueryIndexed) \
+    X(glGetQueryIndexediv) \
+    X(glReleaseShaderCompiler) \
+    X(glShaderBinary) \
+    X(glGetShaderPrecisionFormat) \
+    X(glDepthRangef) \
+    X(glClearDepthf) \
+    X(glGetProgramBinary) \
+    X(glProgramBinary) \
+    X(glProgramParameteri) \
+    X(glUseProgramStages) \
+    X(glActiveShaderProgram) \
+    X(glCreateShaderProgramv) \
+    X(glBindProgramPipeline) \
+    X(glDeleteProgramPipelines) \
+    X(glGenProgramPipelines) \
+    X(glIsProgramPipeline) \
+    X(glGetProgramPipelineiv) \
+    X(glProgramUniform1i) \
+    X(glProgramUniform1iv) \
+    X(glProgramUniform1f) \
+    X(glProgramUniform1fv) \
+    X(glProgramUniform1d) \
+    X(glProgramUniform1dv) \
+    X(glProgramUniform1ui) \
+    X(glProgramUniform1uiv) \
+    X(glProgramUniform2i) \
+    X(glProgramUniform2iv) \
+    X(glProgramUniform2f) \
+    X(glProgramUniform2fv) \
+    X(glProgramUniform2d) \
+    X(glProgramUniform2dv) \
+    X(glProgramUniform2ui) \
+    X(glProgramUniform2uiv) \
+    X(glProgramUniform3i) \
+    X(glProgramUniform3iv) \
+    X(glProgramUniform3f) \
+    X(glProgramUniform3fv) \
+    X(glProgramUniform3d) \
+    X(glProgramUniform3dv) \
+    X(glProgramUniform3ui) \
+    X(glProgramUniform3uiv) \
+    X(glProgramUniform4i) \
+    X(glProgramUniform4iv) \
+    X(glProgramUniform4f) \
+    X(glProgramUniform4fv) \
+    X(glProgramUniform4d) \
+    X(glProgramUniform4dv) \
+    X(glProgramUniform4ui) \
+    X(glProgramUniform4uiv) \
+    X(glProgramUniformMatrix2fv) \
+    X(glProgramUniformMatrix3fv) \
+    X(glProgramUniformMatrix4fv) \
+    X(glProgramUniformMatrix2dv) \
+    X(glProgramUniformMatrix3dv) \
+    X(glProgramUniformMatrix4dv) \
+    X(glProgramUniformMatrix2x3fv) \
+    X(glProgramUniformMatrix3x2fv) \
+    X(glProgramUniformMatrix2x4fv) \
+    X(glProgramUniformMatrix4x2fv) \
+    X(glProgramUniformMatrix3x4fv) \
+    X(glProgramUniformMatrix4x3fv) \
+    X(glProgramUniformMatrix2x3dv) \
+    X(glProgramUniformMatrix3x2dv) \
+    X(glProgramUniformMatrix2x4dv) \
+    X(glProgramUniformMatrix4x2dv) \
+    X(glProgramUniformMatrix3x4dv) \
+    X(glProgramUniformMatrix4x3dv) \
+    X(glValidateProgramPipeline) \
+    X(glGetProgramPipelineInfoLog) \
+    X(glVertexAttribL1d) \
+    X(glVertexAttribL2d) \
+    X(glVertexAttribL3d) \
+    X(glVertexAttribL4d) \
+    X(glVertexAttribL1dv) \
+    X(glVertexAttribL2dv) \
+    X(glVertexAttribL3dv) \
+    X(glVertexAttribL4dv) \
+    X(glVertexAttribLPointer) \
+    X(glGetVertexAttribLdv) \
+    X(glViewportArrayv) \
+    X(glViewportIndexedf) \
+    X(glViewportIndexedfv) \
+    X(glScissorArrayv) \
+    X(glScissorIndexed) \
+    X(glScissorIndexedv) \
+    X(glDepthRangeArrayv) \
+    X(glDepthRangeIndexed) \
+    X(glGetFloati_v) \
+    X(glGetDoublei_v) \
+    X(glDrawArraysInstancedBaseInstance) \
+    X(glDrawElementsInstancedBaseInstance) \
+    X(glDrawElementsInstancedBaseVertexBaseInstance) \
+    X(glGetInternalformativ) \
+    X(glGetActiveAtomicCounterBufferiv) \
+    X(glBindImageTexture) \
+    X(glMemoryBarrier) \
+    X(glTexStorage1D) \
+    X(glTexStorage2D) \
+    X(glTexStorage3D) \
+    X(glDrawTransformFeedbackInstanced) \
+    X(glDrawTransformFeedbackStreamInstanced) \
+    X(glClearBufferData) \
+    X(glClearBufferSubData) \
+    X(glDispatchCompute) \
+    X(glDispatchComputeIndirect) \
+    X(glCopyImageSubData) \
+    X(glFramebufferParameteri) \
+    X(glGetFramebufferParameteriv) \
+    X(glGetInternalformati64v) \
+    X(glInvalidateTexSubImage) \
+    X(glInvalidateTexImage) \
+    X(glInvalidateBufferSubData) \
+    X(glInvalidateBufferData) \
+    X(glInvalidateFramebuffer) \
+    X(glInvalidateSubFramebuffer) \
+    X(glMultiDrawArraysIndirect) \
+    X(glMultiDrawElementsIndirect) \
+    X(glGetProgramInterfaceiv) \
+    X(glGetProgramResourceIndex) \
+    X(glGetProgramResourceName) \
+    X(glGetProgramResourceiv) \
+    X(glGetProgramResourceLocation) \
+    X(glGetProgramResourceLocationIndex) \
+    X(glShaderStorageBlockBinding) \
+    X(glTexBufferRange) \
+    X(glTexStorage2DMultisample) \
+    X(glTexStorage3DMultisample) \
+    X(glTextureView) \
+    X(glBindVertexBuffer) \
+    X(glVertexAttribFormat) \
+    X(glVertexAttribIFormat) \
+    X(glVertexAttribLFormat) \
+    X(glVertexAttribBinding) \
+    X(glVertexBindingDivisor) \
+    X(glDebugMessageControl) \
+    X(glDebugMessageInsert) \
+    X(glDebugMessageCallback) \
+    X(glGetDebugMessageLog) \
+    X(glPushDebugGroup) \
+    X(glPopDebugGroup) \
+    X(glObjectLabel) \
+    X(glGetObjectLabel) \
+    X(glObjectPtrLabel) \
+    X(glGetObjectPtrLabel) \
+    X(glBufferStorage) \
+    X(glClearTexImage) \
+    X(glClearTexSubImage) \
+    X(glBindBuffersBase) \
+    X(glBindBuffersRange) \
+    X(glBindTextures) \
+    X(glBindSamplers) \
+    X(glBindImageTextures) \
+    X(glBindVertexBuffers) \
+    X(glClipControl) \
+    X(glCreateTransformFeedbacks) \
+    X(glTransformFeedbackBufferBase) \
+    X(glTransformFeedbackBufferRange) \
+    X(glGetTransformFeedbackiv) \
+    X(glGetTransformFeedbacki_v) \
+    X(glGetTransformFeedbacki64_v) \
+    X(glCreateBuffers) \
+    X(glNamedBufferStorage) \
+    X(glNamedBufferData) \
+    X(glNamedBufferSubData) \
+    X(glCopyNamedBufferSubData) \
+    X(glClearNamedBufferData) \
+    X(glClearNamedBufferSubData) \
+    X(glMapNamedBuffer) \
+    X(glMapNamedBufferRange) \
+    X(glUnmapNamedBuffer) \
+    X(glFlushMappedNamedBufferRange) \
+    X(glGetNamedBufferParameteriv) \
+    X(glGetNamedBufferParameteri64v) \
+    X(glGetNamedBufferPointerv) \
+    X(glGetNamedBufferSubData) \
+    X(glCreateFramebuffers) \
+    X(glNamedFramebufferRenderbuffer) \
+    X(glNamedFramebufferParameteri) \
+    X(glNamedFramebufferTexture) \
+    X(glNamedFramebufferTextureLayer) \
+    X(glNamedFramebufferDrawBuffer) \
+    X(glNamedFramebufferDrawBuffers) \
+    X(glNamedFramebufferReadBuffer) \
+    X(glInvalidateNamedFramebufferData) \
+    X(glInvalidateNamedFramebufferSubData) \
+    X(glClearNamedFramebufferiv) \
+    X(glClearNamedFramebufferuiv) \
+    X(glClearNamedFramebufferfv) \
+    X(glClearNamedFramebufferfi) \
+    X(glBlitNamedFramebuffer) \
+    X(glCheckNamedFramebufferStatus) \
+    X(glGetNamedFramebufferParameteriv) \
+    X(glGetNamedFramebufferAttachmentParameteriv) \
+    X(glCreateRenderbuffers) \
+    X(glNamedRenderbufferStorage) \
+    X(glNamedRenderbufferStorageMultisample) \
+    X(glGetNamedRenderbufferParameteriv) \
+    X(glCreateTextures) \
+    X(glTextureBuffer) \
+    X(glTextureBufferRange) \
+    X(glTextureStorage1D) \
+    X(glTextureStorage2D) \
+    X(glTextureStorage3D) \
+    X(glTextureStorage2DMultisample) \
+    X(glTextureStorage3DMultisample) \
+    X(glTextureSubImage1D) \
+    X(glTextureSubImage2D) \
+    X(glTextureSubImage3D) \
+    X(glCompressedTextureSubImage1D) \
+    X(glCompressedTextureSubImage2D) \
+    X(glCompressedTextureSubImage3D) \
+    X(glCopyTextureSubImage1D) \
+    X(glCopyTextureSubImage2D) \
+    X(glCopyTextureSubImage3D) \
+    X(glTextureParameterf) \
+    X(glTextureParameterfv) \
+    X(glTextureParameteri) \
+    X(glTextureParameterIiv) \
+    X(glTextureParameterIuiv) \
+    X(glTextureParameteriv) \
+    X(glGenerateTextureMipmap) \
+    X(glBindTextureUnit) \
+    X(glGetTextureImage) \
+    X(glGetCompressedTextureImage) \
+    X(glGetTextureLevelParameterfv) \
+    X(glGetTextureLevelParameteriv) \
+    X(glGetTextureParameterfv) \
+    X(glGetTextureParameterIiv) \
+    X(glGetTextureParameterIuiv) \
+    X(glGetTextureParameteriv) \
+    X(glCreateVertexArrays) \
+    X(glDisableVertexArrayAttrib) \
+    X(glEnableVertexArrayAttrib) \
+    X(glVertexArrayElementBuffer) \
+    X(glVertexArrayVertexBuffer) \
+    X(glVertexArrayVertexBuffers) \
+    X(glVertexArrayAttribBinding) \
+    X(glVertexArrayAttribFormat) \
+    X(glVertexArrayAttribIFormat) \
+    X(glVertexArrayAttribLFormat) \
+    X(glVertexArrayBindingDivisor) \
+    X(glGetVertexArrayiv) \
+    X(glGetVertexArrayIndexediv) \
+    X(glGetVertexArrayIndexed64iv) \
+    X(glCreateSamplers) \
+    X(glCreateProgramPipelines) \
+    X(glCreateQueries) \
+    X(glGetQueryBufferObjecti64v) \
+    X(glGetQueryBufferObjectiv) \
+    X(glGetQueryBufferObjectui64v) \
+    X(glGetQueryBufferObjectuiv) \
+    X(glMemoryBarrierByRegion) \
+    X(glGetTextureSubImage) \
+    X(glGetCompressedTextureSubImage) \
+    X(glGetGraphicsResetStatus) \
+    X(glGetnCompressedTexImage) \
+    X(glGetnTexImage) \
+    X(glGetnUniformdv) \
+    X(glGetnUniformfv) \
+    X(glGetnUniformiv) \
+    X(glGetnUniformuiv) \
+    X(glReadnPixels) \
+    X(glGetnMapdv) \
+    X(glGetnMapfv) \
+    X(glGetnMapiv) \
+    X(glGetnPixelMapfv) \
+    X(glGetnPixelMapuiv) \
+    X(glGetnPixelMapusv) \
+    X(glGetnPolygonStipple) \
+    X(glGetnColorTable) \
+    X(glGetnConvolutionFilter) \
+    X(glGetnSeparableFilter) \
+    X(glGetnHistogram) \
+    X(glGetnMinmax) \
+    X(glTextureBarrier) \
+    X(glSpecializeShader) \
+    X(glMultiDrawArraysIndirectCount) \
+    X(glMultiDrawElementsIndirectCount) \
+    X(glPolygonOffsetClamp)
+
+#endif // !_OPENGL_GL_ENTRY_POINTS_H_
@@ -0,0 +1,509 @@
+#include "gl_instrument.h"
+#include "gl_entry_points.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace opengl {
+
+namespace {
+
+// Slot families of the state calls, calls of one family set the same state.
+enum StateGroup : uint8_t {
+    NO_GROUP,
+    CAPABILITY_GROUP, CAPABILITY_INDEXED_GROUP,
+    BUFFER_GROUP, BUFFER_INDEXED_GROUP, TEXTURE_GROUP, SAMPLER_GROUP, IMAGE_UNIT_GROUP, ACTIVE_TEXTURE_GROUP,
+    PROGRAM_GROUP, VERTEX_ARRAY_GROUP, FRAMEBUFFER_GROUP, RENDERBUFFER_GROUP,
+    VIEWPORT_GROUP, SCISSOR_GROUP, CLEAR_COLOR_GROUP, CLEAR_DEPTH_GROUP, CLEAR_STENCIL_GROUP,
+    BLEND_FUNC_GROUP, BLEND_EQUATION_GROUP, BLEND_COLOR_GROUP, DEPTH_FUNC_GROUP, DEPTH_MASK_GROUP,
+    DEPTH_RANGE_GROUP, COLOR_MASK_GROUP, STENCIL_FUNC_GROUP, STENCIL_OP_GROUP, STENCIL_MASK_GROUP,
+    CULL_FACE_GROUP, FRONT_FACE_GROUP, POLYGON_MODE_GROUP, POLYGON_OFFSET_GROUP, LINE_WIDTH_GROUP,
+    POINT_SIZE_GROUP, PROVOKING_VERTEX_GROUP, PIXEL_STORE_GROUP, PATCH_PARAMETER_GROUP, PRIMITIVE_RESTART_GROUP,
+    ATTRIBUTE_ARRAY_GROUP, ATTRIBUTE_DIVISOR_GROUP, ATTRIBUTE_FORMAT_GROUP, ATTRIBUTE_BINDING_GROUP,
+    VERTEX_BUFFER_GROUP, BINDING_DIVISOR_GROUP, UNIFORM_GROUP,
+};
+
+// What a state slot belongs to besides its key arguments. The first three are tracked from
+// the calls that bind them; the element buffer is vertex array state, the other buffer
+// targets are not; the program of glProgramUniform* is its first argument.
+enum StateScope : uint8_t {
+    NO_SCOPE,
+    VERTEX_ARRAY_SCOPE,
+    TEXTURE_UNIT_SCOPE,
+    PROGRAM_SCOPE,
+    ELEMENT_BUFFER_SCOPE,
+    ARGUMENT_SCOPE,
+};
+
+inline uint64_t
+mix(uint64_t hash, uint64_t value) {
+    // splitmix64 of the value folded into the hash
+    value += 0x9e3779b97f4a7c15ull + hash;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+}
+
+GLInstrument&
+GLInstrument::current() {
+    static GLInstrument s_instrument;
+    return s_instrument;
+}
+
+#ifdef OPENGL_GL_INSTRUMENT
+
+namespace {
+
+struct StateCall {
+    const char  *name;
+    StateGroup  group;
+    uint8_t     key_arguments;
+    StateScope  scope;
+};
+
+const StateCall STATE_CALLS[] = {
+    { "glEnable",                   CAPABILITY_GROUP,           1, NO_SCOPE },
+    { "glDisable",                  CAPABILITY_GROUP,           1, NO_SCOPE },
+    { "glEnablei",                  CAPABILITY_INDEXED_GROUP,   2, NO_SCOPE },
+    { "glDisablei",                 CAPABILITY_INDEXED_GROUP,   2, NO_SCOPE },
+    { "glBindBuffer",               BUFFER_GROUP,               1, ELEMENT_BUFFER_SCOPE },
+    { "glBindBufferBase",           BUFFER_INDEXED_GROUP,       2, NO_SCOPE },
+    { "glBindBufferRange",          BUFFER_INDEXED_GROUP,       2, NO_SCOPE },
+    { "glBindTexture",              TEXTURE_GROUP,              1, TEXTURE_UNIT_SCOPE },
+    { "glBindSampler",              SAMPLER_GROUP,              1, NO_SCOPE },
+    { "glBindImageTexture",         IMAGE_UNIT_GROUP,           1, NO_SCOPE },
+    { "glActiveTexture",            ACTIVE_TEXTURE_GROUP,       0, NO_SCOPE },
+    { "glUseProgram",               PROGRAM_GROUP,              0, NO_SCOPE },
+    { "glBindVertexArray",          VERTEX_ARRAY_GROUP,         0, NO_SCOPE },
+    { "glBindFramebuffer",          FRAMEBUFFER_GROUP,          0, NO_SCOPE },
+    { "glBindRenderbuffer",         RENDERBUFFER_GROUP,         1, NO_SCOPE },
+    { "glViewport",                 VIEWPORT_GROUP,             0, NO_SCOPE },
+    { "glScissor",                  SCISSOR_GROUP,              0, NO_SCOPE },
+    { "glClearColor",               CLEAR_COLOR_GROUP,          0, NO_SCOPE },
+    { "glClearDepth",               CLEAR_DEPTH_GROUP,          0, NO_SCOPE },
+    { "glClearDepthf",              CLEAR_DEPTH_GROUP,          0, NO_SCOPE },
+    { "glClearStencil",             CLEAR_STENCIL_GROUP,        0, NO_SCOPE },
+    { "glBlendFunc",                BLEND_FUNC_GROUP,           0, NO_SCOPE },
+    { "glBlendFuncSeparate",        BLEND_FUNC_GROUP,           0, NO_SCOPE },
+    { "glBlendEquation",            BLEND_EQUATION_GROUP,       0, NO_SCOPE },
+    { "glBlendEquationSeparate",    BLEND_EQUATION_GROUP,       0, NO_SCOPE },
+    { "glBlendColor",               BLEND_COLOR_GROUP,          0, NO_SCOPE },
+    { "glDepthFunc",                DEPTH_FUNC_GROUP,           0, NO_SCOPE },
+    { "glDepthMask",                DEPTH_MASK_GROUP,           0, NO_SCOPE },
+    { "glDepthRange",               DEPTH_RANGE_GROUP,          0, NO_SCOPE },
+    { "glDepthRangef",              DEPTH_RANGE_GROUP,          0, NO_SCOPE },
+    { "glColorMask",                COLOR_MASK_GROUP,           0, NO_SCOPE },
+    { "glStencilFunc",              STENCIL_FUNC_GROUP,         0, NO_SCOPE },
+    { "glStencilFuncSeparate",      STENCIL_FUNC_GROUP,         0, NO_SCOPE },
+    { "glStencilOp",                STENCIL_OP_GROUP,           0, NO_SCOPE },
+    { "glStencilOpSeparate",        STENCIL_OP_GROUP,           0, NO_SCOPE },
+    { "glStencilMask",              STENCIL_MASK_GROUP,         0, NO_SCOPE },
+    { "glStencilMaskSeparate",      STENCIL_MASK_GROUP,         0, NO_SCOPE },
+    { "glCullFace",                 CULL_FACE_GROUP,            0, NO_SCOPE },
+    { "glFrontFace",                FRONT_FACE_GROUP,           0, NO_SCOPE },
+    { "glPolygonMode",              POLYGON_MODE_GROUP,         0, NO_SCOPE },
+    { "glPolygonOffset",            POLYGON_OFFSET_GROUP,       0, NO_SCOPE },
+    { "glLineWidth",                LINE_WIDTH_GROUP,           0, NO_SCOPE },
+    { "glPointSize",                POINT_SIZE_GROUP,           0, NO_SCOPE },
+    { "glProvokingVertex",          PROVOKING_VERTEX_GROUP,     0, NO_SCOPE },
+    { "glPixelStorei",              PIXEL_STORE_GROUP,          1, NO_SCOPE },
+    { "glPixelStoref",              PIXEL_STORE_GROUP,          1, NO_SCOPE },
+    { "glPatchParameteri",          PATCH_PARAMETER_GROUP,      1, NO_SCOPE },
+    { "glPrimitiveRestartIndex",    PRIMITIVE_RESTART_GROUP,    0, NO_SCOPE },
+    { "glEnableVertexAttribArray",  ATTRIBUTE_ARRAY_GROUP,      1, VERTEX_ARRAY_SCOPE },
+    { "glDisableVertexAttribArray", ATTRIBUTE_ARRAY_GROUP,      1, VERTEX_ARRAY_SCOPE },
+    { "glVertexAttribDivisor",      ATTRIBUTE_DIVISOR_GROUP,    1, VERTEX_ARRAY_SCOPE },
+    { "glVertexAttribFormat",       ATTRIBUTE_FORMAT_GROUP,     1, VERTEX_ARRAY_SCOPE },
+    { "glVertexAttribIFormat",      ATTRIBUTE_FORMAT_GROUP,     1, VERTEX_ARRAY_SCOPE },
+    { "glVertexAttribLFormat",      ATTRIBUTE_FORMAT_GROUP,     1, VERTEX_ARRAY_SCOPE },
+    { "glVertexAttribBinding",      ATTRIBUTE_BINDING_GROUP,    1, VERTEX_ARRAY_SCOPE },
+    { "glBindVertexBuffer",         VERTEX_BUFFER_GROUP,        1, VERTEX_ARRAY_SCOPE },
+    { "glVertexBindingDivisor",     BINDING_DIVISOR_GROUP,      1, VERTEX_ARRAY_SCOPE },
+};
+
+// Calls that set attribute slots of a vertex array on the side, for the attribute or binding
+// index after the vertex array they name or as their first argument: glVertexAttribPointer is
+// a format, an attribute binding and a vertex buffer, glVertexAttribDivisor a binding and its
+// divisor. The element buffer of glVertexArrayElementBuffer is the one slot not by index.
+struct AttributeCall {
+    const char  *name;
+    bool        names_array;
+    StateGroup  overwrites[4];
+};
+
+const AttributeCall ATTRIBUTE_CALLS[] = {
+    { "glVertexAttribPointer",          false,  { ATTRIBUTE_FORMAT_GROUP, ATTRIBUTE_BINDING_GROUP, VERTEX_BUFFER_GROUP,
+                                                  ATTRIBUTE_DIVISOR_GROUP } },
+    { "glVertexAttribIPointer",         false,  { ATTRIBUTE_FORMAT_GROUP, ATTRIBUTE_BINDING_GROUP, VERTEX_BUFFER_GROUP,
+                                                  ATTRIBUTE_DIVISOR_GROUP } },
+    { "glVertexAttribLPointer",         false,  { ATTRIBUTE_FORMAT_GROUP, ATTRIBUTE_BINDING_GROUP, VERTEX_BUFFER_GROUP,
+                                                  ATTRIBUTE_DIVISOR_GROUP } },
+    { "glVertexAttribDivisor",          false,  { ATTRIBUTE_BINDING_GROUP, BINDING_DIVISOR_GROUP } },
+    { "glVertexAttribBinding",          false,  { ATTRIBUTE_DIVISOR_GROUP } },
+    { "glVertexBindingDivisor",         false,  { ATTRIBUTE_DIVISOR_GROUP } },
+    { "glEnableVertexArrayAttrib",      true,   { ATTRIBUTE_ARRAY_GROUP } },
+    { "glDisableVertexArrayAttrib",     true,   { ATTRIBUTE_ARRAY_GROUP } },
+    { "glVertexArrayAttribFormat",      true,   { ATTRIBUTE_FORMAT_GROUP } },
+    { "glVertexArrayAttribIFormat",     true,   { ATTRIBUTE_FORMAT_GROUP } },
+    { "glVertexArrayAttribLFormat",     true,   { ATTRIBUTE_FORMAT_GROUP } },
+    { "glVertexArrayAttribBinding",     true,   { ATTRIBUTE_BINDING_GROUP, ATTRIBUTE_DIVISOR_GROUP } },
+    { "glVertexArrayVertexBuffer",      true,   { VERTEX_BUFFER_GROUP } },
+    { "glVertexArrayBindingDivisor",    true,   { BINDING_DIVISOR_GROUP, ATTRIBUTE_DIVISOR_GROUP } },
+    { "glVertexArrayElementBuffer",     true,   { BUFFER_GROUP } },
+};
+
+// Calls that change what other calls mean: deleted names come back, relinked programs lose
+// their uniforms, and the multi-binds set slots no single call describes.
+const char *RESET_CALLS[] = {
+    "glLinkProgram", "glBindTextureUnit", "glBindTextures", "glBindSamplers", "glBindImageTextures",
+    "glBindBuffersBase", "glBindBuffersRange", "glBindVertexBuffers", "glVertexArrayVertexBuffers",
+};
+
+enum EntryPoint : size_t {
+#define OPENGL_ENTRY_ID(name) ENTRY_##name,
+    OPENGL_GL_ENTRY_POINTS(OPENGL_ENTRY_ID)
+#undef OPENGL_ENTRY_ID
+    ENTRY_COUNT
+};
+
+const char *ENTRY_NAMES[] = {
+#define OPENGL_ENTRY_NAME(name) #name,
+    OPENGL_GL_ENTRY_POINTS(OPENGL_ENTRY_NAME)
+#undef OPENGL_ENTRY_NAME
+};
+
+// The instrument the hooks count into, set by install().
+GLInstrument *s_installed = nullptr;
+
+template <typename T>
+inline uint64_t
+argumentBits(T value) {
+    if constexpr (std::is_same<T, float>::value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    } else if constexpr (std::is_same<T, double>::value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    } else if constexpr (std::is_pointer<T>::value) {
+        return (uint64_t)(uintptr_t)value;
+    } else {
+        return (uint64_t)value;
+    }
+}
+
+// The clock on both sides of the call, and the errors it left.
+class CallTimer {
+    size_t                                  entry_;
+    std::chrono::steady_clock::time_point   begin_;
+
+public:
+    explicit CallTimer(size_t entry) : entry_(entry), begin_(std::chrono::steady_clock::now()) {}
+    ~CallTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin_).count();
+        s_installed->called(entry_, (uint64_t)ns);
+        if (s_installed->checkErrors() && entry_ != ENTRY_glGetError)
+            s_installed->checkError(entry_);
+    }
+};
+
+// The hook of entry point ID, whose glad pointer has the type F.
+template <size_t ID, typename F>
+struct Hook;
+
+template <size_t ID, typename R, typename... A>
+struct Hook<ID, R (APIENTRYP)(A...)> {
+    static R (APIENTRYP loaded)(A...);
+
+    static R APIENTRY call(A... arguments) {
+        if (s_installed->stateCall(ID)) {
+            const uint64_t bits[] = { argumentBits(arguments)..., 0 };
+            s_installed->setState(ID, bits, sizeof...(A));
+        }
+        CallTimer timer(ID);
+        return loaded(arguments...);
+    }
+
+    static bool install(R (APIENTRYP &pointer)(A...)) {
+        if (!pointer)
+            return false;
+        if (pointer != &call)
+            loaded = pointer;
+        pointer = &call;
+        return true;
+    }
+
+    static void uninstall(R (APIENTRYP &pointer)(A...)) {
+        if (pointer == &call)
+            pointer = loaded;
+    }
+};
+
+template <size_t ID, typename R, typename... A>
+R (APIENTRYP Hook<ID, R (APIENTRYP)(A...)>::loaded)(A...) = nullptr;
+
+}
+
+#endif
+
+bool
+GLInstrument::available() {
+#ifdef OPENGL_GL_INSTRUMENT
+    return true;
+#else
+    return false;
+#endif
+}
+
+void
+GLInstrument::describeEntries() {
+#ifdef OPENGL_GL_INSTRUMENT
+    entries_.assign(ENTRY_COUNT, Entry());
+    for (size_t i = 0; i < ENTRY_COUNT; i++) {
+        Entry &entry = entries_[i];
+        entry.name = ENTRY_NAMES[i];
+        // sync objects and queries are never bound, deleting them leaves every slot as it was
+        entry.resets = strncmp(entry.name, "glDelete", 8) == 0 && strcmp(entry.name, "glDeleteSync") != 0 &&
+                       strcmp(entry.name, "glDeleteQueries") != 0;
+        for (const char *name : RESET_CALLS)
+            entry.resets = entry.resets || strcmp(entry.name, name) == 0;
+        for (const StateCall &state : STATE_CALLS) {
+            if (strcmp(entry.name, state.name) != 0)
+                continue;
+            entry.group = state.group;
+            entry.key_arguments = state.key_arguments;
+            entry.scope = state.scope;
+        }
+        for (const AttributeCall &attribute : ATTRIBUTE_CALLS) {
+            if (strcmp(entry.name, attribute.name) != 0)
+                continue;
+            entry.names_array = attribute.names_array;
+            for (size_t k = 0; k < 4; k++)
+                entry.overwrites[k] = attribute.overwrites[k];
+        }
+        // glUniform{1234}{f,i,ui,d} of the program in use and glProgramUniform* of the one
+        // named, the vector and matrix forms read memory and are left out
+        for (const char *prefix : { "glUniform", "glProgramUniform" }) {
+            for (const char *type : { "f", "i", "ui", "d" }) {
+                for (int size = 1; size <= 4; size++) {
+                    if (std::string(prefix) + std::to_string(size) + type != entry.name)
+                        continue;
+                    bool program = prefix[2] == 'P';
+                    entry.group = UNIFORM_GROUP;
+                    entry.key_arguments = program ? 2 : 1;
+                    entry.scope = program ? ARGUMENT_SCOPE : PROGRAM_SCOPE;
+                }
+            }
+        }
+    }
+    entries_[ENTRY_glBindVertexArray].sets_scope = VERTEX_ARRAY_SCOPE;
+    entries_[ENTRY_glActiveTexture].sets_scope = TEXTURE_UNIT_SCOPE;
+    entries_[ENTRY_glUseProgram].sets_scope = PROGRAM_SCOPE;
+    entries_[ENTRY_glBindBufferBase].binds_target = true;
+    entries_[ENTRY_glBindBufferRange].binds_target = true;
+#endif
+}
+
+bool
+GLInstrument::install(bool check_errors) {
+#ifdef OPENGL_GL_INSTRUMENT
+    if (entries_.empty())
+        describeEntries();
+    s_installed = this;
+    check_errors_ = check_errors;
+    size_t hooked = 0;
+#define OPENGL_HOOK(name) hooked += Hook<ENTRY_##name, decltype(glad_##name)>::install(glad_##name) ? 1 : 0;
+    OPENGL_GL_ENTRY_POINTS(OPENGL_HOOK)
+#undef OPENGL_HOOK
+    installed_ = true;
+    resetState();
+    fprintf(stdout, "[Info] GL instrument: %zu of %zu entry points hooked%s\n", hooked, (size_t)ENTRY_COUNT,
+            check_errors ? ", glGetError() after every call" : "");
+    return true;
+#else
+    (void)check_errors;
+    fprintf(stdout, "[Error] Built without OPENGL_GL_INSTRUMENT, no GL call counts\n");
+    return false;
+#endif
+}
+
+void
+GLInstrument::uninstall() {
+#ifdef OPENGL_GL_INSTRUMENT
+    if (!installed_)
+        return;
+#define OPENGL_UNHOOK(name) Hook<ENTRY_##name, decltype(glad_##name)>::uninstall(glad_##name);
+    OPENGL_GL_ENTRY_POINTS(OPENGL_UNHOOK)
+#undef OPENGL_UNHOOK
+    installed_ = false;
+#endif
+}
+
+void
+GLInstrument::resetState() {
+    slots_.clear();
+    // values no bind gives, so a slot set before the scope is known only matches under the same unknown scope
+    resets_++;
+    for (size_t i = 0; i < SCOPE_COUNT; i++)
+        scopes_[i] = mix(resets_, i) | (1ull << 63);
+}
+
+void
+GLInstrument::setState(size_t entry, const uint64_t *arguments, size_t count) {
+    Entry &call = entries_[entry];
+    if (call.overwrites[0]) {
+        uint64_t vertex_array = call.names_array ? arguments[0] : scopes_[VERTEX_ARRAY_SCOPE];
+        uint64_t index = call.names_array ? arguments[1] : arguments[0];
+        for (uint8_t group : call.overwrites) {
+            if (group)
+                slots_.erase(mix(mix(group, vertex_array), group == BUFFER_GROUP ? GL_ELEMENT_ARRAY_BUFFER : index));
+        }
+        if (!call.group)
+            return;
+    }
+    const uint64_t *key = arguments;
+    size_t key_count = call.key_arguments;
+    uint64_t scope = 0;
+    switch (call.scope) {
+    case NO_SCOPE:
+        break;
+    case ELEMENT_BUFFER_SCOPE:
+        scope = arguments[0] == GL_ELEMENT_ARRAY_BUFFER ? scopes_[VERTEX_ARRAY_SCOPE] : 0;
+        break;
+    case ARGUMENT_SCOPE:
+        scope = arguments[0];
+        key++;
+        key_count--;
+        break;
+    default:
+        scope = scopes_[call.scope];
+        break;
+    }
+    uint64_t slot = mix(call.group, scope);
+    for (size_t i = 0; i < key_count; i++)
+        slot = mix(slot, key[i]);
+    // the entry and every argument, so glEnable and glDisable of a capability differ
+    uint64_t value = entry;
+    for (size_t i = 0; i < count; i++)
+        value = mix(value, arguments[i]);
+
+    auto found = slots_.find(slot);
+    if (found == slots_.end())
+        slots_.emplace(slot, value);
+    else if (found->second == value)
+        call.redundant++;
+    else
+        found->second = value;
+
+    if (call.sets_scope)
+        scopes_[call.sets_scope] = arguments[0];
+    // glBindBufferBase and glBindBufferRange bind the target as well, to what no glBindBuffer matches
+    if (call.binds_target)
+        slots_[mix(mix(BUFFER_GROUP, 0), arguments[0])] = value;
+}
+
+void
+GLInstrument::called(size_t entry, uint64_t ns) {
+    Entry &call = entries_[entry];
+    call.calls++;
+    call.ns += ns;
+    frame_calls_++;
+    if (call.resets)
+        resetState();
+}
+
+void
+GLInstrument::checkError(size_t entry) {
+#ifdef OPENGL_GL_INSTRUMENT
+    auto get_error = Hook<ENTRY_glGetError, decltype(glad_glGetError)>::loaded;
+    // a context can hold several errors, each flag is cleared as it is read
+    for (int i = 0; i < 8; i++) {
+        GLenum error = get_error();
+        if (error == GL_NO_ERROR)
+            return;
+        entries_[entry].errors++;
+        if (errors_logged_ < MAX_ERRORS_LOGGED) {
+            fprintf(stdout, "[Error] %s: GL error 0x%04x in frame %llu%s\n", entries_[entry].name, error,
+                    (unsigned long long)frames_,
+                    ++errors_logged_ == MAX_ERRORS_LOGGED ? ", no more errors logged" : "");
+        }
+    }
+#else
+    (void)entry;
+#endif
+}
+
+void
+GLInstrument::endFrame() {
+    if (!installed_)
+        return;
+    frames_++;
+    last_frame_calls_ = frame_calls_;
+    frame_calls_ = 0;
+}
+
+std::vector<GLCallStats>
+GLInstrument::stats() const {
+    std::vector<GLCallStats> result;
+    for (auto &entry : entries_) {
+        if (entry.calls)
+            result.push_back({ entry.name, entry.calls, entry.ns, entry.redundant, entry.errors });
+    }
+    std::sort(result.begin(), result.end(), [](const GLCallStats &a, const GLCallStats &b) { return a.ns > b.ns; });
+    return result;
+}
+
+void
+GLInstrument::clear() {
+    for (auto &entry : entries_)
+        entry.calls = entry.ns = entry.redundant = entry.errors = 0;
+    frames_ = 0;
+    frame_calls_ = 0;
+    last_frame_calls_ = 0;
+    errors_logged_ = 0;
+    resetState();
+}
+
+void
+GLInstrument::forget() {
+    installed_ = false;
+    clear();
+}
+
+void
+GLInstrument::report(size_t top) const {
+    if (!installed_)
+        return;
+    std::vector<GLCallStats> calls = stats();
+    double frames = (double)std::max<uint64_t>(frames_, 1);
+    uint64_t total_calls = 0, total_ns = 0, redundant = 0, errors = 0;
+    for (auto &call : calls) {
+        total_calls += call.calls;
+        total_ns += call.ns;
+        redundant += call.redundant;
+        errors += call.errors;
+    }
+    fprintf(stdout, "[Info] GL calls: %.1f per frame over %llu frames, %.3f ms in the driver per frame, "
+                    "%.1f redundant state calls per frame, %llu errors\n",
+            total_calls / frames, (unsigned long long)frames_, total_ns * 1e-6 / frames, redundant / frames,
+            (unsigned long long)errors);
+    fprintf(stdout, "[Info]   %-32s %11s %11s %10s %15s %7s\n", "entry point", "calls/frame", "ns/call", "ms/frame",
+            "redundant/frame", "errors");
+    for (size_t i = 0; i < calls.size() && i < top; i++) {
+        const GLCallStats &call = calls[i];
+        fprintf(stdout, "[Info]   %-32s %11.1f %11.1f %10.4f %15.1f %7llu\n", call.name, call.calls / frames,
+                (double)call.ns / call.calls, call.ns * 1e-6 / frames, call.redundant / frames,
+                (unsigned long long)call.errors);
+    }
+}
+
+}
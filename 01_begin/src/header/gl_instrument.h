@@ -0,0 +1,135 @@
+/**
+ * @file gl_instrument.h
+ * @author l1ang70
+ * @brief GL calls counted, timed and checked per entry point, by hooks swapped into the glad function pointers
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_GL_INSTRUMENT_H_
+#define _OPENGL_GL_INSTRUMENT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace opengl {
+
+// The calls of one GL entry point since the instrument was installed.
+struct GLCallStats {
+    const char  *name;
+    uint64_t    calls;
+    uint64_t    ns;             // CPU time inside the driver
+    uint64_t    redundant;      // state calls that set what was already set
+    uint64_t    errors;
+};
+
+// Where the CPU time spent in the driver goes. glad calls every GL function through a pointer,
+// glad_glDrawElements behind glDrawElements, so install() puts a hook in front of each pointer
+// of the GL 1.0 to 4.6 entry points (gl_entry_points.h) that is loaded. The hook counts the
+// call for its entry point and its frame, and takes the steady clock on both sides of the call.
+// With check errors, it also drains glGetError() after every call and logs what it finds,
+// which leaves nothing for the sample's own glGetError() calls.
+//
+// State calls are checked for redundancy. The binds, enables, fixed-function state and scalar
+// uniforms each fill a slot keyed by their target, index or location, and by the vertex array,
+// texture unit or program they apply to. A call that leaves its slot as it was counts as
+// redundant. glVertexAttribPointer and the glVertexArray* calls set attribute slots of a vertex
+// array on the side, they forget the slots they change. The glDelete* calls and glLinkProgram
+// forget every slot, because names and uniforms can come back meaning something else. Calls
+// through pointers, uniform arrays and vertex attribute pointers, are never called redundant.
+//
+// The hooks only exist in a build with OPENGL_GL_INSTRUMENT (the opengl_gl_instrument CMake
+// option). Without it install() fails and the loader is left alone. The Context installs
+// the instrument for --gl-calls or --gl-check-errors, and report() logs the hottest entry points.
+class GLInstrument {
+    // What the hook of an entry point does around its call, and what it counted.
+    struct Entry {
+        const char  *name           = nullptr;
+        uint8_t     group           = 0;        // slot family of a state call, 0 for any other call
+        uint8_t     key_arguments   = 0;        // leading arguments that pick the slot
+        uint8_t     scope           = 0;        // binding the slot belongs to
+        uint8_t     sets_scope      = 0;        // binding the call changes
+        bool        binds_target    = false;    // an indexed bind, which also binds the target
+        uint8_t     overwrites[4]   = {};       // attribute slot families the call sets on the side, by index
+        bool        names_array     = false;    // the vertex array is the first argument, not the bound one
+        bool        resets          = false;    // forgets every slot
+        uint64_t    calls           = 0;
+        uint64_t    ns              = 0;
+        uint64_t    redundant       = 0;
+        uint64_t    errors          = 0;
+    };
+
+    constexpr static size_t     SCOPE_COUNT     = 4;
+
+    bool                                    installed_          = false;
+    bool                                    check_errors_       = false;
+    std::vector<Entry>                      entries_;
+    std::unordered_map<uint64_t, uint64_t>  slots_;                     // key of a state slot to its value
+    uint64_t                                scopes_[SCOPE_COUNT]    = {};
+    uint64_t                                resets_             = 0;
+    uint64_t                                frames_             = 0;
+    uint64_t                                frame_calls_        = 0;
+    uint64_t                                last_frame_calls_   = 0;
+    uint64_t                                errors_logged_      = 0;
+
+private:
+    GLInstrument() = default;
+
+    // Describe every entry point, the state calls with their slots.
+    void describeEntries();
+
+    // Forget the slots, and what is bound: until bound again, every scope is a value of its own.
+    void resetState();
+
+public:
+    constexpr static uint64_t   MAX_ERRORS_LOGGED   = 32;
+
+    // The instrument of the current context, one instance as for RenderState.
+    static GLInstrument& current();
+
+    GLInstrument(const GLInstrument&) = delete;
+    GLInstrument& operator=(const GLInstrument&) = delete;
+
+    // Built with OPENGL_GL_INSTRUMENT, so install() can work.
+    static bool available();
+
+    // Hook every loaded entry point, after glad loads them. Returns false without OPENGL_GL_INSTRUMENT.
+    bool install(bool check_errors = false);
+    // Put the loaded pointers back.
+    void uninstall();
+    inline bool installed() const { return installed_; }
+    inline bool checkErrors() const { return check_errors_; }
+
+    // For the hooks: whether entry is a state call, then its arguments as bits before the call,
+    // which counts it when redundant, and after the call its time and errors.
+    inline bool stateCall(size_t entry) const { return entries_[entry].group != 0 || entries_[entry].overwrites[0] != 0; }
+    void setState(size_t entry, const uint64_t *arguments, size_t count);
+    void called(size_t entry, uint64_t ns);
+    void checkError(size_t entry);
+
+    // Close the frame, for the calls per frame.
+    void endFrame();
+
+    // The entry points called at least once, most time first.
+    std::vector<GLCallStats> stats() const;
+    inline uint64_t frames() const { return frames_; }
+    inline uint64_t lastFrameCalls() const { return last_frame_calls_; }
+
+    // Zero the counts and forget the state slots.
+    void clear();
+
+    // Forget the hooks, counts and slots, for a new context whose glad pointers were loaded again.
+    void forget();
+
+    // Print the calls per frame, driver time, redundant calls and errors, then the top entry points, to stdout.
+    void report(size_t top = 20) const;
+};
+
+}
+
+#endif // !_OPENGL_GL_INSTRUMENT_H_
@@ -0,0 +1,197 @@
+#include "gpu_profiler.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace opengl {
+
+GpuProfiler&
+GpuProfiler::current() {
+    static GpuProfiler s_profiler;
+    return s_profiler;
+}
+
+bool
+GpuProfiler::supported() {
+    return GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query;
+}
+
+void
+GpuProfiler::setEnabled(bool enabled) {
+    if (enabled && !supported()) {
+        fprintf(stdout, "[Error] Timer queries are not supported, no GPU profile\n");
+        enabled = false;
+    }
+    if (enabled && frames_.empty())
+        frames_.resize(FRAME_LATENCY);
+    enabled_ = enabled;
+}
+
+uint32_t
+GpuProfiler::findScope(const char *name, uint32_t parent) {
+    for (uint32_t i = 0; i < scopes_.size(); i++) {
+        if (scopes_[i].parent == parent && scopes_[i].name == name)
+            return i;
+    }
+    Scope scope;
+    scope.name = name;
+    scope.parent = parent;
+    scope.depth = parent == NO_SCOPE ? 0 : scopes_[parent].depth + 1;
+    scope.samples.resize(WINDOW);
+    scopes_.push_back(scope);
+    return (uint32_t)scopes_.size() - 1;
+}
+
+uint32_t
+GpuProfiler::query(Frame &frame) {
+    // the pool grows to the most queries a frame has needed and stays there
+    if (frame.used == frame.queries.size()) {
+        size_t grown = std::max<size_t>(frame.queries.size() * 2, 16);
+        frame.queries.resize(grown, 0);
+        glGenQueries((GLsizei)(grown - frame.used), frame.queries.data() + frame.used);
+    }
+    glQueryCounter(frame.queries[frame.used], GL_TIMESTAMP);
+    return (uint32_t)frame.used++;
+}
+
+void
+GpuProfiler::begin(const char *name) {
+    if (!enabled_)
+        return;
+    Frame &frame = frames_[frame_];
+    uint32_t parent = open_.empty() ? NO_SCOPE : frame.records[open_.back()].scope;
+    Record record = { findScope(name, parent), query(frame), 0 };
+    open_.push_back((uint32_t)frame.records.size());
+    frame.records.push_back(record);
+}
+
+void
+GpuProfiler::end() {
+    if (!enabled_ || open_.empty())
+        return;
+    Frame &frame = frames_[frame_];
+    frame.records[open_.back()].end = query(frame);
+    open_.pop_back();
+}
+
+void
+GpuProfiler::endFrame() {
+    if (!enabled_)
+        return;
+    // a scope left open is dropped with its frame rather than ended in the next
+    Frame &frame = frames_[frame_];
+    if (!open_.empty()) {
+        frame.records.resize(open_.front());
+        open_.clear();
+    }
+    frame.pending = !frame.records.empty();
+    frame_ = (frame_ + 1) % frames_.size();
+    resolve(frames_[frame_]);
+}
+
+void
+GpuProfiler::resolve(Frame &frame) {
+    if (frame.pending) {
+        // queries complete in order, when the last is there so is every other
+        GLuint available = 0;
+        glGetQueryObjectuiv(frame.queries[frame.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            dropped_++;
+        } else {
+            std::vector<GLuint64> times(frame.used);
+            for (size_t i = 0; i < frame.used; i++)
+                glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &times[i]);
+            frame_totals_.assign(scopes_.size(), -1.0);
+            for (auto &record : frame.records) {
+                double ms = times[record.end] > times[record.begin] ? (times[record.end] - times[record.begin]) * 1e-6 : 0.0;
+                double &total = frame_totals_[record.scope];
+                total = total < 0.0 ? ms : total + ms;
+            }
+            for (size_t i = 0; i < scopes_.size(); i++) {
+                if (frame_totals_[i] < 0.0)
+                    continue;
+                Scope &scope = scopes_[i];
+                scope.samples[scope.next] = (float)frame_totals_[i];
+                scope.next = (scope.next + 1) % WINDOW;
+                scope.count = std::min(scope.count + 1, WINDOW);
+            }
+            resolved_++;
+        }
+    }
+    frame.used = 0;
+    frame.records.clear();
+    frame.pending = false;
+}
+
+std::vector<GpuScopeStats>
+GpuProfiler::stats() const {
+    std::vector<GpuScopeStats> result;
+    std::vector<float> sorted;
+    // depth first from the roots, children in the order they first ran
+    std::vector<uint32_t> stack;
+    for (uint32_t i = (uint32_t)scopes_.size(); i-- > 0;) {
+        if (scopes_[i].parent == NO_SCOPE)
+            stack.push_back(i);
+    }
+    while (!stack.empty()) {
+        uint32_t index = stack.back();
+        stack.pop_back();
+        for (uint32_t i = (uint32_t)scopes_.size(); i-- > 0;) {
+            if (scopes_[i].parent == index)
+                stack.push_back(i);
+        }
+        const Scope &scope = scopes_[index];
+        GpuScopeStats stats = { scope.name, scope.depth, scope.count, 0.0, 0.0, 0.0 };
+        if (scope.count > 0) {
+            sorted.assign(scope.samples.begin(), scope.samples.begin() + scope.count);
+            std::sort(sorted.begin(), sorted.end());
+            double sum = 0.0;
+            for (float sample : sorted)
+                sum += sample;
+            stats.min_ms = sorted.front();
+            stats.average_ms = sum / sorted.size();
+            stats.p99_ms = sorted[(size_t)std::ceil(0.99 * sorted.size()) - 1];
+        }
+        result.push_back(stats);
+    }
+    return result;
+}
+
+void
+GpuProfiler::clear() {
+    for (auto &frame : frames_) {
+        if (!frame.queries.empty())
+            glDeleteQueries((GLsizei)frame.queries.size(), frame.queries.data());
+    }
+    forget();
+}
+
+void
+GpuProfiler::forget() {
+    for (auto &frame : frames_)
+        frame = Frame();
+    frame_ = 0;
+    scopes_.clear();
+    open_.clear();
+    resolved_ = 0;
+    dropped_ = 0;
+}
+
+void
+GpuProfiler::report() const {
+    if (!enabled_)
+        return;
+    fprintf(stdout, "[Info] GPU profile: %llu frames resolved, %llu dropped waiting on queries, ms per frame over the last %zu\n",
+            (unsigned long long)resolved_, (unsigned long long)dropped_, WINDOW);
+    for (auto &scope : stats()) {
+        int indent = 2 * scope.depth;
+        fprintf(stdout, "[Info]   %*s%-*s min %8.3f  avg %8.3f  p99 %8.3f  (%zu frames)\n", indent, "",
+                std::max(24 - indent, 1), scope.name.c_str(), scope.min_ms, scope.average_ms, scope.p99_ms,
+                scope.frames);
+    }
+}
+
+}
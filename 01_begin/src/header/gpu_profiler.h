@@ -0,0 +1,133 @@
+/**
+ * @file gpu_profiler.h
+ * @author l1ang70
+ * @brief GPU time of nested scopes from timestamp queries, read back frames later without stalling
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_GPU_PROFILER_H_
+#define _OPENGL_GPU_PROFILER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace opengl {
+
+// GPU time of one scope over the window, in milliseconds per frame.
+struct GpuScopeStats {
+    std::string     name;
+    int             depth;
+    size_t          frames;     // samples in the window
+    double          min_ms;
+    double          average_ms;
+    double          p99_ms;
+};
+
+// Where the GPU time of a frame goes. begin() and end() put a GL_TIMESTAMP query on each side
+// of a scope, timestamps rather than GL_TIME_ELAPSED because those can not nest. Each frame
+// has its own pool of queries in a ring of FRAME_LATENCY frames; endFrame() reads back the
+// frame that ran FRAME_LATENCY frames ago, long done on the GPU, so the CPU never waits on a
+// query. Should its results still not be there, the frame is dropped rather than waited for.
+//
+// A scope is its name under its parent, so "draw" inside "shadows" and inside "lighting" are
+// two. Its time in a frame is the sum of every time it ran in that frame, and the last
+// WINDOW frames of it give the min, average and 99th percentile.
+//
+// Off unless enabled, then begin() and end() are a branch each. The Context enables it for
+// --gpu-profile and brackets its swap with a "swap" scope.
+class GpuProfiler {
+    struct Scope {
+        std::string         name;
+        uint32_t            parent;
+        int                 depth;
+        std::vector<float>  samples;    // ring of WINDOW frame times in ms
+        size_t              next        = 0;
+        size_t              count       = 0;
+    };
+
+    struct Record {
+        uint32_t            scope;
+        uint32_t            begin;      // query indices in the pool of the frame
+        uint32_t            end;
+    };
+
+    struct Frame {
+        std::vector<unsigned int>   queries;
+        size_t                      used        = 0;
+        std::vector<Record>         records;
+        bool                        pending     = false;
+    };
+
+    bool                    enabled_            = false;
+    std::vector<Frame>      frames_;
+    size_t                  frame_              = 0;    // the frame being recorded
+    std::vector<Scope>      scopes_;
+    std::vector<uint32_t>   open_;                      // records of the scopes begun and not ended
+    std::vector<double>     frame_totals_;              // per scope, while resolving a frame
+    uint64_t                resolved_           = 0;
+    uint64_t                dropped_            = 0;
+
+private:
+    GpuProfiler() = default;
+
+    uint32_t findScope(const char *name, uint32_t parent);
+    uint32_t query(Frame &frame);
+    void resolve(Frame &frame);
+
+public:
+    constexpr static size_t     FRAME_LATENCY   = 4;
+    constexpr static size_t     WINDOW          = 240;
+    constexpr static uint32_t   NO_SCOPE        = 0xffffffffu;
+
+    // The profiler of the current context, one instance as for RenderState.
+    static GpuProfiler& current();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // Timestamp queries, core since GL 3.3.
+    static bool supported();
+
+    void setEnabled(bool enabled);
+    inline bool enabled() const { return enabled_; }
+
+    // Open the scope name inside the one open.
+    void begin(const char *name);
+    // Close the scope opened last.
+    void end();
+
+    // Close the frame being recorded and resolve the one FRAME_LATENCY frames before it.
+    void endFrame();
+
+    // The scopes in tree order, with their statistics over the window.
+    std::vector<GpuScopeStats> stats() const;
+
+    // Delete the queries and forget every scope.
+    void clear();
+
+    // Forget everything without deleting, for a new context where the names mean nothing.
+    void forget();
+
+    // Print the tree of scopes with min, average and p99 GPU ms per frame to stdout.
+    void report() const;
+};
+
+// Scope of the current GpuProfiler for the lifetime of the object.
+class GpuScope {
+public:
+    explicit GpuScope(const char *name) { GpuProfiler::current().begin(name); }
+    ~GpuScope() { GpuProfiler::current().end(); }
+
+    GpuScope(const GpuScope&) = delete;
+    GpuScope& operator=(const GpuScope&) = delete;
+};
+
+}
+
+#endif // !_OPENGL_GPU_PROFILER_H_
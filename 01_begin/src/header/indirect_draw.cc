@@ -0,0 +1,90 @@
+#include "indirect_draw.h"
+#include "render_state.h"
+
+#include <glad/glad.h>
+
+#include <cstdio>
+
+namespace opengl {
+
+IndirectDrawList::IndirectDrawList(unsigned int bounds_buffer, unsigned int command_buffer, size_t draw_count, Program *cull_program)
+    : bounds_buffer_(bounds_buffer), command_buffer_(command_buffer), draw_count_(draw_count), cull_program_(cull_program),
+      draw_count_uniform_(cull_program->uniform<int>("draw_count")) {}
+
+bool
+IndirectDrawList::supported() {
+    // what the shaders declare: #version 430 core, and camera_indirect.vs requires
+    // GL_ARB_shader_draw_parameters for gl_DrawIDARB, even on a 4.6 context
+    return GLAD_GL_VERSION_4_3 && GLAD_GL_ARB_shader_draw_parameters;
+}
+
+IndirectDrawList*
+IndirectDrawList::create(const MeshArena &arena, const std::vector<uint32_t> &meshes,
+                         const std::vector<glm::vec4> &spheres, Program *cull_program) {
+    if (!supported()) {
+        fprintf(stdout, "[Error] Multi-draw indirect with gl_DrawID and compute shaders is not supported\n");
+        return nullptr;
+    }
+    if (!cull_program || meshes.empty() || meshes.size() != spheres.size())
+        return nullptr;
+
+    // the bounds carry the command of each draw, culling only has to choose its instance count
+    std::vector<DrawBounds> bounds(meshes.size());
+    std::vector<DrawCommand> commands(meshes.size());
+    for (size_t i = 0; i < meshes.size(); i++) {
+        if (!arena.contains(meshes[i]))
+            return nullptr;
+        MeshRange range = arena.mesh(meshes[i]);
+        bounds[i] = { spheres[i], range.index_count, range.first_index, range.base_vertex, 0 };
+        commands[i] = { range.index_count, 1, range.first_index, range.base_vertex, (uint32_t)i };
+    }
+
+    RenderState &state = RenderState::current();
+    GLuint buffers[2] = { 0, 0 };
+    glGenBuffers(2, buffers);
+    state.bindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[0]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bounds.size() * sizeof(DrawBounds), bounds.data(), GL_STATIC_DRAW);
+    // every draw visible until the first cull()
+    state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, buffers[1]);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawCommand), commands.data(), GL_DYNAMIC_COPY);
+    return new IndirectDrawList(buffers[0], buffers[1], meshes.size(), cull_program);
+}
+
+IndirectDrawList::~IndirectDrawList() {
+    RenderState &state = RenderState::current();
+    state.deleteBuffer(bounds_buffer_);
+    state.deleteBuffer(command_buffer_);
+}
+
+void
+IndirectDrawList::cull() {
+    RenderState &state = RenderState::current();
+    cull_program_->use();
+    cull_program_->set(draw_count_uniform_, (int)draw_count_);
+    state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_BOUNDS_BINDING, bounds_buffer_);
+    state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_COMMANDS_BINDING, command_buffer_);
+    glDispatchCompute((GLuint)((draw_count_ + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE), 1, 1);
+    // the draw reads the commands written above as indirect arguments
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+}
+
+void
+IndirectDrawList::draw(const MeshArena &arena) {
+    arena.bind();
+    RenderState::current().bindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer_);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, arena.indexType(), nullptr, (GLsizei)draw_count_, 0);
+}
+
+size_t
+IndirectDrawList::countVisible() const {
+    std::vector<DrawCommand> commands(draw_count_);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    RenderState::current().bindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer_);
+    glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(DrawCommand), commands.data());
+    size_t visible = 0;
+    for (auto &command : commands)
+        visible += command.instance_count != 0;
+    return visible;
+}
+
+}
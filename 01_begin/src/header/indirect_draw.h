@@ -0,0 +1,99 @@
+/**
+ * @file indirect_draw.h
+ * @author l1ang70
+ * @brief Meshes packed into shared buffers, drawn with one GPU-culled multi-draw indirect call
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_INDIRECT_DRAW_H_
+#define _OPENGL_INDIRECT_DRAW_H_
+
+#include "mesh_arena.h"
+#include "program.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace opengl {
+
+// Shader storage binding points of the indirect path, fixed in the shaders with layout(binding).
+enum StorageBinding : unsigned int {
+    DRAW_BOUNDS_BINDING     = 0,    // DrawBounds[], read by the cull shader
+    DRAW_COMMANDS_BINDING   = 1,    // DrawCommand[], written by the cull shader
+    DRAW_MODELS_BINDING     = 2     // mat4[], model matrix of each draw indexed by gl_DrawID
+};
+
+// Layout glMultiDrawElementsIndirect reads, one per draw.
+struct DrawCommand {
+    uint32_t    count;
+    uint32_t    instance_count;
+    uint32_t    first_index;
+    int32_t     base_vertex;
+    uint32_t    base_instance;
+};
+
+static_assert(sizeof(DrawCommand) == 20, "DrawCommand must match the GL indirect command layout");
+
+// std430 mirror of the per-draw input of cull_draws.cs: the bounding sphere and the command
+// the draw issues when it is visible.
+struct DrawBounds {
+    glm::vec4   sphere;         // xyz center, w radius
+    uint32_t    index_count;
+    uint32_t    first_index;
+    int32_t     base_vertex;
+    uint32_t    padding;
+};
+
+static_assert(sizeof(DrawBounds) == 32, "DrawBounds must match the std430 layout of cull_draws.cs");
+
+// A fixed list of draws, each one mesh of a MeshArena with a bounding sphere, submitted with a
+// single glMultiDrawElementsIndirect. A compute shader culls the spheres against the frustum
+// of the FrameData block and writes the command buffer, instance count 0 for culled draws,
+// so the CPU neither tests nor submits per draw. The vertex shader fetches its per-draw data
+// with gl_DrawID (GL 4.6 or ARB_shader_draw_parameters).
+class IndirectDrawList {
+    unsigned int    bounds_buffer_      = 0;
+    unsigned int    command_buffer_     = 0;
+    size_t          draw_count_         = 0;
+    Program         *cull_program_      = nullptr;  // not owned
+    Uniform<int>    draw_count_uniform_;
+
+private:
+    IndirectDrawList(unsigned int bounds_buffer, unsigned int command_buffer, size_t draw_count, Program *cull_program);
+
+public:
+    constexpr static unsigned int CULL_GROUP_SIZE = 64;    // local_size_x of cull_draws.cs
+
+    // GL 4.3 for compute shaders, shader storage and multi-draw indirect, with
+    // GL_ARB_shader_draw_parameters for gl_DrawIDARB.
+    static bool supported();
+
+    // Draw i is mesh meshes[i] of arena bounded by spheres[i]. cull_program is the linked
+    // cull_draws.cs, it must outlive the list. The commands hold the ranges of the meshes,
+    // the list is built again after the arena defragments.
+    static IndirectDrawList* create(const MeshArena &arena, const std::vector<uint32_t> &meshes,
+                                    const std::vector<glm::vec4> &spheres, Program *cull_program);
+
+    ~IndirectDrawList();
+
+    inline size_t drawCount() const { return draw_count_; }
+
+    // Rewrite the command buffer on the GPU from the frustum of the current FrameData.
+    void cull();
+
+    // Issue every draw with one call, the program reading gl_DrawID must be in use.
+    void draw(const MeshArena &arena);
+
+    // Read the command buffer back and count the visible draws. Waits for the GPU, for reports only.
+    size_t countVisible() const;
+};
+
+}
+
+#endif // !_OPENGL_INDIRECT_DRAW_H_
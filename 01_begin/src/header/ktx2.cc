@@ -0,0 +1,268 @@
+#include "ktx2.h"
+#include "mipmap.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace opengl {
+
+namespace {
+
+const uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+constexpr size_t HEADER_BYTES       = 80;   // identifier, header and index
+constexpr size_t LEVEL_INDEX_BYTES  = 24;   // byteOffset, byteLength, uncompressedByteLength
+
+// Data format descriptor color models and channels of the Khronos basic descriptor block.
+constexpr uint8_t DF_MODEL_BC1A     = 128;
+constexpr uint8_t DF_MODEL_BC3      = 130;
+constexpr uint8_t DF_MODEL_BC7      = 134;
+constexpr uint8_t DF_MODEL_ETC2     = 161;
+constexpr uint8_t DF_CHANNEL_COLOR  = 0;
+constexpr uint8_t DF_CHANNEL_ETC2_COLOR = 2;
+constexpr uint8_t DF_CHANNEL_ALPHA  = 15;
+constexpr uint8_t DF_SAMPLE_LINEAR  = 0x10;
+constexpr uint8_t DF_TRANSFER_LINEAR = 1;
+constexpr uint8_t DF_TRANSFER_SRGB  = 2;
+
+uint32_t
+vkFormat(CompressedFormat format, bool srgb) {
+    switch (format) {
+    case BC1:       return srgb ? 132 : 131;    // VK_FORMAT_BC1_RGB_{SRGB,UNORM}_BLOCK
+    case BC3:       return srgb ? 138 : 137;    // VK_FORMAT_BC3_{SRGB,UNORM}_BLOCK
+    case BC7:       return srgb ? 146 : 145;    // VK_FORMAT_BC7_{SRGB,UNORM}_BLOCK
+    case ETC2_RGB:  return srgb ? 148 : 147;    // VK_FORMAT_ETC2_R8G8B8_{SRGB,UNORM}_BLOCK
+    }
+    return 0;
+}
+
+bool
+fromVkFormat(uint32_t vk_format, CompressedFormat &format, bool &srgb) {
+    const CompressedFormat formats[] = { BC1, BC3, BC7, ETC2_RGB };
+    for (auto candidate : formats) {
+        for (int s = 0; s < 2; s++) {
+            if (vkFormat(candidate, s != 0) == vk_format) {
+                format = candidate;
+                srgb = s != 0;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+class Writer {
+    std::vector<uint8_t> &bytes_;
+
+public:
+    explicit Writer(std::vector<uint8_t> &bytes) : bytes_(bytes) {}
+
+    void u8(uint8_t value) { bytes_.push_back(value); }
+    void u16(uint16_t value) { u8((uint8_t)value); u8((uint8_t)(value >> 8)); }
+    void u32(uint32_t value) { u16((uint16_t)value); u16((uint16_t)(value >> 16)); }
+    void u64(uint64_t value) { u32((uint32_t)value); u32((uint32_t)(value >> 32)); }
+    void pad(size_t alignment) { while (bytes_.size() % alignment) u8(0); }
+};
+
+template <typename T>
+T
+read(const uint8_t *bytes, size_t offset) {
+    T value;
+    memcpy(&value, bytes + offset, sizeof(T));
+    return value;
+}
+
+// The basic descriptor block of the format, one sample per channel of the block.
+void
+writeDescriptor(Writer &writer, CompressedFormat format, bool srgb) {
+    struct Sample {
+        uint16_t    bit_offset;
+        uint8_t     bit_length;
+        uint8_t     channel;
+    };
+    uint8_t model = DF_MODEL_BC1A;
+    std::vector<Sample> samples;
+    switch (format) {
+    case BC1:
+        samples.push_back({ 0, 64, DF_CHANNEL_COLOR });
+        break;
+    case BC3:
+        model = DF_MODEL_BC3;
+        samples.push_back({ 0, 64, (uint8_t)(DF_CHANNEL_ALPHA | (srgb ? DF_SAMPLE_LINEAR : 0)) });
+        samples.push_back({ 64, 64, DF_CHANNEL_COLOR });
+        break;
+    case BC7:
+        model = DF_MODEL_BC7;
+        samples.push_back({ 0, 128, DF_CHANNEL_COLOR });
+        break;
+    case ETC2_RGB:
+        model = DF_MODEL_ETC2;
+        samples.push_back({ 0, 64, DF_CHANNEL_ETC2_COLOR });
+        break;
+    }
+
+    uint16_t block_size = (uint16_t)(24 + 16 * samples.size());
+    writer.u32(4 + block_size);             // dfdTotalSize
+    writer.u32(0);                          // vendorId, descriptorType
+    writer.u16(2);                          // versionNumber
+    writer.u16(block_size);
+    writer.u8(model);
+    writer.u8(1);                           // BT.709 primaries
+    writer.u8(srgb ? DF_TRANSFER_SRGB : DF_TRANSFER_LINEAR);
+    writer.u8(0);                           // straight alpha
+    writer.u32(3 | 3 << 8);                 // texel block dimensions minus one: 4x4x1x1
+    writer.u8((uint8_t)compressedBlockBytes(format));
+    for (int i = 1; i < 8; i++)
+        writer.u8(0);
+    for (auto &sample : samples) {
+        writer.u16(sample.bit_offset);
+        writer.u8((uint8_t)(sample.bit_length - 1));
+        writer.u8(sample.channel);
+        writer.u32(0);                      // sample position
+        writer.u32(0);                      // lower
+        writer.u32(0xFFFFFFFFu);            // upper
+    }
+}
+
+}
+
+Ktx2Image*
+Ktx2Image::open(const std::string &path) {
+    Ktx2Image *image = new Ktx2Image();
+    if (!image->parse(path)) {
+        delete image;
+        return nullptr;
+    }
+    return image;
+}
+
+Ktx2Image::~Ktx2Image() {
+    if (mapping_)
+        munmap(mapping_, mapping_size_);
+}
+
+bool
+Ktx2Image::parse(const std::string &path) {
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat status;
+    if (fstat(file, &status) == 0 && status.st_size > 0) {
+        mapping_size_ = (size_t)status.st_size;
+        mapping_ = mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping_ == MAP_FAILED)
+            mapping_ = nullptr;
+    }
+    // the mapping holds the file open
+    close(file);
+    if (!mapping_)
+        return false;
+
+    const uint8_t *bytes = (const uint8_t*)mapping_;
+    if (mapping_size_ < HEADER_BYTES || memcmp(bytes, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        fprintf(stdout, "[Error] Not a KTX2 file: %s\n", path.c_str());
+        return false;
+    }
+    uint32_t vk_format      = read<uint32_t>(bytes, 12);
+    width_                  = (int)read<uint32_t>(bytes, 20);
+    height_                 = (int)read<uint32_t>(bytes, 24);
+    uint32_t depth          = read<uint32_t>(bytes, 28);
+    uint32_t layers         = read<uint32_t>(bytes, 32);
+    uint32_t faces          = read<uint32_t>(bytes, 36);
+    uint32_t level_count    = std::max(1u, read<uint32_t>(bytes, 40));
+    uint32_t supercompression = read<uint32_t>(bytes, 44);
+    if (!fromVkFormat(vk_format, format_, srgb_) || depth > 0 || layers > 0 || faces != 1 || supercompression != 0 ||
+        width_ <= 0 || height_ <= 0) {
+        fprintf(stdout, "[Error] Unsupported KTX2 layout (format %u) in %s\n", vk_format, path.c_str());
+        return false;
+    }
+    if (level_count > (uint32_t)MipChain::fullLevelCount(width_, height_)) {
+        fprintf(stdout, "[Error] %u levels for %dx%d in KTX2 file: %s\n", level_count, width_, height_, path.c_str());
+        return false;
+    }
+    if (HEADER_BYTES + level_count * LEVEL_INDEX_BYTES > mapping_size_) {
+        fprintf(stdout, "[Error] Truncated KTX2 file: %s\n", path.c_str());
+        return false;
+    }
+
+    for (uint32_t i = 0; i < level_count; i++) {
+        size_t entry = HEADER_BYTES + i * LEVEL_INDEX_BYTES;
+        uint64_t offset = read<uint64_t>(bytes, entry);
+        uint64_t size = read<uint64_t>(bytes, entry + 8);
+        int width = std::max(1, width_ >> i);
+        int height = std::max(1, height_ >> i);
+        // written so that a huge offset or size cannot wrap around past the mapping
+        if (offset > mapping_size_ || size > mapping_size_ - offset || size != compressedSize(format_, width, height)) {
+            fprintf(stdout, "[Error] Bad level %u in KTX2 file: %s\n", i, path.c_str());
+            return false;
+        }
+        levels_.push_back({ bytes + offset, (size_t)size, width, height });
+    }
+    return true;
+}
+
+bool
+writeKtx2(const std::string &path, CompressedFormat format, bool srgb, int width, int height,
+          const std::vector<std::vector<uint8_t>> &levels) {
+    std::vector<uint8_t> descriptor;
+    Writer descriptor_writer(descriptor);
+    writeDescriptor(descriptor_writer, format, srgb);
+
+    // level data goes smallest first, each level on a block boundary
+    size_t descriptor_offset = HEADER_BYTES + levels.size() * LEVEL_INDEX_BYTES;
+    size_t alignment = compressedBlockBytes(format);
+    size_t data_offset = descriptor_offset + descriptor.size();
+    std::vector<uint64_t> offsets(levels.size());
+    for (size_t i = levels.size(); i-- > 0;) {
+        data_offset = (data_offset + alignment - 1) / alignment * alignment;
+        offsets[i] = data_offset;
+        data_offset += levels[i].size();
+    }
+
+    std::vector<uint8_t> bytes;
+    bytes.reserve(data_offset);
+    Writer writer(bytes);
+    for (auto byte : KTX2_IDENTIFIER)
+        writer.u8(byte);
+    writer.u32(vkFormat(format, srgb));
+    writer.u32(1);                                  // typeSize of block-compressed formats
+    writer.u32((uint32_t)width);
+    writer.u32((uint32_t)height);
+    writer.u32(0);                                  // pixelDepth
+    writer.u32(0);                                  // layerCount
+    writer.u32(1);                                  // faceCount
+    writer.u32((uint32_t)levels.size());
+    writer.u32(0);                                  // supercompressionScheme
+    writer.u32((uint32_t)descriptor_offset);
+    writer.u32((uint32_t)descriptor.size());
+    writer.u32(0);                                  // no key/value data
+    writer.u32(0);
+    writer.u64(0);                                  // no supercompression global data
+    writer.u64(0);
+    for (size_t i = 0; i < levels.size(); i++) {
+        writer.u64(offsets[i]);
+        writer.u64(levels[i].size());
+        writer.u64(levels[i].size());
+    }
+    bytes.insert(bytes.end(), descriptor.begin(), descriptor.end());
+    for (size_t i = levels.size(); i-- > 0;) {
+        writer.pad(alignment);
+        bytes.insert(bytes.end(), levels[i].begin(), levels[i].end());
+    }
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        fprintf(stdout, "[Error] Can not write %s\n", path.c_str());
+        return false;
+    }
+    bool written = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    written = fclose(file) == 0 && written;
+    return written;
+}
+
+}
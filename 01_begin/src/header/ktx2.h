@@ -0,0 +1,72 @@
+/**
+ * @file ktx2.h
+ * @author l1ang70
+ * @brief Reading and writing KTX2 containers of block-compressed textures
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_KTX2_H_
+#define _OPENGL_KTX2_H_
+
+#include "texture_compress.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace opengl {
+
+struct Ktx2Level {
+    const uint8_t   *data;
+    size_t          size;
+    int             width;
+    int             height;
+};
+
+// A KTX2 file of one of the CompressedFormats, 2D, one layer and face, no supercompression:
+// what the texture cooker writes. The file is memory-mapped and the levels point into the
+// mapping, so they can go to glCompressedTexSubImage2D without a copy.
+class Ktx2Image {
+    void                    *mapping_       = nullptr;
+    size_t                  mapping_size_   = 0;
+    CompressedFormat        format_         = BC1;
+    bool                    srgb_           = false;
+    int                     width_          = 0;
+    int                     height_         = 0;
+    std::vector<Ktx2Level>  levels_;
+
+private:
+    Ktx2Image() = default;
+
+    bool parse(const std::string &path);
+
+public:
+    // Returns nullptr if the file can not be mapped or is not such a KTX2 file.
+    static Ktx2Image* open(const std::string &path);
+
+    ~Ktx2Image();
+
+    Ktx2Image(const Ktx2Image&) = delete;
+    Ktx2Image& operator=(const Ktx2Image&) = delete;
+
+    inline CompressedFormat format() const { return format_; }
+    inline bool srgb() const { return srgb_; }
+    inline int width() const { return width_; }
+    inline int height() const { return height_; }
+    inline size_t levelCount() const { return levels_.size(); }
+    inline const Ktx2Level& level(size_t index) const { return levels_[index]; }
+};
+
+// Write levels, level 0 the full width x height and each next one half of it, compressed
+// with compressImage(). Returns false if the file can not be written.
+bool writeKtx2(const std::string &path, CompressedFormat format, bool srgb, int width, int height,
+               const std::vector<std::vector<uint8_t>> &levels);
+
+}
+
+#endif // !_OPENGL_KTX2_H_
@@ -0,0 +1,464 @@
+#include "mesh.h"
+#include "render_state.h"
+#include "vertex_array_cache.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace opengl {
+
+namespace {
+
+// FNV-1a over the bits of a vertex.
+uint32_t
+hashVertex(const float *vertex, size_t vertex_floats) {
+    uint32_t hash = 2166136261u;
+    const uint8_t *bytes = (const uint8_t*)vertex;
+    for (size_t i = 0; i < vertex_floats * sizeof(float); i++)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+// Vertex to triangle adjacency, compressed: the triangles of v are triangles[offset[v] .. offset[v + 1]).
+struct Adjacency {
+    std::vector<uint32_t>   offset;
+    std::vector<uint32_t>   triangles;
+
+    Adjacency(const uint32_t *indices, size_t index_count, size_t vertex_count) : offset(vertex_count + 1, 0) {
+        for (size_t i = 0; i < index_count; i++)
+            offset[indices[i] + 1]++;
+        for (size_t v = 0; v < vertex_count; v++)
+            offset[v + 1] += offset[v];
+        triangles.resize(index_count);
+        std::vector<uint32_t> fill(offset.begin(), offset.end() - 1);
+        for (size_t i = 0; i < index_count; i++)
+            triangles[fill[indices[i]]++] = (uint32_t)(i / 3);
+    }
+};
+
+// Where the next fan of Tipsify starts: the candidate that stays longest in the cache while
+// its triangles are emitted, else a vertex of the dead-end stack, else the next live vertex.
+int64_t
+nextVertex(const std::vector<uint32_t> &candidates, const std::vector<uint32_t> &live,
+           const std::vector<uint64_t> &stamp, uint64_t time, unsigned int cache_size,
+           std::vector<uint32_t> &dead_ends, size_t &cursor) {
+    int64_t best = -1;
+    int64_t best_priority = -1;
+    for (uint32_t v : candidates) {
+        if (live[v] == 0)
+            continue;
+        int64_t priority = 0;
+        // still cached once its remaining triangles are out
+        if (time - stamp[v] + 2 * live[v] <= cache_size)
+            priority = (int64_t)(time - stamp[v]);
+        if (priority > best_priority) {
+            best_priority = priority;
+            best = v;
+        }
+    }
+    if (best >= 0)
+        return best;
+
+    while (!dead_ends.empty()) {
+        uint32_t v = dead_ends.back();
+        dead_ends.pop_back();
+        if (live[v] > 0)
+            return v;
+    }
+    for (; cursor < live.size(); cursor++) {
+        if (live[cursor] > 0)
+            return (int64_t)cursor;
+    }
+    return -1;
+}
+
+// FIFO cache simulation, a vertex missing when cache_size others came in since it was last loaded.
+class CacheSimulator {
+    std::vector<uint64_t>   stamp_;
+    uint64_t                time_;
+    unsigned int            cache_size_;
+
+public:
+    CacheSimulator(size_t vertex_count, unsigned int cache_size)
+        : stamp_(vertex_count, 0), time_(cache_size + 1), cache_size_(cache_size) {}
+
+    inline void reset() { time_ += cache_size_ + 1; }
+
+    // Misses of one triangle.
+    inline unsigned int triangle(const uint32_t *t) {
+        unsigned int misses = 0;
+        for (int k = 0; k < 3; k++) {
+            if (time_ - stamp_[t[k]] > cache_size_) {
+                stamp_[t[k]] = time_++;
+                misses++;
+            }
+        }
+        return misses;
+    }
+};
+
+}
+
+Mesh::Mesh(unsigned int vertex_array, unsigned int vertex_buffer, unsigned int index_buffer, unsigned int index_type,
+           size_t index_count, const MeshStats &stats, unsigned int cache_size, const VertexFormat &format)
+    : vertex_array_(vertex_array), vertex_buffer_(vertex_buffer), index_buffer_(index_buffer), index_type_(index_type),
+      index_count_(index_count), stats_(stats), cache_size_(cache_size), format_(format),
+      layout_(format_.descriptor()) {
+}
+
+Mesh*
+Mesh::create(const float *vertices, size_t vertex_count, const MeshOptions &options) {
+    std::vector<uint32_t> indices(vertex_count - vertex_count % 3);
+    for (size_t i = 0; i < indices.size(); i++)
+        indices[i] = (uint32_t)i;
+    return create(vertices, vertex_count, indices.data(), indices.size(), options);
+}
+
+Mesh*
+Mesh::create(const float *vertices, size_t vertex_count, const uint32_t *indices, size_t index_count,
+             const MeshOptions &options) {
+    index_count -= index_count % 3;
+    if (index_count == 0) {
+        fprintf(stdout, "[Error] Mesh has no triangles\n");
+        return nullptr;
+    }
+    for (size_t i = 0; i < index_count; i++) {
+        if (indices[i] >= vertex_count) {
+            fprintf(stdout, "[Error] Mesh index %u out of %zu vertices\n", indices[i], vertex_count);
+            return nullptr;
+        }
+    }
+
+    VertexFormat format = options.format;
+    size_t vertex_floats = format.sourceFloats();
+    MeshStats stats;
+    stats.input_vertices = vertex_count;
+    stats.triangles = index_count / 3;
+    std::vector<float> data;
+    std::vector<uint32_t> final_indices(indices, indices + index_count);
+    if (options.weld) {
+        std::vector<uint32_t> remap;
+        vertex_count = weldVertices(vertices, vertex_count, vertex_floats, data, remap);
+        for (auto &index : final_indices)
+            index = remap[index];
+    } else {
+        data.assign(vertices, vertices + vertex_count * vertex_floats);
+    }
+    stats.acmr_input = acmr(final_indices.data(), index_count, vertex_count, options.cache_size);
+
+    if (options.optimize) {
+        optimizeVertexCache(final_indices.data(), index_count, vertex_count, options.cache_size);
+        if (options.overdraw > 0.0f && vertex_floats >= 3)
+            optimizeOverdraw(final_indices.data(), index_count, data.data(), vertex_count, vertex_floats,
+                             options.cache_size, options.overdraw);
+        vertex_count = optimizeVertexFetch(final_indices.data(), index_count, data, vertex_floats);
+    }
+    stats.vertices = vertex_count;
+    stats.vertex_bytes = format.stride();
+    stats.acmr = acmr(final_indices.data(), index_count, vertex_count, options.cache_size);
+
+    GLuint vertex_array = 0, buffers[2] = {};
+    bool shared = VertexArrayCache::supported();
+    if (!shared)
+        glGenVertexArrays(1, &vertex_array);
+    glGenBuffers(2, buffers);
+    RenderState &state = RenderState::current();
+    if ((!shared && !vertex_array) || !buffers[0] || !buffers[1]) {
+        fprintf(stdout, "[Error] Fail to create the buffers of a mesh\n");
+        state.deleteVertexArray(vertex_array);
+        state.deleteBuffer(buffers[0]);
+        state.deleteBuffer(buffers[1]);
+        return nullptr;
+    }
+
+    // both filled through GL_ARRAY_BUFFER, the element buffer binding belongs to whatever vertex array is bound
+    std::vector<uint8_t> packed;
+    format.encode(data.data(), vertex_count, packed);
+    state.bindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+    state.bindBuffer(GL_ARRAY_BUFFER, buffers[1]);
+    unsigned int index_type = GL_UNSIGNED_INT;
+    if (vertex_count <= 65536) {
+        std::vector<uint16_t> short_indices(final_indices.begin(), final_indices.end());
+        glBufferData(GL_ARRAY_BUFFER, short_indices.size() * sizeof(uint16_t), short_indices.data(), GL_STATIC_DRAW);
+        index_type = GL_UNSIGNED_SHORT;
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, final_indices.size() * sizeof(uint32_t), final_indices.data(), GL_STATIC_DRAW);
+    }
+
+    if (!shared) {
+        state.bindVertexArray(vertex_array);
+        state.bindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+        format.setup();
+        state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+        state.bindVertexArray(0);
+    }
+    return new Mesh(vertex_array, buffers[0], buffers[1], index_type, index_count, stats, options.cache_size, format);
+}
+
+Mesh::~Mesh() {
+    RenderState &state = RenderState::current();
+    state.deleteVertexArray(vertex_array_);
+    state.deleteBuffer(vertex_buffer_);
+    state.deleteBuffer(index_buffer_);
+}
+
+void
+Mesh::bind() const {
+    RenderState &state = RenderState::current();
+    if (vertex_array_) {
+        state.bindVertexArray(vertex_array_);
+        return;
+    }
+    state.bindVertexArray(VertexArrayCache::current().vertexArray(layout_));
+    state.bindVertexBuffer(0, vertex_buffer_, 0, (int)layout_.stride);
+    state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+}
+
+void
+Mesh::draw() const {
+    bind();
+    glDrawElements(GL_TRIANGLES, (GLsizei)index_count_, index_type_, nullptr);
+}
+
+void
+Mesh::drawInstanced(unsigned int instance_count) const {
+    bind();
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)index_count_, index_type_, nullptr, (GLsizei)instance_count);
+}
+
+void
+Mesh::drawInstanced(unsigned int instance_count, const LayoutDescriptor &instance_layout, unsigned int instance_buffer,
+                    size_t offset) const {
+    RenderState &state = RenderState::current();
+    if (vertex_array_) {
+        // a vertex array of its own: point the instance attributes at the offset again
+        state.bindVertexArray(vertex_array_);
+        state.bindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+        setupVertexAttributes(instance_layout, offset);
+    } else {
+        const LayoutDescriptor layouts[2] = { layout_, instance_layout };
+        state.bindVertexArray(VertexArrayCache::current().vertexArray(layouts, 2));
+        state.bindVertexBuffer(0, vertex_buffer_, 0, (int)layout_.stride);
+        state.bindVertexBuffer(1, instance_buffer, (ptrdiff_t)offset, (int)instance_layout.stride);
+        state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+    }
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)index_count_, index_type_, nullptr, (GLsizei)instance_count);
+}
+
+void
+Mesh::report() const {
+    fprintf(stdout, "[Info] Mesh: %zu vertices welded to %zu of %zu bytes (%zu as floats), %zu triangles, %d-bit indices, "
+                    "ACMR %.3f non-indexed, %.3f indexed, %.3f optimized (cache of %u)\n",
+            stats_.input_vertices, stats_.vertices, stats_.vertex_bytes, format_.sourceFloats() * sizeof(float),
+            stats_.triangles, index_type_ == GL_UNSIGNED_SHORT ? 16 : 32, 3.0f, stats_.acmr_input, stats_.acmr,
+            cache_size_);
+}
+
+size_t
+Mesh::weldVertices(const float *vertices, size_t vertex_count, size_t vertex_floats, std::vector<float> &unique,
+                   std::vector<uint32_t> &remap) {
+    // open addressing at most half full, slots hold a unique index plus one
+    size_t capacity = 16;
+    while (capacity < vertex_count * 2)
+        capacity *= 2;
+    std::vector<uint32_t> table(capacity, 0);
+    unique.clear();
+    unique.reserve(vertex_count * vertex_floats);
+    remap.resize(vertex_count);
+    size_t unique_count = 0;
+    for (size_t i = 0; i < vertex_count; i++) {
+        const float *vertex = vertices + i * vertex_floats;
+        size_t slot = hashVertex(vertex, vertex_floats) & (capacity - 1);
+        for (;;) {
+            uint32_t entry = table[slot];
+            if (entry == 0) {
+                table[slot] = (uint32_t)++unique_count;
+                unique.insert(unique.end(), vertex, vertex + vertex_floats);
+                remap[i] = (uint32_t)(unique_count - 1);
+                break;
+            }
+            if (memcmp(&unique[(entry - 1) * vertex_floats], vertex, vertex_floats * sizeof(float)) == 0) {
+                remap[i] = entry - 1;
+                break;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+    }
+    return unique_count;
+}
+
+void
+Mesh::optimizeVertexCache(uint32_t *indices, size_t index_count, size_t vertex_count, unsigned int cache_size) {
+    size_t triangle_count = index_count / 3;
+    if (triangle_count == 0)
+        return;
+    Adjacency adjacency(indices, triangle_count * 3, vertex_count);
+    std::vector<uint32_t> live(vertex_count);
+    for (size_t v = 0; v < vertex_count; v++)
+        live[v] = adjacency.offset[v + 1] - adjacency.offset[v];
+    std::vector<uint64_t> stamp(vertex_count, 0);
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<uint32_t> dead_ends;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(triangle_count * 3);
+    uint64_t time = cache_size + 1;
+    size_t cursor = 0;
+
+    int64_t fan = nextVertex(candidates, live, stamp, time, cache_size, dead_ends, cursor);
+    while (fan >= 0) {
+        candidates.clear();
+        // emit every triangle of the fan vertex that is not out yet
+        for (uint32_t i = adjacency.offset[fan]; i < adjacency.offset[fan + 1]; i++) {
+            uint32_t triangle = adjacency.triangles[i];
+            if (emitted[triangle])
+                continue;
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = indices[triangle * 3 + k];
+                output.push_back(v);
+                dead_ends.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - stamp[v] > cache_size)
+                    stamp[v] = time++;
+            }
+            emitted[triangle] = true;
+        }
+        fan = nextVertex(candidates, live, stamp, time, cache_size, dead_ends, cursor);
+    }
+    memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+}
+
+void
+Mesh::optimizeOverdraw(uint32_t *indices, size_t index_count, const float *positions, size_t vertex_count,
+                       size_t vertex_floats, unsigned int cache_size, float threshold) {
+    size_t triangle_count = index_count / 3;
+    if (triangle_count < 2)
+        return;
+
+    // hard boundaries where a triangle misses on every vertex, the cache holds nothing of the previous one
+    std::vector<size_t> hard = { 0 };
+    CacheSimulator cache(vertex_count, cache_size);
+    for (size_t t = 0; t < triangle_count; t++) {
+        if (cache.triangle(indices + t * 3) == 3 && t > 0)
+            hard.push_back(t);
+    }
+    hard.push_back(triangle_count);
+
+    // soft boundaries inside each, wherever the ACMR so far is within threshold of the whole stretch
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hard.size(); h++) {
+        size_t begin = hard[h], end = hard[h + 1];
+        cache.reset();
+        unsigned int misses = 0;
+        for (size_t t = begin; t < end; t++)
+            misses += cache.triangle(indices + t * 3);
+        float stretch_acmr = (float)misses / (end - begin);
+
+        cache.reset();
+        clusters.push_back(begin);
+        unsigned int cluster_misses = 0;
+        size_t cluster_triangles = 0;
+        for (size_t t = begin; t < end; t++) {
+            cluster_misses += cache.triangle(indices + t * 3);
+            cluster_triangles++;
+            if (t + 1 < end && cluster_misses <= threshold * stretch_acmr * cluster_triangles) {
+                clusters.push_back(t + 1);
+                cache.reset();
+                cluster_misses = 0;
+                cluster_triangles = 0;
+            }
+        }
+    }
+    clusters.push_back(triangle_count);
+    size_t cluster_count = clusters.size() - 1;
+    if (cluster_count < 2)
+        return;
+
+    // area-weighted centroid and normal of every cluster, and of the mesh
+    std::vector<float> centers(cluster_count * 3), normals(cluster_count * 3);
+    float mesh_center[3] = {}, mesh_area = 0.0f;
+    for (size_t c = 0; c < cluster_count; c++) {
+        float center[3] = {}, normal[3] = {}, area = 0.0f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+            const float *p0 = positions + indices[t * 3 + 0] * vertex_floats;
+            const float *p1 = positions + indices[t * 3 + 1] * vertex_floats;
+            const float *p2 = positions + indices[t * 3 + 2] * vertex_floats;
+            float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+            float a = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int k = 0; k < 3; k++) {
+                center[k] += (p0[k] + p1[k] + p2[k]) * a / 3.0f;
+                normal[k] += n[k];
+            }
+            area += a;
+        }
+        for (int k = 0; k < 3; k++) {
+            mesh_center[k] += center[k];
+            centers[c * 3 + k] = area > 0.0f ? center[k] / area : 0.0f;
+            normals[c * 3 + k] = normal[k];
+        }
+        mesh_area += area;
+    }
+    for (int k = 0; k < 3; k++)
+        mesh_center[k] = mesh_area > 0.0f ? mesh_center[k] / mesh_area : 0.0f;
+
+    std::vector<float> keys(cluster_count);
+    std::vector<uint32_t> order(cluster_count);
+    for (size_t c = 0; c < cluster_count; c++) {
+        const float *n = &normals[c * 3];
+        float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        float dot = 0.0f;
+        for (int k = 0; k < 3; k++)
+            dot += (centers[c * 3 + k] - mesh_center[k]) * n[k];
+        keys[c] = length > 0.0f ? dot / length : 0.0f;
+        order[c] = (uint32_t)c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(triangle_count * 3);
+    for (uint32_t c : order)
+        sorted.insert(sorted.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+    memcpy(indices, sorted.data(), sorted.size() * sizeof(uint32_t));
+}
+
+size_t
+Mesh::optimizeVertexFetch(uint32_t *indices, size_t index_count, std::vector<float> &vertices, size_t vertex_floats) {
+    size_t vertex_count = vertices.size() / vertex_floats;
+    std::vector<uint32_t> remap(vertex_count, ~0u);
+    std::vector<float> reordered;
+    reordered.reserve(vertices.size());
+    uint32_t next = 0;
+    for (size_t i = 0; i < index_count; i++) {
+        uint32_t &slot = remap[indices[i]];
+        if (slot == ~0u) {
+            slot = next++;
+            reordered.insert(reordered.end(), vertices.begin() + indices[i] * vertex_floats,
+                             vertices.begin() + (indices[i] + 1) * vertex_floats);
+        }
+        indices[i] = slot;
+    }
+    vertices.swap(reordered);
+    return next;
+}
+
+float
+Mesh::acmr(const uint32_t *indices, size_t index_count, size_t vertex_count, unsigned int cache_size) {
+    size_t triangle_count = index_count / 3;
+    if (triangle_count == 0)
+        return 0.0f;
+    CacheSimulator cache(vertex_count, cache_size);
+    size_t misses = 0;
+    for (size_t t = 0; t < triangle_count; t++)
+        misses += cache.triangle(indices + t * 3);
+    return (float)misses / triangle_count;
+}
+
+}
@@ -0,0 +1,132 @@
+/**
+ * @file mesh.h
+ * @author l1ang70
+ * @brief Indexed meshes: welded vertices, 16- or 32-bit indices, triangles ordered for the vertex cache and overdraw
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_MESH_H_
+#define _OPENGL_MESH_H_
+
+#include "vertex_format.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace opengl {
+
+struct MeshOptions {
+    bool            weld        = true;     // merge bit-identical vertices
+    bool            optimize    = true;     // reorder triangles and vertices
+    unsigned int    cache_size  = 16;       // post-transform cache the order is tuned and measured for
+    float           overdraw    = 1.05f;    // ACMR a cluster may lose to be sorted for overdraw, 0 for none
+    VertexFormat    format      = VertexFormat::positionTexture();  // source floats and how they are packed
+};
+
+// Transformed vertices per triangle (ACMR) of a FIFO post-transform cache: 3 for a
+// non-indexed list, 0.5 at best for a large regular grid.
+struct MeshStats {
+    size_t          input_vertices  = 0;
+    size_t          vertices        = 0;    // after welding
+    size_t          triangles       = 0;
+    size_t          vertex_bytes    = 0;    // packed, a vertex
+    float           acmr_input      = 0.0f; // the welded triangles in their input order
+    float           acmr            = 0.0f; // as drawn
+};
+
+// A triangle mesh drawn with glDrawElements. The vertices are floats laid out as the format of
+// the options says, the samples' vec3 position and vec2 texture coordinate unless told
+// otherwise, the position first, and uploaded packed by that format. Built from raw arrays:
+// duplicate vertices are welded, the triangles reordered with Tipsify for the post-transform
+// cache, then its clusters sorted outside-in against overdraw, and the vertices renumbered in
+// first-use order so the fetch walks the buffer forward. Indices are 16-bit when the vertex
+// count allows, which halves the index bandwidth. Where the VertexArrayCache is supported,
+// meshes of one format share its vertex array and a draw only rebinds their two buffers;
+// otherwise each mesh sets up a vertex array of its own.
+class Mesh {
+    unsigned int        vertex_array_;      // 0 when the vertex array of the format comes from the cache
+    unsigned int        vertex_buffer_;
+    unsigned int        index_buffer_;
+    unsigned int        index_type_;        // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    size_t              index_count_;
+    MeshStats           stats_;
+    unsigned int        cache_size_;
+    VertexFormat        format_;
+    LayoutDescriptor    layout_;            // of format_
+
+private:
+    Mesh(unsigned int vertex_array, unsigned int vertex_buffer, unsigned int index_buffer, unsigned int index_type,
+         size_t index_count, const MeshStats &stats, unsigned int cache_size, const VertexFormat &format);
+
+    // The vertex array and both buffers, from the cache or its own.
+    void bind() const;
+
+public:
+    // Floats of a vertex of VertexFormat::positionTexture().
+    constexpr static size_t VERTEX_FLOATS = 5;
+
+    // A non-indexed triangle list, vertex_count vertices of format.sourceFloats() floats, as glDrawArrays draws it.
+    static Mesh* create(const float *vertices, size_t vertex_count, const MeshOptions &options = MeshOptions());
+
+    // An indexed triangle list. Returns nullptr if there are no triangles or the buffers can not be created.
+    static Mesh* create(const float *vertices, size_t vertex_count, const uint32_t *indices, size_t index_count,
+                        const MeshOptions &options = MeshOptions());
+
+    ~Mesh();
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    // Bind the vertex array and buffers through the render state cache and draw every triangle.
+    void draw() const;
+    void drawInstanced(unsigned int instance_count) const;
+
+    // Draw instance_count instances reading per-instance attributes of instance_layout, whose
+    // divisor is not 0, from instance_buffer at offset. Moving the offset every frame, as a
+    // ring buffer does, costs one glBindVertexBuffer with the cache.
+    void drawInstanced(unsigned int instance_count, const LayoutDescriptor &instance_layout, unsigned int instance_buffer,
+                       size_t offset) const;
+
+    inline unsigned int indexType() const { return index_type_; }
+    inline size_t indexCount() const { return index_count_; }
+    inline const MeshStats& stats() const { return stats_; }
+    // With the scale and bias of the fitted attributes, for the shader.
+    inline const VertexFormat& format() const { return format_; }
+
+    // Print the vertex counts and size, index width and ACMR before and after to stdout.
+    void report() const;
+
+    // The steps of create(), on the CPU and usable without a GL context.
+
+    // Merge vertices of vertex_floats floats that are bitwise equal. unique gets each vertex
+    // once in first-seen order, remap the unique index of every input vertex. Returns the
+    // unique count.
+    static size_t weldVertices(const float *vertices, size_t vertex_count, size_t vertex_floats,
+                               std::vector<float> &unique, std::vector<uint32_t> &remap);
+
+    // Reorder the triangles in place for a FIFO cache of cache_size entries (Tipsify, Sander et al. 2007).
+    static void optimizeVertexCache(uint32_t *indices, size_t index_count, size_t vertex_count, unsigned int cache_size);
+
+    // Split the cache-ordered triangles into clusters that each lose at most threshold of
+    // ACMR, then put the clusters facing away from the center first, so the outer surface
+    // tends to be drawn before what it hides. positions are vec3 at vertex_floats apart.
+    static void optimizeOverdraw(uint32_t *indices, size_t index_count, const float *positions, size_t vertex_count,
+                                 size_t vertex_floats, unsigned int cache_size, float threshold);
+
+    // Renumber the vertices in the order the indices first use them and reorder the vertex
+    // data to match. Returns the vertex count, unused vertices are dropped.
+    static size_t optimizeVertexFetch(uint32_t *indices, size_t index_count, std::vector<float> &vertices,
+                                      size_t vertex_floats);
+
+    // ACMR of the triangle list through a FIFO cache of cache_size entries.
+    static float acmr(const uint32_t *indices, size_t index_count, size_t vertex_count, unsigned int cache_size);
+};
+
+}
+
+#endif // !_OPENGL_MESH_H_
@@ -0,0 +1,303 @@
+#include "mesh_arena.h"
+#include "render_state.h"
+#include "vertex_array_cache.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace opengl {
+
+MeshArena::MeshArena(const VertexFormat &format, unsigned int index_type, unsigned int vertex_array,
+                     unsigned int vertex_buffer, unsigned int index_buffer, uint32_t vertex_capacity,
+                     uint32_t index_capacity)
+    : format_(format), layout_(format_.descriptor()), index_type_(index_type),
+      index_size_(index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t)), vertex_array_(vertex_array),
+      vertex_buffer_(vertex_buffer), index_buffer_(index_buffer), vertex_ranges_(vertex_capacity),
+      index_ranges_(index_capacity) {
+}
+
+MeshArena*
+MeshArena::create(const VertexFormat &format, uint32_t vertex_capacity, uint32_t index_capacity, bool short_indices) {
+    for (size_t i = 0; i < format.attributeCount(); i++) {
+        if (format.attribute(i).fit) {
+            fprintf(stdout, "[Error] Mesh arena format can not fit attribute %u to the bounds of a mesh\n",
+                    format.attribute(i).location);
+            return nullptr;
+        }
+    }
+    vertex_capacity = std::max(vertex_capacity, 1u);
+    index_capacity = std::max(index_capacity, 3u);
+    unsigned int index_type = short_indices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    size_t index_size = short_indices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    GLuint vertex_array = 0, buffers[2] = {};
+    bool shared = VertexArrayCache::supported();
+    if (!shared)
+        glGenVertexArrays(1, &vertex_array);
+    glGenBuffers(2, buffers);
+    RenderState &state = RenderState::current();
+    if ((!shared && !vertex_array) || !buffers[0] || !buffers[1]) {
+        fprintf(stdout, "[Error] Fail to create the buffers of a mesh arena\n");
+        state.deleteVertexArray(vertex_array);
+        state.deleteBuffer(buffers[0]);
+        state.deleteBuffer(buffers[1]);
+        return nullptr;
+    }
+    // storage only, meshes are written into their ranges as they are added
+    state.bindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)vertex_capacity * format.stride(), nullptr, GL_STATIC_DRAW);
+    state.bindBuffer(GL_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)index_capacity * index_size, nullptr, GL_STATIC_DRAW);
+
+    MeshArena *arena = new MeshArena(format, index_type, vertex_array, buffers[0], buffers[1], vertex_capacity,
+                                     index_capacity);
+    arena->setupVertexArray();
+    return arena;
+}
+
+MeshArena::~MeshArena() {
+    RenderState &state = RenderState::current();
+    state.deleteVertexArray(vertex_array_);
+    state.deleteBuffer(vertex_buffer_);
+    state.deleteBuffer(index_buffer_);
+}
+
+void
+MeshArena::setupVertexArray() {
+    if (!vertex_array_)
+        return;
+    RenderState &state = RenderState::current();
+    state.bindVertexArray(vertex_array_);
+    state.bindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+    format_.setup();
+    state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+    state.bindVertexArray(0);
+}
+
+unsigned int
+MeshArena::relocate(unsigned int buffer, size_t unit_size, uint32_t capacity,
+                    const std::vector<RangeAllocator::Allocation> &from,
+                    const std::vector<RangeAllocator::Allocation> &to) {
+    GLuint relocated = 0;
+    glGenBuffers(1, &relocated);
+    if (!relocated)
+        return 0;
+    RenderState &state = RenderState::current();
+    state.bindBuffer(GL_COPY_WRITE_BUFFER, relocated);
+    glBufferData(GL_COPY_WRITE_BUFFER, (size_t)capacity * unit_size, nullptr, GL_STATIC_DRAW);
+    state.bindBuffer(GL_COPY_READ_BUFFER, buffer);
+    // ranges next to each other on both sides go in one copy, after defragment() that is most of them
+    for (size_t i = 0; i < from.size();) {
+        uint32_t source = from[i].offset, target = to[i].offset, size = from[i].size;
+        for (i++; i < from.size() && from[i].offset == source + size && to[i].offset == target + size; i++)
+            size += from[i].size;
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (size_t)source * unit_size,
+                            (size_t)target * unit_size, (size_t)size * unit_size);
+        bytes_copied_ += (size_t)size * unit_size;
+    }
+    state.deleteBuffer(buffer);
+    return relocated;
+}
+
+bool
+MeshArena::growVertices(uint32_t vertex_count) {
+    uint32_t capacity = vertex_ranges_.capacity();
+    uint64_t grown = (uint64_t)capacity + std::max(capacity, vertex_count);
+    if (grown > 0xfffffffeull || grown * format_.stride() > 0x7fffffffull)
+        return false;
+    // the offsets stay, the whole old buffer goes over in one copy
+    RangeAllocator::Allocation all;
+    all.offset = 0;
+    all.size = capacity;
+    unsigned int buffer = relocate(vertex_buffer_, format_.stride(), (uint32_t)grown, { all }, { all });
+    if (!buffer)
+        return false;
+    vertex_buffer_ = buffer;
+    vertex_ranges_.grow((uint32_t)grown);
+    grow_count_++;
+    setupVertexArray();
+    return true;
+}
+
+bool
+MeshArena::growIndices(uint32_t index_count) {
+    uint32_t capacity = index_ranges_.capacity();
+    uint64_t grown = (uint64_t)capacity + std::max(capacity, index_count);
+    if (grown > 0xfffffffeull || grown * index_size_ > 0x7fffffffull)
+        return false;
+    RangeAllocator::Allocation all;
+    all.offset = 0;
+    all.size = capacity;
+    unsigned int buffer = relocate(index_buffer_, index_size_, (uint32_t)grown, { all }, { all });
+    if (!buffer)
+        return false;
+    index_buffer_ = buffer;
+    index_ranges_.grow((uint32_t)grown);
+    grow_count_++;
+    setupVertexArray();
+    return true;
+}
+
+uint32_t
+MeshArena::add(const float *vertices, size_t vertex_count, const uint32_t *indices, size_t index_count) {
+    index_count -= index_count % 3;
+    if (vertex_count == 0 || index_count == 0) {
+        fprintf(stdout, "[Error] Mesh arena mesh has no triangles\n");
+        return INVALID_MESH;
+    }
+    if (index_type_ == GL_UNSIGNED_SHORT && vertex_count > 65536) {
+        fprintf(stdout, "[Error] Mesh arena with 16-bit indices can not take %zu vertices\n", vertex_count);
+        return INVALID_MESH;
+    }
+    if (vertex_count > 0xfffffffeull || index_count > 0xfffffffeull) {
+        fprintf(stdout, "[Error] Mesh arena mesh of %zu vertices is too large\n", vertex_count);
+        return INVALID_MESH;
+    }
+    for (size_t i = 0; i < index_count; i++) {
+        if (indices[i] >= vertex_count) {
+            fprintf(stdout, "[Error] Mesh arena index %u out of %zu vertices\n", indices[i], vertex_count);
+            return INVALID_MESH;
+        }
+    }
+
+    RangeAllocator::Allocation vertex_range = vertex_ranges_.allocate((uint32_t)vertex_count);
+    if (!vertex_range.isValid() && growVertices((uint32_t)vertex_count))
+        vertex_range = vertex_ranges_.allocate((uint32_t)vertex_count);
+    RangeAllocator::Allocation index_range = index_ranges_.allocate((uint32_t)index_count);
+    if (!index_range.isValid() && growIndices((uint32_t)index_count))
+        index_range = index_ranges_.allocate((uint32_t)index_count);
+    if (!vertex_range.isValid() || !index_range.isValid()) {
+        fprintf(stdout, "[Error] Mesh arena can not grow for %zu vertices and %zu indices\n", vertex_count, index_count);
+        vertex_ranges_.free(vertex_range);
+        index_ranges_.free(index_range);
+        return INVALID_MESH;
+    }
+
+    // both written through GL_ARRAY_BUFFER, the element buffer binding belongs to whatever vertex array is bound
+    RenderState &state = RenderState::current();
+    std::vector<uint8_t> packed;
+    format_.encode(vertices, vertex_count, packed);
+    state.bindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+    glBufferSubData(GL_ARRAY_BUFFER, (size_t)vertex_range.offset * format_.stride(), packed.size(), packed.data());
+    state.bindBuffer(GL_ARRAY_BUFFER, index_buffer_);
+    if (index_type_ == GL_UNSIGNED_SHORT) {
+        std::vector<uint16_t> short_indices(indices, indices + index_count);
+        glBufferSubData(GL_ARRAY_BUFFER, (size_t)index_range.offset * index_size_, index_count * index_size_,
+                        short_indices.data());
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, (size_t)index_range.offset * index_size_, index_count * index_size_, indices);
+    }
+
+    Entry entry = { vertex_range, index_range, (uint32_t)index_count, true };
+    if (!free_ids_.empty()) {
+        uint32_t id = free_ids_.back();
+        free_ids_.pop_back();
+        entries_[id] = entry;
+        return id;
+    }
+    entries_.push_back(entry);
+    return (uint32_t)entries_.size() - 1;
+}
+
+void
+MeshArena::remove(uint32_t id) {
+    if (!contains(id))
+        return;
+    Entry &entry = entries_[id];
+    vertex_ranges_.free(entry.vertices);
+    index_ranges_.free(entry.indices);
+    entry.live = false;
+    free_ids_.push_back(id);
+}
+
+size_t
+MeshArena::defragment() {
+    // nothing to close when all that is free is one range
+    bool vertices_packed = vertex_ranges_.largestFree() == vertex_ranges_.capacity() - vertex_ranges_.used();
+    bool indices_packed = index_ranges_.largestFree() == index_ranges_.capacity() - index_ranges_.used();
+    if (vertices_packed && indices_packed)
+        return 0;
+
+    size_t moved = bytes_copied_;
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0; id < entries_.size(); id++) {
+        if (entries_[id].live)
+            ids.push_back(id);
+    }
+    // in the order of their offsets, a fresh allocator hands out the ranges one after another
+    auto pack = [this, &ids](RangeAllocator &ranges, RangeAllocator::Allocation Entry::*member, unsigned int &buffer,
+                             size_t unit_size) -> bool {
+        std::sort(ids.begin(), ids.end(), [this, member](uint32_t a, uint32_t b) {
+            return (entries_[a].*member).offset < (entries_[b].*member).offset;
+        });
+        RangeAllocator packed(ranges.capacity());
+        std::vector<RangeAllocator::Allocation> from, to;
+        for (uint32_t id : ids) {
+            from.push_back(entries_[id].*member);
+            to.push_back(packed.allocate(from.back().size));
+        }
+        unsigned int relocated = relocate(buffer, unit_size, ranges.capacity(), from, to);
+        if (!relocated)
+            return false;
+        buffer = relocated;
+        ranges = packed;
+        for (size_t i = 0; i < ids.size(); i++)
+            entries_[ids[i]].*member = to[i];
+        return true;
+    };
+    if (!vertices_packed && !pack(vertex_ranges_, &Entry::vertices, vertex_buffer_, format_.stride()))
+        fprintf(stdout, "[Error] Fail to defragment the vertex buffer of a mesh arena\n");
+    if (!indices_packed && !pack(index_ranges_, &Entry::indices, index_buffer_, index_size_))
+        fprintf(stdout, "[Error] Fail to defragment the index buffer of a mesh arena\n");
+    setupVertexArray();
+    generation_++;
+    defragment_count_++;
+    return bytes_copied_ - moved;
+}
+
+void
+MeshArena::bind() const {
+    RenderState &state = RenderState::current();
+    if (vertex_array_) {
+        state.bindVertexArray(vertex_array_);
+        return;
+    }
+    state.bindVertexArray(VertexArrayCache::current().vertexArray(layout_));
+    state.bindVertexBuffer(0, vertex_buffer_, 0, (int)layout_.stride);
+    state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+}
+
+void
+MeshArena::draw(uint32_t id) const {
+    if (!contains(id))
+        return;
+    bind();
+    const Entry &entry = entries_[id];
+    glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)entry.index_count, index_type_,
+                             (void*)((size_t)entry.indices.offset * index_size_), (GLint)entry.vertices.offset);
+}
+
+MeshRange
+MeshArena::mesh(uint32_t id) const {
+    const Entry &entry = entries_[id];
+    return { entry.index_count, entry.indices.offset, (int32_t)entry.vertices.offset };
+}
+
+void
+MeshArena::report() const {
+    auto fragmentation = [](const RangeAllocator &ranges) {
+        uint32_t free = ranges.capacity() - ranges.used();
+        return free ? 100.0f * (1.0f - (float)ranges.largestFree() / free) : 0.0f;
+    };
+    fprintf(stdout, "[Info] Mesh arena: %zu meshes, %u of %u vertices (%.1f KiB, %.0f%% fragmented), "
+                    "%u of %u %d-bit indices (%.1f KiB, %.0f%% fragmented), grown %zu and defragmented %zu times, "
+                    "%.1f KiB copied\n",
+            meshCount(), vertex_ranges_.used(), vertex_ranges_.capacity(),
+            vertex_ranges_.capacity() * format_.stride() / 1024.0, fragmentation(vertex_ranges_), index_ranges_.used(),
+            index_ranges_.capacity(), (int)index_size_ * 8, index_ranges_.capacity() * index_size_ / 1024.0,
+            fragmentation(index_ranges_), grow_count_, defragment_count_, bytes_copied_ / 1024.0);
+}
+
+}
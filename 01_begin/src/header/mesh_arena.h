@@ -0,0 +1,130 @@
+/**
+ * @file mesh_arena.h
+ * @author l1ang70
+ * @brief Static meshes sub-allocated from one vertex and one index buffer, drawn with base vertex offsets
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_MESH_ARENA_H_
+#define _OPENGL_MESH_ARENA_H_
+
+#include "range_allocator.h"
+#include "vertex_format.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace opengl {
+
+// Where one mesh lives in the buffers of a MeshArena.
+struct MeshRange {
+    uint32_t    index_count;
+    uint32_t    first_index;
+    int32_t     base_vertex;
+};
+
+// Meshes of one vertex format in a single vertex buffer and a single index buffer, each a
+// range of vertices and a range of indices handed out by a RangeAllocator, so the whole
+// scene is one vertex array binding and a draw is glDrawElementsBaseVertex at its range, or
+// one entry of a multi-draw indirect command. Indices stay relative to the mesh's first
+// vertex, so 16-bit indices serve any number of meshes of up to 65536 vertices each.
+//
+// The buffers double when a mesh does not fit, copied on the GPU, and the ranges keep their
+// offsets. remove() leaves holes that later meshes fill; defragment() packs what is left to
+// the front, which moves ranges: anything holding a MeshRange, an IndirectDrawList, has to
+// be built again when generation() changes.
+class MeshArena {
+    struct Entry {
+        RangeAllocator::Allocation  vertices;
+        RangeAllocator::Allocation  indices;
+        uint32_t                    index_count;
+        bool                        live;
+    };
+
+    VertexFormat            format_;
+    LayoutDescriptor        layout_;            // of format_
+    unsigned int            index_type_;        // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    size_t                  index_size_;
+    unsigned int            vertex_array_;      // 0 when the vertex array of the format comes from the cache
+    unsigned int            vertex_buffer_;
+    unsigned int            index_buffer_;
+    RangeAllocator          vertex_ranges_;     // in vertices
+    RangeAllocator          index_ranges_;      // in indices
+    std::vector<Entry>      entries_;
+    std::vector<uint32_t>   free_ids_;
+    uint32_t                generation_         = 0;
+    size_t                  grow_count_         = 0;
+    size_t                  defragment_count_   = 0;
+    size_t                  bytes_copied_        = 0;
+
+private:
+    MeshArena(const VertexFormat &format, unsigned int index_type, unsigned int vertex_array, unsigned int vertex_buffer,
+              unsigned int index_buffer, uint32_t vertex_capacity, uint32_t index_capacity);
+
+    // Point the vertex array of its own at the vertex and index buffers, after they change.
+    void setupVertexArray();
+
+    // Copy the ranges of the entries into a new buffer of capacity units of unit_size bytes,
+    // from their offsets in from to those in to. Returns the new buffer, 0 when it can not be made.
+    unsigned int relocate(unsigned int buffer, size_t unit_size, uint32_t capacity,
+                          const std::vector<RangeAllocator::Allocation> &from,
+                          const std::vector<RangeAllocator::Allocation> &to);
+
+    // Grow a buffer by its capacity or the units asked for, whichever is more, keeping every offset.
+    bool growVertices(uint32_t vertex_count);
+    bool growIndices(uint32_t index_count);
+
+public:
+    constexpr static uint32_t INVALID_MESH = 0xffffffffu;
+
+    // Room for vertex_capacity vertices of format and index_capacity indices to begin with.
+    // The format can not fit attributes to the bounds of its data, every mesh shares its scale
+    // and bias. Returns nullptr when it does or the buffers can not be created.
+    static MeshArena* create(const VertexFormat &format = VertexFormat::positionTexture(), uint32_t vertex_capacity = 16384,
+                             uint32_t index_capacity = 49152, bool short_indices = true);
+
+    ~MeshArena();
+
+    MeshArena(const MeshArena&) = delete;
+    MeshArena& operator=(const MeshArena&) = delete;
+
+    // Add a mesh of vertex_count vertices of format().sourceFloats() floats each, indices
+    // relative to its first vertex, packed by the format. Returns its id, INVALID_MESH when
+    // an index is out of range or the buffers can not grow.
+    uint32_t add(const float *vertices, size_t vertex_count, const uint32_t *indices, size_t index_count);
+
+    // Give the ranges of mesh id back. The id may be handed out again by add().
+    void remove(uint32_t id);
+
+    // Move every mesh to the front of the buffers, closing the holes remove() left. Returns the
+    // bytes copied, 0 when there was nothing to close.
+    size_t defragment();
+
+    // Bind the vertex array and both buffers through the render state cache.
+    void bind() const;
+
+    // Draw mesh id with glDrawElementsBaseVertex.
+    void draw(uint32_t id) const;
+
+    MeshRange mesh(uint32_t id) const;
+    inline bool contains(uint32_t id) const { return id < entries_.size() && entries_[id].live; }
+    inline size_t meshCount() const { return entries_.size() - free_ids_.size(); }
+    inline unsigned int indexType() const { return index_type_; }
+    inline const VertexFormat& format() const { return format_; }
+    inline const RangeAllocator& vertexRanges() const { return vertex_ranges_; }
+    inline const RangeAllocator& indexRanges() const { return index_ranges_; }
+    // Changes every time defragment() moves the meshes.
+    inline uint32_t generation() const { return generation_; }
+
+    // Print the meshes, the use and fragmentation of both buffers, growths and defragmentations to stdout.
+    void report() const;
+};
+
+}
+
+#endif // !_OPENGL_MESH_ARENA_H_
@@ -0,0 +1,409 @@
+#include "mipmap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// SSE is in the x86-64 baseline; the AVX2 kernels, which also gather through the decode
+// table, are built with a target attribute and picked at runtime.
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define MIPMAP_SIMD 1
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace opengl {
+
+namespace {
+
+constexpr float KAISER_WIDTH    = 3.0f;     // half width, in texels of the smaller level
+constexpr float KAISER_ALPHA    = 4.0f;
+constexpr float PI              = 3.14159265358979f;
+
+// The source texels of each destination texel along one axis, count of them for every one,
+// with weights summing to 1. Texels past the edge are clamped to it.
+struct Taps {
+    int                 count   = 0;
+    std::vector<int>    first;      // per destination texel, before clamping
+    std::vector<int>    index;      // count per destination texel
+    std::vector<float>  weight;
+};
+
+float
+besselI0(float x) {
+    float sum = 1.0f, term = 1.0f;
+    for (int k = 1; k < 16; k++) {
+        term *= (x * 0.5f / k) * (x * 0.5f / k);
+        sum += term;
+    }
+    return sum;
+}
+
+// t in texels of the destination.
+float
+kaiserSinc(float t) {
+    if (std::fabs(t) >= KAISER_WIDTH)
+        return 0.0f;
+    float sinc = t == 0.0f ? 1.0f : std::sin(PI * t) / (PI * t);
+    float x = t / KAISER_WIDTH;
+    return sinc * besselI0(KAISER_ALPHA * std::sqrt(1.0f - x * x)) / besselI0(KAISER_ALPHA);
+}
+
+Taps
+makeTaps(int src, int dst, MipFilter filter) {
+    float scale = (float)src / dst;
+    float radius = filter == BOX_FILTER ? scale * 0.5f : KAISER_WIDTH * scale;
+    Taps taps;
+    taps.first.resize(dst);
+    for (int x = 0; x < dst; x++) {
+        float center = (x + 0.5f) * scale;
+        int first = (int)std::floor(center - radius);
+        int end = (int)std::ceil(center + radius);
+        taps.first[x] = first;
+        taps.count = std::max(taps.count, end - first);
+    }
+
+    taps.index.resize((size_t)dst * taps.count);
+    taps.weight.resize((size_t)dst * taps.count);
+    for (int x = 0; x < dst; x++) {
+        float center = (x + 0.5f) * scale;
+        float low = center - radius, high = center + radius;
+        int *index = &taps.index[(size_t)x * taps.count];
+        float *weight = &taps.weight[(size_t)x * taps.count];
+        float sum = 0.0f;
+        for (int k = 0; k < taps.count; k++) {
+            int i = taps.first[x] + k;
+            if (filter == BOX_FILTER)
+                weight[k] = std::max(0.0f, std::min(i + 1.0f, high) - std::max((float)i, low));
+            else
+                weight[k] = kaiserSinc((i + 0.5f - center) / scale);
+            index[k] = std::min(std::max(i, 0), src - 1);
+            sum += weight[k];
+        }
+        for (int k = 0; k < taps.count; k++)
+            weight[k] /= sum;
+    }
+    return taps;
+}
+
+float
+srgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+constexpr int ENCODE_BUCKETS = 4096;
+
+// Decoding of every byte value, and the linear values where the nearest sRGB byte steps up.
+// Encoding splits [0, 1] into buckets narrower than the closest two thresholds, 1 / 3295 apart
+// at the dark end, so the byte is that of the bucket start or one more: no search to mispredict.
+struct SrgbTables {
+    float   linear[256];
+    float   srgb[256];
+    float   threshold[256];         // the last one past any value
+    uint8_t bucket[ENCODE_BUCKETS];
+
+    SrgbTables() {
+        for (int i = 0; i < 256; i++) {
+            linear[i] = i / 255.0f;
+            srgb[i] = srgbToLinear(i / 255.0f);
+            threshold[i] = i < 255 ? srgbToLinear((i + 0.5f) / 255.0f) : 2.0f;
+        }
+        int byte = 0;
+        for (int b = 0; b < ENCODE_BUCKETS; b++) {
+            while (threshold[byte] <= (float)b / ENCODE_BUCKETS)
+                byte++;
+            bucket[b] = (uint8_t)byte;
+        }
+    }
+
+    inline uint8_t encode(float value) const {
+        int b = std::min(std::max((int)(value * ENCODE_BUCKETS), 0), ENCODE_BUCKETS - 1);
+        int byte = bucket[b];
+        return (uint8_t)(byte + (value >= threshold[byte]));
+    }
+};
+
+const SrgbTables&
+srgbTables() {
+    static const SrgbTables s_tables;
+    return s_tables;
+}
+
+// What one downsample() works with: the decode table per channel, 4 x 256 so that the
+// AVX2 kernel gathers from it by byte plus 256 times the channel.
+struct Level {
+    const uint8_t   *src;
+    int             src_width;
+    int             channels;
+    bool            srgb[4];
+    float           decode[4 * 256];
+};
+
+// begin falls on a texel boundary.
+void
+decodeScalar(const Level &level, const uint8_t *in, float *out, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i += level.channels) {
+        for (int c = 0; c < level.channels; c++)
+            out[i + c] = level.decode[c * 256 + in[i + c]];
+    }
+}
+
+void
+filterScalar(const float *in, const Taps &taps, int channels, float *out, int begin, int end) {
+    for (int x = begin; x < end; x++) {
+        const int *index = &taps.index[(size_t)x * taps.count];
+        const float *weight = &taps.weight[(size_t)x * taps.count];
+        for (int c = 0; c < channels; c++) {
+            float sum = 0.0f;
+            for (int k = 0; k < taps.count; k++)
+                sum += weight[k] * in[(size_t)index[k] * channels + c];
+            out[(size_t)x * channels + c] = sum;
+        }
+    }
+}
+
+void
+combineScalar(const float *const *rows, const float *weight, int count, float *out, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        float sum = 0.0f;
+        for (int k = 0; k < count; k++)
+            sum += weight[k] * rows[k][i];
+        out[i] = sum;
+    }
+}
+
+void
+encodeRow(const Level &level, const float *in, uint8_t *out, size_t count) {
+    const SrgbTables &tables = srgbTables();
+    for (size_t i = 0; i < count; i += level.channels) {
+        for (int c = 0; c < level.channels; c++) {
+            if (level.srgb[c])
+                out[i + c] = tables.encode(in[i + c]);
+            else
+                out[i + c] = (uint8_t)std::min(std::max((int)(in[i + c] * 255.0f + 0.5f), 0), 255);
+        }
+    }
+}
+
+#ifdef MIPMAP_SIMD
+
+// One RGBA texel per register, a tap at a time.
+int
+filterSSE(const float *in, const Taps &taps, float *out, int begin, int end) {
+    int x = begin;
+    for (; x < end; x++) {
+        const int *index = &taps.index[(size_t)x * taps.count];
+        const float *weight = &taps.weight[(size_t)x * taps.count];
+        __m128 sum = _mm_setzero_ps();
+        for (int k = 0; k < taps.count; k++)
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[k]), _mm_loadu_ps(in + (size_t)index[k] * 4)));
+        _mm_storeu_ps(out + (size_t)x * 4, sum);
+    }
+    return x;
+}
+
+size_t
+combineSSE(const float *const *rows, const float *weight, int count, float *out, size_t begin, size_t end) {
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (int k = 0; k < count; k++)
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[k]), _mm_loadu_ps(rows[k] + i)));
+        _mm_storeu_ps(out + i, sum);
+    }
+    return i;
+}
+
+// 8 bytes a step through the table; the channel of the first is 0 whenever 1, 2 or 4 channels
+// divide the 8, so one offset vector serves every step.
+TARGET_AVX2 size_t
+decodeAVX2(const Level &level, const uint8_t *in, float *out, size_t begin, size_t end) {
+    if (8 % level.channels != 0)
+        return begin;
+    __m256i offset = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    offset = _mm256_mullo_epi32(_mm256_and_si256(offset, _mm256_set1_epi32(level.channels - 1)), _mm256_set1_epi32(256));
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in + i)));
+        _mm256_storeu_ps(out + i, _mm256_i32gather_ps(level.decode, _mm256_add_epi32(bytes, offset), 4));
+    }
+    return i;
+}
+
+// Two RGBA texels per register, one in each lane.
+TARGET_AVX2 int
+filterAVX2(const float *in, const Taps &taps, float *out, int begin, int end) {
+    int x = begin;
+    for (; x + 2 <= end; x += 2) {
+        const int *index0 = &taps.index[(size_t)x * taps.count];
+        const int *index1 = index0 + taps.count;
+        const float *weight0 = &taps.weight[(size_t)x * taps.count];
+        const float *weight1 = weight0 + taps.count;
+        __m256 sum = _mm256_setzero_ps();
+        for (int k = 0; k < taps.count; k++) {
+            __m256 texels = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in + (size_t)index0[k] * 4)),
+                                                 _mm_loadu_ps(in + (size_t)index1[k] * 4), 1);
+            __m256 weights = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(weight0[k])),
+                                                  _mm_set1_ps(weight1[k]), 1);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(weights, texels));
+        }
+        _mm256_storeu_ps(out + (size_t)x * 4, sum);
+    }
+    return x;
+}
+
+TARGET_AVX2 size_t
+combineAVX2(const float *const *rows, const float *weight, int count, float *out, size_t begin, size_t end) {
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 sum = _mm256_setzero_ps();
+        for (int k = 0; k < count; k++)
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weight[k]), _mm256_loadu_ps(rows[k] + i)));
+        _mm256_storeu_ps(out + i, sum);
+    }
+    return i;
+}
+
+#endif // MIPMAP_SIMD
+
+// A source row decoded and filtered across, into the ring.
+void
+filterRow(const Level &level, const Taps &taps, int dst_width, int row, std::vector<float> &decoded, float *out,
+          MipChain::Kernel kernel) {
+    size_t count = (size_t)level.src_width * level.channels;
+    const uint8_t *in = level.src + (size_t)row * count;
+    size_t done = 0;
+#ifdef MIPMAP_SIMD
+    if (kernel == MipChain::AVX2)
+        done = decodeAVX2(level, in, decoded.data(), done, count);
+#endif
+    decodeScalar(level, in, decoded.data(), done, count);
+
+    int x = 0;
+#ifdef MIPMAP_SIMD
+    if (level.channels == 4) {
+        if (kernel == MipChain::AVX2)
+            x = filterAVX2(decoded.data(), taps, out, x, dst_width);
+        if (kernel != MipChain::SCALAR)
+            x = filterSSE(decoded.data(), taps, out, x, dst_width);
+    }
+#endif
+    filterScalar(decoded.data(), taps, level.channels, out, x, dst_width);
+}
+
+}
+
+void
+MipChain::generate(const uint8_t *pixels, int width, int height, int channels, const MipOptions &options,
+                   Kernel kernel) {
+    clear();
+    if (!pixels || width <= 0 || height <= 0 || channels < 1 || channels > 4)
+        return;
+    int levels = fullLevelCount(width, height);
+    if (options.levels > 0)
+        levels = std::min(levels, options.levels);
+
+    size_t bytes = 0;
+    for (int i = 0; i < levels; i++) {
+        MipLevel level = { bytes, std::max(1, width >> i), std::max(1, height >> i) };
+        levels_.push_back(level);
+        bytes += (size_t)level.width * level.height * channels;
+    }
+    channels_ = channels;
+    data_.resize(bytes);
+    memcpy(data_.data(), pixels, (size_t)width * height * channels);
+    for (int i = 1; i < levels; i++) {
+        const MipLevel &above = levels_[i - 1], &level = levels_[i];
+        downsample(data_.data() + above.offset, above.width, above.height, channels, data_.data() + level.offset,
+                   level.width, level.height, options, kernel);
+    }
+}
+
+void
+MipChain::clear() {
+    channels_ = 0;
+    levels_.clear();
+    data_.clear();
+}
+
+int
+MipChain::fullLevelCount(int width, int height) {
+    int levels = 1;
+    while ((std::max(width, height) >> levels) > 0)
+        levels++;
+    return levels;
+}
+
+void
+MipChain::downsample(const uint8_t *src, int src_width, int src_height, int channels, uint8_t *dst, int dst_width,
+                     int dst_height, const MipOptions &options, Kernel kernel) {
+    if (kernel == BEST)
+        kernel = kernelSupported(AVX2) ? AVX2 : (kernelSupported(SSE) ? SSE : SCALAR);
+    const SrgbTables &tables = srgbTables();
+    Level level;
+    level.src = src;
+    level.src_width = src_width;
+    level.channels = channels;
+    for (int c = 0; c < 4; c++) {
+        // alpha is coverage, not light
+        level.srgb[c] = options.srgb && channels >= 3 && c < 3;
+        memcpy(level.decode + c * 256, level.srgb[c] ? tables.srgb : tables.linear, sizeof(tables.linear));
+    }
+
+    Taps across = makeTaps(src_width, dst_width, options.filter);
+    Taps down = makeTaps(src_height, dst_height, options.filter);
+    size_t row_floats = (size_t)dst_width * channels;
+    // the rows of one destination row always lie in a window of down.count source rows that
+    // only moves down, so each is filtered across once, into slot row % count
+    std::vector<float> ring(row_floats * down.count);
+    std::vector<float> decoded((size_t)src_width * channels);
+    std::vector<float> combined(row_floats);
+    std::vector<const float*> rows(down.count);
+    int next_row = 0;
+    for (int y = 0; y < dst_height; y++) {
+        int last = std::min(src_height - 1, down.first[y] + down.count - 1);
+        for (; next_row <= last; next_row++)
+            filterRow(level, across, dst_width, next_row, decoded, &ring[(next_row % down.count) * row_floats], kernel);
+
+        const int *index = &down.index[(size_t)y * down.count];
+        const float *weight = &down.weight[(size_t)y * down.count];
+        for (int k = 0; k < down.count; k++)
+            rows[k] = &ring[(index[k] % down.count) * row_floats];
+        size_t done = 0;
+#ifdef MIPMAP_SIMD
+        if (kernel == AVX2)
+            done = combineAVX2(rows.data(), weight, down.count, combined.data(), done, row_floats);
+        if (kernel != SCALAR)
+            done = combineSSE(rows.data(), weight, down.count, combined.data(), done, row_floats);
+#endif
+        combineScalar(rows.data(), weight, down.count, combined.data(), done, row_floats);
+        encodeRow(level, combined.data(), dst + (size_t)y * row_floats, row_floats);
+    }
+}
+
+bool
+MipChain::kernelSupported(Kernel kernel) {
+    switch (kernel) {
+    case SCALAR:
+    case BEST:
+        return true;
+    case SSE:
+#ifdef MIPMAP_SIMD
+        return true;
+#else
+        return false;
+#endif
+    case AVX2:
+#ifdef MIPMAP_SIMD
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+}
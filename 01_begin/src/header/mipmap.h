@@ -0,0 +1,81 @@
+/**
+ * @file mipmap.h
+ * @author l1ang70
+ * @brief Mip chains built on the CPU with SIMD box and Kaiser filters, sRGB filtered in linear light
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_MIPMAP_H_
+#define _OPENGL_MIPMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace opengl {
+
+enum MipFilter {
+    BOX_FILTER,     // the area-weighted mean of the texels each texel covers
+    KAISER_FILTER   // a Kaiser-windowed sinc, sharper than the box and without its aliasing
+};
+
+struct MipOptions {
+    MipFilter   filter  = KAISER_FILTER;
+    bool        srgb    = false;    // the color channels of 3- and 4-channel data are sRGB encoded
+    int         levels  = 0;        // level 0 included, 0 for the whole chain down to 1x1
+};
+
+struct MipLevel {
+    size_t  offset;     // into the data of the chain
+    int     width;
+    int     height;
+};
+
+// Every level of a texture, tightly packed one after the other, built without a GL context
+// so the asset threads or the cooker do it and the render thread only uploads. Each level is
+// filtered from the one above it, separably: a source row is decoded to float, linear light
+// for sRGB color and as is for alpha, filtered across, and the rows below are combined from
+// a ring of those. Edges are clamped.
+class MipChain {
+    int                     channels_   = 0;
+    std::vector<MipLevel>   levels_;
+    std::vector<uint8_t>    data_;
+
+public:
+    enum Kernel {
+        SCALAR,
+        SSE,
+        AVX2,
+        BEST        // the widest kernel this CPU runs
+    };
+
+    // Copy level 0 from tightly packed pixels of 1 to 4 channels, then filter the levels below.
+    void generate(const uint8_t *pixels, int width, int height, int channels, const MipOptions &options = MipOptions(),
+                  Kernel kernel = BEST);
+
+    void clear();
+
+    inline int channels() const { return channels_; }
+    inline int levelCount() const { return (int)levels_.size(); }
+    inline const MipLevel& level(int index) const { return levels_[index]; }
+    inline const uint8_t* pixels(int index) const { return data_.data() + levels_[index].offset; }
+    inline size_t bytes() const { return data_.size(); }
+
+    // Levels from width x height down to 1x1.
+    static int fullLevelCount(int width, int height);
+
+    // Filter one level into the next, src_width x src_height to dst_width x dst_height.
+    static void downsample(const uint8_t *src, int src_width, int src_height, int channels, uint8_t *dst,
+                           int dst_width, int dst_height, const MipOptions &options = MipOptions(),
+                           Kernel kernel = BEST);
+
+    static bool kernelSupported(Kernel kernel);
+};
+
+}
+
+#endif // !_OPENGL_MIPMAP_H_
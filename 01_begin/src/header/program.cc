@@ -1,12 +1,45 @@
 #include "program.h"
+#include "render_state.h"
 #include "shader.h"
+#include "uniform_buffer.h"
 
 #include <glad/glad.h>
 
+#include <algorithm>
 #include <cstdio>
 
 namespace opengl {
 
+namespace {
+
+// Whether a uniform of GL type |actual| may be set through the glUniform* call for |expected|.
+bool
+uniformTypeMatches(GLenum expected, GLenum actual) {
+    if (expected == actual)
+        return true;
+    if (expected != GL_INT)
+        return false;
+    // Booleans and samplers are set as plain ints too.
+    switch (actual) {
+    case GL_BOOL:
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_BUFFER:
+    case GL_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+        return true;
+    default:
+        return false;
+    }
+}
+
+}
+
 Program::Program(unsigned int program_id) 
     : program_id_(program_id) {}
 
@@ -20,7 +53,7 @@ Program::create() {
 }
 
 Program::~Program() {
-    glDeleteProgram(program_id_);
+    RenderState::current().deleteProgram(program_id_);
     program_id_ = 0;
 }
 
@@ -36,44 +69,237 @@ Program::attachShader(Shader* shader) {
 
 bool
 Program::link() {
+    submitLink();
+    return checkLink();
+}
+
+void
+Program::submitLink() {
+    link_success_ = -1;
     glLinkProgram(program_id_);
-    GLint success = 0;
-    checkInfo(GL_LINK_STATUS, &success);
-    if (!success) {
+}
+
+bool
+Program::linkCompleted() const {
+    if (link_success_ >= 0 || !Shader::parallelCompile())
+        return true;
+    GLint completed = GL_FALSE;
+    glGetProgramiv(program_id_, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+bool
+Program::checkLink() {
+    if (link_success_ >= 0)
+        return link_success_ != 0;
+
+    checkInfo(GL_LINK_STATUS, &link_success_);
+    if (!link_success_) {
+        // Compile errors surface here now, the shaders no longer wait for their status.
+        GLuint shaders[8];
+        GLsizei count = 0;
+        glGetAttachedShaders(program_id_, 8, &count, shaders);
+        for (GLsizei i = 0; i < count; ++i) {
+            GLint compiled = GL_TRUE;
+            glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &compiled);
+            if (compiled)
+                continue;
+            GLint info_len = 0;
+            glGetShaderiv(shaders[i], GL_INFO_LOG_LENGTH, &info_len);
+            // the length counts the terminator, 0 or 1 is an empty log
+            if (info_len <= 1) {
+                fprintf(stdout, "[Error] Failed to compile shader, no info log\n");
+                continue;
+            }
+            GLchar * info = new GLchar[info_len];
+            glGetShaderInfoLog(shaders[i], info_len, nullptr, info);
+            fprintf(stdout, "[Error] Failed to compile shader:\n %s\n", info);
+            delete[] info;
+        }
+
         GLint info_len = 0;
         checkInfo(GL_INFO_LOG_LENGTH, &info_len);
+        if (info_len <= 1) {
+            fprintf(stdout, "[Error] Failed to link program, no info log\n");
+            return false;
+        }
         GLchar * info = new GLchar[info_len];
         glGetProgramInfoLog(program_id_, info_len, nullptr, info);
         fprintf(stdout, "[Error] Failed to link program: %s\n", info);
         delete[] info;
         return false;
     }
+    bindUniformBlocks();
+    cacheUniforms();
+    return true;
+}
+
+void
+Program::setBinaryRetrievable(bool retrievable) {
+    glProgramParameteri(program_id_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, retrievable ? GL_TRUE : GL_FALSE);
+}
+
+bool
+Program::loadBinary(unsigned int format, const void *binary, int length) {
+    glProgramBinary(program_id_, format, binary, length);
+    checkInfo(GL_LINK_STATUS, &link_success_);
+    if (!link_success_)
+        return false;
+    bindUniformBlocks();
+    cacheUniforms();
     return true;
 }
 
+bool
+Program::binary(unsigned int &format, std::vector<char> &binary) const {
+    GLint length = 0;
+    glGetProgramiv(program_id_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+    binary.resize(length);
+    GLenum binary_format = 0;
+    glGetProgramBinary(program_id_, length, &length, &binary_format, binary.data());
+    binary.resize(length);
+    format = binary_format;
+    return length > 0;
+}
+
+void
+Program::bindUniformBlocks() {
+    // Every program reads the per-frame block from the same binding point.
+    GLuint index = glGetUniformBlockIndex(program_id_, FRAME_DATA_BLOCK);
+    if (index != GL_INVALID_INDEX)
+        glUniformBlockBinding(program_id_, index, FRAME_DATA_BINDING);
+}
+
+void
+Program::cacheUniforms() {
+    uniforms_.clear();
+
+    GLint count = 0, max_len = 0;
+    checkInfo(GL_ACTIVE_UNIFORMS, &count);
+    checkInfo(GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_len);
+    if (count <= 0)
+        return;
+
+    uniforms_.reserve(count);
+    std::string name(max_len, '\0');
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei len = 0;
+        GLint   size = 0;
+        GLenum  type = 0;
+        glGetActiveUniform(program_id_, i, max_len, &len, &size, &type, &name[0]);
+        // Uniforms inside blocks report -1 and are not set through here.
+        GLint location = glGetUniformLocation(program_id_, name.c_str());
+        if (location < 0)
+            continue;
+        // Arrays are reported as "name[0]", store them under the plain name.
+        std::string key(name.c_str(), len);
+        if (key.size() > 3 && key.compare(key.size() - 3, 3, "[0]") == 0)
+            key.resize(key.size() - 3);
+        uniforms_.push_back({ key, location, type, size });
+    }
+    std::sort(uniforms_.begin(), uniforms_.end(), 
+        [](const UniformInfo &l, const UniformInfo &r) { return l.name < r.name; });
+}
+
+const Program::UniformInfo*
+Program::findUniform(const std::string &name) const {
+    auto it = std::lower_bound(uniforms_.begin(), uniforms_.end(), name, 
+        [](const UniformInfo &info, const std::string &key) { return info.name < key; });
+    if (it == uniforms_.end() || it->name != name)
+        return nullptr;
+    return &*it;
+}
+
+bool
+Program::checkUniformType(const std::string &name, const UniformInfo *info, unsigned int type) const {
+    if (!info)
+        return false;
+    if (!uniformTypeMatches(type, info->type)) {
+        fprintf(stdout, "[Error] Uniform %s has type 0x%04X, not 0x%04X\n", name.c_str(), info->type, type);
+        return false;
+    }
+    return true;
+}
+
+int
+Program::uniformLocation(const std::string &name) const {
+    auto info = findUniform(name);
+    return info ? info->location : -1;
+}
+
+template <>
+Uniform<bool>
+Program::uniform<bool>(const std::string &name) const {
+    auto info = findUniform(name);
+    return Uniform<bool>(checkUniformType(name, info, GL_BOOL) ? info->location : -1);
+}
+
+template <>
+Uniform<int>
+Program::uniform<int>(const std::string &name) const {
+    auto info = findUniform(name);
+    return Uniform<int>(checkUniformType(name, info, GL_INT) ? info->location : -1);
+}
+
+template <>
+Uniform<float>
+Program::uniform<float>(const std::string &name) const {
+    auto info = findUniform(name);
+    return Uniform<float>(checkUniformType(name, info, GL_FLOAT) ? info->location : -1);
+}
+
+template <>
+Uniform<glm::mat4>
+Program::uniform<glm::mat4>(const std::string &name) const {
+    auto info = findUniform(name);
+    return Uniform<glm::mat4>(checkUniformType(name, info, GL_FLOAT_MAT4) ? info->location : -1);
+}
+
+void
+Program::set(Uniform<bool> handle, bool value) const {
+    glUniform1i(handle.location_, value);
+}
+
+void
+Program::set(Uniform<int> handle, int value) const {
+    glUniform1i(handle.location_, value);
+}
+
+void
+Program::set(Uniform<float> handle, float value) const {
+    glUniform1f(handle.location_, value);
+}
+
+void
+Program::set(Uniform<glm::mat4> handle, const glm::mat4 &value) const {
+    glUniformMatrix4fv(handle.location_, 1, GL_FALSE, &value[0][0]);
+}
+
 void
 Program::setParam1(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(program_id_, name.c_str()), value);
+    glUniform1i(uniformLocation(name), value);
 }
 
 void
 Program::setParam1(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(program_id_, name.c_str()), value);
+    glUniform1i(uniformLocation(name), value);
 }
 
 void
 Program::setParam1(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(program_id_, name.c_str()), value);
+    glUniform1f(uniformLocation(name), value);
 }
 
 void 
 Program::setMatrix4(const std::string &name, glm::mat4 value) const {
-    glUniformMatrix4fv(glGetUniformLocation(program_id_, name.c_str()), 1, GL_FALSE, &value[0][0]);
+    glUniformMatrix4fv(uniformLocation(name), 1, GL_FALSE, &value[0][0]);
 }
 
 void
 Program::use() {
-    glUseProgram(program_id_);
+    RenderState::current().useProgram(program_id_);
 }
 
 }
@@ -13,18 +13,53 @@
 #define _OPENGL_PROGRAM_H_
 
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace opengl {
 
 class Shader;
+class Program;
+
+// A uniform location resolved once through Program::uniform<T>(), so the per-frame path
+// does neither a string lookup nor a driver query. T is the C++ type the uniform is set with.
+template <typename T>
+class Uniform {
+    friend class Program;
+
+    int location_ = -1;
+
+    explicit Uniform(int location) : location_(location) {}
+
+public:
+    Uniform() = default;
+
+    inline bool isValid() const { return location_ >= 0; }
+    inline int location() const { return location_; }
+};
 
 class Program {
-    unsigned int program_id_ = 0;
+    struct UniformInfo {
+        std::string     name;
+        int             location;
+        unsigned int    type;
+        int             size;
+    };
+
+    unsigned int program_id_    = 0;
+    int          link_success_  = -1;   // -1 until the status has been queried
     
+    // Active uniforms of the linked program, sorted by name. Filled once in link().
+    std::vector<UniformInfo> uniforms_;
+
 private:
     Program(unsigned int program_id = 0);
 
+    void bindUniformBlocks();
+    void cacheUniforms();
+    const UniformInfo* findUniform(const std::string &name) const;
+    bool checkUniformType(const std::string &name, const UniformInfo *info, unsigned int type) const;
+
 public:
     static Program* create();
 
@@ -36,8 +71,41 @@ public:
 
     void attachShader(Shader* shader);
     
+    // Link and wait for the result, the same as submitLink() followed by checkLink().
     bool link();
 
+    // Start linking without waiting for it, see ProgramBatch.
+    void submitLink();
+
+    // Non-blocking: false while the driver is still linking. Always true without Shader::parallelCompile().
+    bool linkCompleted() const;
+
+    // Query the link status once, printing the info logs on failure. Blocks until linked.
+    bool checkLink();
+
+    inline bool isLinked() const { return link_success_ > 0; }
+
+    // Ask the driver to keep the linked binary retrievable, call it before link().
+    void setBinaryRetrievable(bool retrievable);
+
+    // Load a binary from binary(), returns false if the driver rejects it (e.g. after an update).
+    bool loadBinary(unsigned int format, const void *binary, int length);
+
+    // The driver binary of the linked program.
+    bool binary(unsigned int &format, std::vector<char> &binary) const;
+
+    // Location of an active uniform from the table built at link time, -1 if it is not active.
+    int uniformLocation(const std::string &name) const;
+
+    // Resolve a typed handle once, then pass it to set() every frame.
+    template <typename T>
+    Uniform<T> uniform(const std::string &name) const;
+
+    void set(Uniform<bool> handle, bool value) const;
+    void set(Uniform<int> handle, int value) const;
+    void set(Uniform<float> handle, float value) const;
+    void set(Uniform<glm::mat4> handle, const glm::mat4 &value) const;
+
     void setParam1(const std::string &name, bool value) const;
     void setParam1(const std::string &name, int value) const;
     void setParam1(const std::string &name, float value) const;
@@ -47,6 +115,11 @@ public:
     void use();
 };
 
+template <> Uniform<bool> Program::uniform<bool>(const std::string &name) const;
+template <> Uniform<int> Program::uniform<int>(const std::string &name) const;
+template <> Uniform<float> Program::uniform<float>(const std::string &name) const;
+template <> Uniform<glm::mat4> Program::uniform<glm::mat4>(const std::string &name) const;
+
 }
 
 #endif // !_OPENGL_PROGRAM_H_
\ No newline at end of file
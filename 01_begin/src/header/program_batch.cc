@@ -0,0 +1,83 @@
+#include "program_batch.h"
+#include "program.h"
+
+#include <glad/glad.h>
+
+namespace opengl {
+
+ProgramBatch::ProgramBatch() {
+    // Let the driver pick how many threads it compiles on.
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    else if (GLAD_GL_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+}
+
+ProgramBatch::~ProgramBatch() {
+    // The caller owns the programs and may have deleted them already, so the pending ones are
+    // left alone; only the shaders go. Such a program reports its status on its own checkLink().
+    entries_.clear();
+}
+
+Program*
+ProgramBatch::add(const std::vector<std::pair<std::string, ShaderType>> &sources) {
+    Program *program = Program::create();
+    if (!program)
+        return nullptr;
+
+    Entry entry{ program, {}, false };
+    for (auto &source : sources) {
+        entry.shaders.emplace_back(Shader::createFromSource(source.first, source.second));
+        program->attachShader(entry.shaders.back().get());
+    }
+    // Linking right after the compiles is fine, the driver orders them itself.
+    program->submitLink();
+    entries_.push_back(std::move(entry));
+    ++pending_;
+    return program;
+}
+
+Program*
+ProgramBatch::add(const std::string &vertex_path, const std::string &fragment_path) {
+    std::string vertex_source, fragment_source;
+    if (!Shader::readSource(vertex_path.c_str(), vertex_source) 
+        || !Shader::readSource(fragment_path.c_str(), fragment_source))
+        return nullptr;
+    return add({ { vertex_source, VERTEX_SHADER }, { fragment_source, FRAGMENT_SHADER } });
+}
+
+void
+ProgramBatch::complete(Entry &entry) {
+    if (!entry.program->checkLink())
+        ++failed_;
+    // The program keeps what it needs, the shader objects can go.
+    entry.shaders.clear();
+    entry.done = true;
+    --pending_;
+}
+
+bool
+ProgramBatch::poll() {
+    // Without the extension the status can only be had by waiting for it.
+    if (!Shader::parallelCompile()) {
+        finish();
+        return true;
+    }
+    for (auto &entry : entries_) {
+        if (!entry.done && entry.program->linkCompleted())
+            complete(entry);
+    }
+    return pending_ == 0;
+}
+
+bool
+ProgramBatch::finish() {
+    for (auto &entry : entries_) {
+        if (!entry.done)
+            complete(entry);
+    }
+    entries_.clear();
+    return failed_ == 0;
+}
+
+}
\ No newline at end of file
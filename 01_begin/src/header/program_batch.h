@@ -0,0 +1,69 @@
+/**
+ * @file program_batch.h
+ * @author l1ang70
+ * @brief Compile and link many programs without waiting on each one
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_PROGRAM_BATCH_H_
+#define _OPENGL_PROGRAM_BATCH_H_
+
+#include "shader.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace opengl {
+
+class Program;
+
+// Submits every shader compile and program link first and checks their status later, so a
+// driver with GL_KHR/ARB_parallel_shader_compile works on all of them across its threads.
+// Without the extension the status can not be had without waiting, so poll() acts as finish().
+class ProgramBatch {
+    struct Entry {
+        Program                             *program;
+        std::vector<std::unique_ptr<Shader>> shaders;
+        bool                                 done;
+    };
+
+    std::vector<Entry>  entries_;
+    size_t              pending_    = 0;
+    size_t              failed_     = 0;
+
+private:
+    void complete(Entry &entry);
+
+public:
+    ProgramBatch();
+    // Drops what is still pending without touching the programs, which may be gone by then:
+    // call finish() first to have every program checked.
+    ~ProgramBatch();
+
+    // Queue a program built from in-memory sources. The caller owns the returned program,
+    // it is usable once poll() returned true or finish() was called.
+    Program* add(const std::vector<std::pair<std::string, ShaderType>> &sources);
+
+    // Queue a program from a vertex and a fragment shader file, nullptr if one can not be read.
+    Program* add(const std::string &vertex_path, const std::string &fragment_path);
+
+    // Non-blocking: check the programs the driver has finished, true once none is pending.
+    // Programs that failed are counted in failed().
+    bool poll();
+
+    // Wait for every queued program. Returns false if any failed to compile or link.
+    bool finish();
+
+    inline size_t pending() const { return pending_; }
+    inline size_t failed() const { return failed_; }
+};
+
+}
+
+#endif // !_OPENGL_PROGRAM_BATCH_H_
\ No newline at end of file
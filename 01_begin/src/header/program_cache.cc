@@ -0,0 +1,188 @@
+#include "program_cache.h"
+#include "program.h"
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+namespace opengl {
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC     = 0x43504C56;  // "VLPC"
+constexpr uint32_t CACHE_VERSION   = 1;
+
+struct CacheHeader {
+    uint32_t    magic;
+    uint32_t    version;
+    uint64_t    key;
+    uint32_t    format;
+    uint32_t    length;
+    double      compile_ms;     // what the full compile of this entry cost when it was stored
+};
+
+// 64-bit FNV-1a, stable across runs and platforms.
+uint64_t
+hashBytes(uint64_t hash, const void *data, size_t size) {
+    auto bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+double
+millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+ProgramCache::ProgramCache(const std::string &directory) 
+    : directory_(directory) {}
+
+void
+ProgramCache::queryDriver() {
+    if (!driver_key_.empty())
+        return;
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    enabled_ = formats > 0;
+
+    auto str = [](GLenum name) {
+        auto value = reinterpret_cast<const char *>(glGetString(name));
+        return std::string(value ? value : "");
+    };
+    driver_key_ = str(GL_VENDOR) + "|" + str(GL_RENDERER) + "|" + str(GL_VERSION);
+
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    if (error) {
+        fprintf(stdout, "[Error] Can not create program cache %s: %s\n", directory_.c_str(), error.message().c_str());
+        enabled_ = false;
+    }
+}
+
+std::string
+ProgramCache::entryPath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+Program*
+ProgramCache::loadEntry(uint64_t key) {
+    std::ifstream file(entryPath(key), std::ios::binary);
+    if (!file)
+        return nullptr;
+
+    CacheHeader header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))
+        || header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.key != key)
+        return nullptr;
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size()))
+        return nullptr;
+
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<Program> program(Program::create());
+    if (!program || !program->loadBinary(header.format, binary.data(), (int)binary.size())) {
+        ++rejected_;
+        return nullptr;
+    }
+    hit_compile_ms_ += header.compile_ms;
+    hit_binary_ms_ += millisecondsSince(start);
+    return program.release();
+}
+
+void
+ProgramCache::storeEntry(uint64_t key, Program *program, double compile_ms) {
+    CacheHeader header{ CACHE_MAGIC, CACHE_VERSION, key, 0, 0, compile_ms };
+    std::vector<char> binary;
+    if (!program->binary(header.format, binary))
+        return;
+    header.length = (uint32_t)binary.size();
+
+    // Write to a temporary name first, so a crash never leaves a torn entry behind.
+    auto path = entryPath(key);
+    auto temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(binary.data(), binary.size());
+        if (!file)
+            return;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+}
+
+Program*
+ProgramCache::load(const std::vector<std::pair<std::string, ShaderType>> &shader_paths) {
+    auto start = std::chrono::steady_clock::now();
+    queryDriver();
+
+    std::vector<std::string> sources(shader_paths.size());
+    uint64_t key = hashBytes(0xCBF29CE484222325ull, driver_key_.data(), driver_key_.size());
+    for (size_t i = 0; i < shader_paths.size(); ++i) {
+        if (!Shader::readSource(shader_paths[i].first.c_str(), sources[i]))
+            return nullptr;
+        int type = shader_paths[i].second;
+        key = hashBytes(key, &type, sizeof(type));
+        key = hashBytes(key, sources[i].data(), sources[i].size() + 1);
+    }
+
+    if (enabled_) {
+        if (auto program = loadEntry(key)) {
+            ++hits_;
+            load_ms_ += millisecondsSince(start);
+            return program;
+        }
+    }
+    ++misses_;
+
+    auto compile_start = std::chrono::steady_clock::now();
+    Program *program = Program::create();
+    if (!program)
+        return nullptr;
+    {
+        std::vector<std::unique_ptr<Shader>> shaders;
+        for (size_t i = 0; i < sources.size(); ++i) {
+            shaders.emplace_back(Shader::createFromSource(sources[i], shader_paths[i].second));
+            program->attachShader(shaders.back().get());
+        }
+        if (enabled_)
+            program->setBinaryRetrievable(true);
+        if (!program->link()) {
+            delete program;
+            return nullptr;
+        }
+    }
+    double compile_ms = millisecondsSince(compile_start);
+    if (enabled_)
+        storeEntry(key, program, compile_ms);
+
+    load_ms_ += millisecondsSince(start);
+    return program;
+}
+
+Program*
+ProgramCache::load(const std::string &vertex_path, const std::string &fragment_path) {
+    return load({ { vertex_path, VERTEX_SHADER }, { fragment_path, FRAGMENT_SHADER } });
+}
+
+void
+ProgramCache::report() const {
+    fprintf(stdout, "[Info] Program cache: %d hits, %d misses (%.0f%% hit rate), %d rejected, "
+                    "%.2f ms loading, hits in %.2f ms instead of %.2f ms compiling (%.2f ms saved)\n",
+            hits_, misses_, hitRate() * 100.0, rejected_, load_ms_, hit_binary_ms_, hit_compile_ms_,
+            savedMilliseconds());
+}
+
+}
\ No newline at end of file
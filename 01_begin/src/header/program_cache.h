@@ -0,0 +1,68 @@
+/**
+ * @file program_cache.h
+ * @author l1ang70
+ * @brief The on-disk cache of linked program binaries
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_PROGRAM_CACHE_H_
+#define _OPENGL_PROGRAM_CACHE_H_
+
+#include "shader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace opengl {
+
+class Program;
+
+// Caches glGetProgramBinary output under a directory, keyed by a hash of the shader
+// sources plus the driver vendor, renderer and version. A binary the driver rejects
+// falls back to a full compile and is written again.
+class ProgramCache {
+    std::string directory_;
+    std::string driver_key_{};
+    bool        enabled_    = true;
+
+    // Statistics of this run.
+    int         hits_       = 0;
+    int         misses_     = 0;
+    int         rejected_   = 0;
+    double      load_ms_    = 0.0;  // time spent in load() in total
+    double      hit_compile_ms_ = 0.0;  // recorded compile time of the hits
+    double      hit_binary_ms_  = 0.0;  // time their binaries took to load instead
+
+private:
+    void queryDriver();
+    std::string entryPath(uint64_t key) const;
+    Program* loadEntry(uint64_t key);
+    void storeEntry(uint64_t key, Program *program, double compile_ms);
+
+public:
+    explicit ProgramCache(const std::string &directory);
+
+    // Build a program from shader files, reusing the cached binary when there is a valid one.
+    Program* load(const std::vector<std::pair<std::string, ShaderType>> &shader_paths);
+    Program* load(const std::string &vertex_path, const std::string &fragment_path);
+
+    inline int hits() const { return hits_; }
+    inline int misses() const { return misses_; }
+    inline double hitRate() const { return hits_ + misses_ ? (double)hits_ / (hits_ + misses_) : 0.0; }
+    // Compile time the hits saved, 0 when their binaries were slower to load, e.g. from a cold disk.
+    inline double savedMilliseconds() const { return std::max(hit_compile_ms_ - hit_binary_ms_, 0.0); }
+
+    // Print hit rate, and the load time of the hits next to their compile time, to stdout.
+    void report() const;
+};
+
+}
+
+#endif // !_OPENGL_PROGRAM_CACHE_H_
\ No newline at end of file
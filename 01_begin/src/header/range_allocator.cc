@@ -0,0 +1,240 @@
+#include "range_allocator.h"
+
+namespace opengl {
+
+namespace {
+
+inline uint32_t
+highestBit(uint32_t value) {
+    return 31 - (uint32_t)__builtin_clz(value);
+}
+
+inline uint32_t
+lowestBit(uint32_t value) {
+    return (uint32_t)__builtin_ctz(value);
+}
+
+}
+
+RangeAllocator::RangeAllocator(uint32_t capacity) {
+    reset(capacity);
+}
+
+uint32_t
+RangeAllocator::binFloor(uint32_t size) {
+    if (size < SECOND_LEVEL_COUNT)
+        return size;
+    uint32_t top = highestBit(size);
+    uint32_t first = top - SECOND_LEVEL_BITS + 1;
+    uint32_t second = (size >> (top - SECOND_LEVEL_BITS)) & (SECOND_LEVEL_COUNT - 1);
+    return first * SECOND_LEVEL_COUNT + second;
+}
+
+uint32_t
+RangeAllocator::binCeil(uint32_t size) {
+    if (size < SECOND_LEVEL_COUNT)
+        return size;
+    // round up to the next step, past the top bin when there is none
+    uint64_t step = 1ull << (highestBit(size) - SECOND_LEVEL_BITS);
+    uint64_t rounded = ((uint64_t)size + step - 1) & ~(step - 1);
+    if (rounded > 0xffffffffull)
+        return BIN_COUNT;
+    return binFloor((uint32_t)rounded);
+}
+
+void
+RangeAllocator::reset(uint32_t capacity) {
+    nodes_.clear();
+    unused_nodes_.clear();
+    for (auto &bin : bins_)
+        bin = INVALID;
+    first_level_ = 0;
+    for (auto &mask : second_level_)
+        mask = 0;
+    capacity_ = capacity;
+    used_ = 0;
+    free_ranges_ = 0;
+    allocations_ = 0;
+    last_ = INVALID;
+    if (capacity > 0) {
+        last_ = newNode(0, capacity, INVALID, INVALID);
+        insertFree(last_);
+    }
+}
+
+uint32_t
+RangeAllocator::newNode(uint32_t offset, uint32_t size, uint32_t previous, uint32_t next) {
+    Node node = { offset, size, previous, next, INVALID, INVALID, false };
+    if (!unused_nodes_.empty()) {
+        uint32_t index = unused_nodes_.back();
+        unused_nodes_.pop_back();
+        nodes_[index] = node;
+        return index;
+    }
+    nodes_.push_back(node);
+    return (uint32_t)nodes_.size() - 1;
+}
+
+void
+RangeAllocator::insertFree(uint32_t index) {
+    Node &node = nodes_[index];
+    uint32_t bin = binFloor(node.size);
+    node.used = false;
+    node.previous_free = INVALID;
+    node.next_free = bins_[bin];
+    if (bins_[bin] != INVALID)
+        nodes_[bins_[bin]].previous_free = index;
+    bins_[bin] = index;
+    first_level_ |= 1u << (bin / SECOND_LEVEL_COUNT);
+    second_level_[bin / SECOND_LEVEL_COUNT] |= 1u << (bin % SECOND_LEVEL_COUNT);
+    free_ranges_++;
+}
+
+void
+RangeAllocator::removeFree(uint32_t index) {
+    Node &node = nodes_[index];
+    uint32_t bin = binFloor(node.size);
+    if (node.previous_free != INVALID)
+        nodes_[node.previous_free].next_free = node.next_free;
+    else
+        bins_[bin] = node.next_free;
+    if (node.next_free != INVALID)
+        nodes_[node.next_free].previous_free = node.previous_free;
+    if (bins_[bin] == INVALID) {
+        uint32_t first = bin / SECOND_LEVEL_COUNT;
+        second_level_[first] &= ~(1u << (bin % SECOND_LEVEL_COUNT));
+        if (!second_level_[first])
+            first_level_ &= ~(1u << first);
+    }
+    free_ranges_--;
+}
+
+uint32_t
+RangeAllocator::findFree(uint32_t size) const {
+    // the first non-empty bin from the rounded size on, within its first level, then in a later one
+    uint32_t bin = binCeil(size);
+    if (bin < BIN_COUNT) {
+        uint32_t first = bin / SECOND_LEVEL_COUNT;
+        uint32_t second_mask = second_level_[first] & (~0u << (bin % SECOND_LEVEL_COUNT));
+        if (!second_mask) {
+            uint32_t first_mask = first + 1 < FIRST_LEVEL_COUNT ? first_level_ & (~0u << (first + 1)) : 0;
+            if (first_mask) {
+                first = lowestBit(first_mask);
+                second_mask = second_level_[first];
+            }
+        }
+        if (second_mask)
+            return bins_[first * SECOND_LEVEL_COUNT + lowestBit(second_mask)];
+    }
+    // none, but a range of the bin below may still be large enough, as the last one is when exactly full
+    for (uint32_t index = bins_[binFloor(size)]; index != INVALID; index = nodes_[index].next_free) {
+        if (nodes_[index].size >= size)
+            return index;
+    }
+    return INVALID;
+}
+
+RangeAllocator::Allocation
+RangeAllocator::allocate(uint32_t size) {
+    if (size == 0 || size > capacity_)
+        return Allocation();
+    uint32_t index = findFree(size);
+    if (index == INVALID)
+        return Allocation();
+    removeFree(index);
+
+    // the rest goes back as a free range of its own
+    if (nodes_[index].size > size) {
+        Node &node = nodes_[index];
+        uint32_t rest = newNode(node.offset + size, node.size - size, index, node.next);
+        Node &split = nodes_[index];
+        if (split.next != INVALID)
+            nodes_[split.next].previous = rest;
+        else
+            last_ = rest;
+        split.next = rest;
+        split.size = size;
+        insertFree(rest);
+    }
+    Node &node = nodes_[index];
+    node.used = true;
+    used_ += size;
+    allocations_++;
+    Allocation allocation;
+    allocation.offset = node.offset;
+    allocation.size = size;
+    allocation.node = index;
+    return allocation;
+}
+
+void
+RangeAllocator::free(const Allocation &allocation) {
+    if (!allocation.isValid() || allocation.node >= nodes_.size() || !nodes_[allocation.node].used)
+        return;
+    uint32_t index = allocation.node;
+    used_ -= nodes_[index].size;
+    allocations_--;
+
+    // merge into the free neighbour before, then take in the one after
+    uint32_t previous = nodes_[index].previous;
+    if (previous != INVALID && !nodes_[previous].used) {
+        removeFree(previous);
+        Node &node = nodes_[index];
+        nodes_[previous].size += node.size;
+        nodes_[previous].next = node.next;
+        if (node.next != INVALID)
+            nodes_[node.next].previous = previous;
+        else
+            last_ = previous;
+        unused_nodes_.push_back(index);
+        index = previous;
+    }
+    uint32_t next = nodes_[index].next;
+    if (next != INVALID && !nodes_[next].used) {
+        removeFree(next);
+        Node &node = nodes_[next];
+        nodes_[index].size += node.size;
+        nodes_[index].next = node.next;
+        if (node.next != INVALID)
+            nodes_[node.next].previous = index;
+        else
+            last_ = index;
+        unused_nodes_.push_back(next);
+    }
+    insertFree(index);
+}
+
+void
+RangeAllocator::grow(uint32_t capacity) {
+    if (capacity <= capacity_)
+        return;
+    uint32_t extra = capacity - capacity_;
+    if (last_ != INVALID && !nodes_[last_].used) {
+        removeFree(last_);
+        nodes_[last_].size += extra;
+        insertFree(last_);
+    } else {
+        uint32_t node = newNode(capacity_, extra, last_, INVALID);
+        if (last_ != INVALID)
+            nodes_[last_].next = node;
+        last_ = node;
+        insertFree(node);
+    }
+    capacity_ = capacity;
+}
+
+uint32_t
+RangeAllocator::largestFree() const {
+    if (!first_level_)
+        return 0;
+    uint32_t first = highestBit(first_level_);
+    uint32_t bin = first * SECOND_LEVEL_COUNT + highestBit(second_level_[first]);
+    uint32_t largest = 0;
+    for (uint32_t index = bins_[bin]; index != INVALID; index = nodes_[index].next_free) {
+        if (nodes_[index].size > largest)
+            largest = nodes_[index].size;
+    }
+    return largest;
+}
+
+}
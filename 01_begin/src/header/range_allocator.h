@@ -0,0 +1,100 @@
+/**
+ * @file range_allocator.h
+ * @author l1ang70
+ * @brief Offset allocator over a range of units, two-level segregated fit with constant time allocate and free
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_RANGE_ALLOCATOR_H_
+#define _OPENGL_RANGE_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace opengl {
+
+// Hands out ranges of [0, capacity) units, vertices or indices of a GL buffer, and owns no
+// memory itself. Free ranges sit in bins by size, a first level per power of two split into
+// SECOND_LEVEL_COUNT linear steps (TLSF, Masmano et al. 2004), with a bitmap over each level:
+// allocate() finds a bin whose every range fits with two bit scans and splits the first
+// range there, free() merges a range with its free neighbours. Both are O(1). Only when no
+// such bin is left does allocate() look through the ranges of the bin below, so a free range
+// exactly the size asked for is still found.
+class RangeAllocator {
+public:
+    constexpr static uint32_t INVALID = 0xffffffffu;
+
+    struct Allocation {
+        uint32_t    offset  = INVALID;
+        uint32_t    size    = 0;
+        uint32_t    node    = INVALID;  // for free()
+
+        inline bool isValid() const { return offset != INVALID; }
+    };
+
+private:
+    constexpr static int        SECOND_LEVEL_BITS   = 3;
+    constexpr static uint32_t   SECOND_LEVEL_COUNT  = 1u << SECOND_LEVEL_BITS;
+    constexpr static uint32_t   FIRST_LEVEL_COUNT   = 32 - SECOND_LEVEL_BITS + 1;
+    constexpr static uint32_t   BIN_COUNT           = FIRST_LEVEL_COUNT * SECOND_LEVEL_COUNT;
+
+    // A range, free or used, linked to its neighbours in the units and, when free, in its bin.
+    struct Node {
+        uint32_t    offset;
+        uint32_t    size;
+        uint32_t    previous;
+        uint32_t    next;
+        uint32_t    previous_free;
+        uint32_t    next_free;
+        bool        used;
+    };
+
+    std::vector<Node>       nodes_;
+    std::vector<uint32_t>   unused_nodes_;
+    uint32_t                bins_[BIN_COUNT];
+    uint32_t                first_level_;
+    uint32_t                second_level_[FIRST_LEVEL_COUNT];
+    uint32_t                last_;          // the node ending at capacity_
+    uint32_t                capacity_;
+    uint32_t                used_;
+    uint32_t                free_ranges_;
+    uint32_t                allocations_;
+
+private:
+    uint32_t newNode(uint32_t offset, uint32_t size, uint32_t previous, uint32_t next);
+    void insertFree(uint32_t node);
+    void removeFree(uint32_t node);
+    uint32_t findFree(uint32_t size) const;
+
+public:
+    explicit RangeAllocator(uint32_t capacity = 0);
+
+    // Forget every allocation, one free range of capacity.
+    void reset(uint32_t capacity);
+
+    // size units, an invalid allocation when no free range fits.
+    Allocation allocate(uint32_t size);
+    void free(const Allocation &allocation);
+
+    // Extend the range to capacity, at least the current one. Allocations keep their offsets.
+    void grow(uint32_t capacity);
+
+    inline uint32_t capacity() const { return capacity_; }
+    inline uint32_t used() const { return used_; }
+    inline uint32_t allocationCount() const { return allocations_; }
+    inline uint32_t freeRangeCount() const { return free_ranges_; }
+    uint32_t largestFree() const;
+
+    // The bins a range of size goes into and the first whose ranges all fit size.
+    static uint32_t binFloor(uint32_t size);
+    static uint32_t binCeil(uint32_t size);
+};
+
+}
+
+#endif // !_OPENGL_RANGE_ALLOCATOR_H_
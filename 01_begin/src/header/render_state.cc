@@ -0,0 +1,335 @@
+#include "render_state.h"
+
+#include <glad/glad.h>
+
+#include <cstdio>
+
+namespace opengl {
+
+RenderState::RenderState() {
+    invalidate();
+}
+
+RenderState&
+RenderState::current() {
+    static RenderState s_state;
+    return s_state;
+}
+
+void
+RenderState::invalidate() {
+    program_ = vertex_array_ = active_texture_ = UNKNOWN;
+    for (auto &buffer : buffers_)
+        buffer = UNKNOWN;
+    forgetVertexArrayState();
+    for (unsigned int i = 0; i < MAX_BUFFER_BINDINGS; i++)
+        uniform_bindings_[i] = storage_bindings_[i] = { UNKNOWN, 0, -1 };
+    for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++) {
+        for (auto &texture : textures_[unit])
+            texture = UNKNOWN;
+        samplers_[unit] = UNKNOWN;
+    }
+    depth_test_ = depth_mask_ = depth_func_ = UNKNOWN;
+    blend_ = blend_src_ = blend_dst_ = UNKNOWN;
+    viewport_[0] = viewport_[1] = viewport_[2] = viewport_[3] = -1;
+    unpack_alignment_ = -1;
+}
+
+int
+RenderState::bufferSlot(unsigned int target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER:               return ARRAY_SLOT;
+    case GL_ELEMENT_ARRAY_BUFFER:       return ELEMENT_ARRAY_SLOT;
+    case GL_UNIFORM_BUFFER:             return UNIFORM_SLOT;
+    case GL_SHADER_STORAGE_BUFFER:      return SHADER_STORAGE_SLOT;
+    case GL_PIXEL_PACK_BUFFER:          return PIXEL_PACK_SLOT;
+    case GL_PIXEL_UNPACK_BUFFER:        return PIXEL_UNPACK_SLOT;
+    case GL_COPY_READ_BUFFER:           return COPY_READ_SLOT;
+    case GL_COPY_WRITE_BUFFER:          return COPY_WRITE_SLOT;
+    case GL_DRAW_INDIRECT_BUFFER:       return DRAW_INDIRECT_SLOT;
+    case GL_DISPATCH_INDIRECT_BUFFER:   return DISPATCH_INDIRECT_SLOT;
+    default:                            return -1;
+    }
+}
+
+int
+RenderState::textureSlot(unsigned int target) {
+    switch (target) {
+    case GL_TEXTURE_2D:         return TEXTURE_2D_SLOT;
+    case GL_TEXTURE_2D_ARRAY:   return TEXTURE_2D_ARRAY_SLOT;
+    case GL_TEXTURE_3D:         return TEXTURE_3D_SLOT;
+    case GL_TEXTURE_CUBE_MAP:   return TEXTURE_CUBE_MAP_SLOT;
+    default:                    return -1;
+    }
+}
+
+void
+RenderState::useProgram(unsigned int program) {
+    if (change(program_ != program)) {
+        glUseProgram(program);
+        program_ = program;
+    }
+}
+
+void
+RenderState::bindVertexArray(unsigned int vertex_array) {
+    if (change(vertex_array_ != vertex_array)) {
+        glBindVertexArray(vertex_array);
+        vertex_array_ = vertex_array;
+        forgetVertexArrayState();
+    }
+}
+
+// The element buffer and vertex buffer bindings belong to the vertex array, unknown once it changes.
+void
+RenderState::forgetVertexArrayState() {
+    buffers_[ELEMENT_ARRAY_SLOT] = UNKNOWN;
+    for (auto &binding : vertex_bindings_)
+        binding = { UNKNOWN, 0, 0 };
+}
+
+void
+RenderState::bindVertexBuffer(unsigned int binding, unsigned int buffer, ptrdiff_t offset, int stride) {
+    if (binding >= MAX_VERTEX_BINDINGS) {
+        change(true);
+        glBindVertexBuffer(binding, buffer, offset, stride);
+        return;
+    }
+    VertexBinding &bound = vertex_bindings_[binding];
+    if (change(bound.buffer != buffer || bound.offset != offset || bound.stride != stride)) {
+        glBindVertexBuffer(binding, buffer, offset, stride);
+        bound = { buffer, offset, stride };
+    }
+}
+
+void
+RenderState::bindBuffer(unsigned int target, unsigned int buffer) {
+    int slot = bufferSlot(target);
+    if (slot < 0) {
+        change(true);
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (change(buffers_[slot] != buffer)) {
+        glBindBuffer(target, buffer);
+        buffers_[slot] = buffer;
+    }
+}
+
+RenderState::IndexedBinding*
+RenderState::indexedBinding(unsigned int target, unsigned int index) {
+    if (index >= MAX_BUFFER_BINDINGS)
+        return nullptr;
+    if (target == GL_UNIFORM_BUFFER)
+        return &uniform_bindings_[index];
+    if (target == GL_SHADER_STORAGE_BUFFER)
+        return &storage_bindings_[index];
+    return nullptr;
+}
+
+void
+RenderState::bindIndexed(unsigned int target, unsigned int index, unsigned int buffer, ptrdiff_t offset, ptrdiff_t size) {
+    IndexedBinding *binding = indexedBinding(target, index);
+    bool changed = !binding || binding->buffer != buffer || binding->offset != offset || binding->size != size;
+    if (!change(changed))
+        return;
+    if (size < 0)
+        glBindBufferBase(target, index, buffer);
+    else
+        glBindBufferRange(target, index, buffer, offset, size);
+    if (binding)
+        *binding = { buffer, offset, size };
+    // both calls also bind the buffer to the generic binding point of the target
+    int slot = bufferSlot(target);
+    if (slot >= 0)
+        buffers_[slot] = buffer;
+}
+
+void
+RenderState::bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer) {
+    bindIndexed(target, index, buffer, 0, -1);
+}
+
+void
+RenderState::bindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, ptrdiff_t offset, ptrdiff_t size) {
+    bindIndexed(target, index, buffer, offset, size);
+}
+
+void
+RenderState::bindTexture(unsigned int unit, unsigned int target, unsigned int texture) {
+    int slot = textureSlot(target);
+    bool cached = unit < MAX_TEXTURE_UNITS && slot >= 0;
+    if (!change(!cached || textures_[unit][slot] != texture))
+        return;
+    if (active_texture_ != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        active_texture_ = unit;
+    }
+    glBindTexture(target, texture);
+    if (cached)
+        textures_[unit][slot] = texture;
+}
+
+void
+RenderState::bindSampler(unsigned int unit, unsigned int sampler) {
+    bool cached = unit < MAX_TEXTURE_UNITS;
+    if (change(!cached || samplers_[unit] != sampler)) {
+        glBindSampler(unit, sampler);
+        if (cached)
+            samplers_[unit] = sampler;
+    }
+}
+
+void
+RenderState::setDepthTest(bool enabled) {
+    if (change(depth_test_ != (unsigned int)enabled)) {
+        if (enabled)
+            glEnable(GL_DEPTH_TEST);
+        else
+            glDisable(GL_DEPTH_TEST);
+        depth_test_ = enabled;
+    }
+}
+
+void
+RenderState::setDepthMask(bool write) {
+    if (change(depth_mask_ != (unsigned int)write)) {
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+        depth_mask_ = write;
+    }
+}
+
+void
+RenderState::setDepthFunc(unsigned int func) {
+    if (change(depth_func_ != func)) {
+        glDepthFunc(func);
+        depth_func_ = func;
+    }
+}
+
+void
+RenderState::setBlend(bool enabled) {
+    if (change(blend_ != (unsigned int)enabled)) {
+        if (enabled)
+            glEnable(GL_BLEND);
+        else
+            glDisable(GL_BLEND);
+        blend_ = enabled;
+    }
+}
+
+void
+RenderState::setBlendFunc(unsigned int src, unsigned int dst) {
+    if (change(blend_src_ != src || blend_dst_ != dst)) {
+        glBlendFunc(src, dst);
+        blend_src_ = src;
+        blend_dst_ = dst;
+    }
+}
+
+void
+RenderState::setViewport(int x, int y, int width, int height) {
+    bool changed = viewport_[0] != x || viewport_[1] != y || viewport_[2] != width || viewport_[3] != height;
+    if (change(changed)) {
+        glViewport(x, y, width, height);
+        viewport_[0] = x;
+        viewport_[1] = y;
+        viewport_[2] = width;
+        viewport_[3] = height;
+    }
+}
+
+void
+RenderState::setUnpackAlignment(int alignment) {
+    if (change(unpack_alignment_ != alignment)) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        unpack_alignment_ = alignment;
+    }
+}
+
+void
+RenderState::deleteProgram(unsigned int program) {
+    if (!program)
+        return;
+    glDeleteProgram(program);
+    // a current program is only flagged for deletion and stays in use, make the next use() reach GL
+    if (program_ == program)
+        program_ = UNKNOWN;
+}
+
+void
+RenderState::deleteVertexArray(unsigned int vertex_array) {
+    if (!vertex_array)
+        return;
+    glDeleteVertexArrays(1, &vertex_array);
+    if (vertex_array_ == vertex_array) {
+        vertex_array_ = 0;
+        forgetVertexArrayState();
+    }
+}
+
+void
+RenderState::deleteBuffer(unsigned int buffer) {
+    if (!buffer)
+        return;
+    glDeleteBuffers(1, &buffer);
+    for (auto &bound : buffers_) {
+        if (bound == buffer)
+            bound = 0;
+    }
+    // GL detaches it from the bound vertex array only
+    for (auto &binding : vertex_bindings_) {
+        if (binding.buffer == buffer)
+            binding = { 0, 0, 0 };
+    }
+    for (unsigned int i = 0; i < MAX_BUFFER_BINDINGS; i++) {
+        if (uniform_bindings_[i].buffer == buffer)
+            uniform_bindings_[i] = { 0, 0, -1 };
+        if (storage_bindings_[i].buffer == buffer)
+            storage_bindings_[i] = { 0, 0, -1 };
+    }
+}
+
+void
+RenderState::deleteTexture(unsigned int texture) {
+    if (!texture)
+        return;
+    glDeleteTextures(1, &texture);
+    for (auto &unit : textures_) {
+        for (auto &bound : unit) {
+            if (bound == texture)
+                bound = 0;
+        }
+    }
+}
+
+void
+RenderState::deleteSampler(unsigned int sampler) {
+    if (!sampler)
+        return;
+    glDeleteSamplers(1, &sampler);
+    for (auto &bound : samplers_) {
+        if (bound == sampler)
+            bound = 0;
+    }
+}
+
+void
+RenderState::endFrame() {
+    total_counters_.issued += frame_counters_.issued;
+    total_counters_.elided += frame_counters_.elided;
+    last_frame_counters_ = frame_counters_;
+    frame_counters_.reset();
+    frames_++;
+}
+
+void
+RenderState::report() const {
+    if (frames_ == 0 || total_counters_.total() == 0)
+        return;
+    fprintf(stdout, "[Info] Render state: %.1f calls issued and %.1f elided per frame, %.1f%% elided\n",
+            (double)total_counters_.issued / frames_, (double)total_counters_.elided / frames_,
+            100.0 * total_counters_.elided / total_counters_.total());
+}
+
+}
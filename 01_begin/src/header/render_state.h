@@ -0,0 +1,177 @@
+/**
+ * @file render_state.h
+ * @author l1ang70
+ * @brief Shadow copy of the GL binding and fixed-function state, dropping redundant calls
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_RENDER_STATE_H_
+#define _OPENGL_RENDER_STATE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace opengl {
+
+// GL calls that went through the cache, either passed on to the driver or dropped because
+// the state was already set.
+struct StateCounters {
+    uint64_t issued = 0;
+    uint64_t elided = 0;
+
+    inline uint64_t total() const { return issued + elided; }
+    inline void reset() { issued = elided = 0; }
+};
+
+// Remembers what is bound on the context and only calls GL when a request changes it.
+// Program::use() and the buffer wrappers go through it, the render loops should too.
+// Anything that changes the same state with a plain GL call has to invalidate() afterwards,
+// and objects must be deleted through it so a recycled name is not taken as still bound.
+class RenderState {
+public:
+    constexpr static unsigned int MAX_TEXTURE_UNITS    = 16;
+    constexpr static unsigned int MAX_BUFFER_BINDINGS  = 16;    // indexed uniform and storage bindings tracked
+    constexpr static unsigned int MAX_VERTEX_BINDINGS  = 4;     // vertex buffer bindings of the bound vertex array
+
+private:
+    enum BufferSlot {
+        ARRAY_SLOT,
+        ELEMENT_ARRAY_SLOT,
+        UNIFORM_SLOT,
+        SHADER_STORAGE_SLOT,
+        PIXEL_PACK_SLOT,
+        PIXEL_UNPACK_SLOT,
+        COPY_READ_SLOT,
+        COPY_WRITE_SLOT,
+        DRAW_INDIRECT_SLOT,
+        DISPATCH_INDIRECT_SLOT,
+        BUFFER_SLOT_COUNT
+    };
+
+    enum TextureSlot {
+        TEXTURE_2D_SLOT,
+        TEXTURE_2D_ARRAY_SLOT,
+        TEXTURE_3D_SLOT,
+        TEXTURE_CUBE_MAP_SLOT,
+        TEXTURE_SLOT_COUNT
+    };
+
+    struct IndexedBinding {
+        unsigned int    buffer;
+        ptrdiff_t       offset;
+        ptrdiff_t       size;       // -1 for glBindBufferBase, the whole buffer
+    };
+
+    struct VertexBinding {
+        unsigned int    buffer;
+        ptrdiff_t       offset;
+        int             stride;
+    };
+
+    // UNKNOWN never matches a request, so the next one always reaches GL.
+    constexpr static unsigned int UNKNOWN = ~0u;
+
+    unsigned int    program_                = UNKNOWN;
+    unsigned int    vertex_array_           = UNKNOWN;
+    unsigned int    buffers_[BUFFER_SLOT_COUNT];
+    IndexedBinding  uniform_bindings_[MAX_BUFFER_BINDINGS];
+    IndexedBinding  storage_bindings_[MAX_BUFFER_BINDINGS];
+    VertexBinding   vertex_bindings_[MAX_VERTEX_BINDINGS];     // state of vertex_array_, like its element buffer
+    unsigned int    active_texture_         = UNKNOWN;
+    unsigned int    textures_[MAX_TEXTURE_UNITS][TEXTURE_SLOT_COUNT];
+    unsigned int    samplers_[MAX_TEXTURE_UNITS];
+
+    unsigned int    depth_test_             = UNKNOWN;
+    unsigned int    depth_mask_             = UNKNOWN;
+    unsigned int    depth_func_             = UNKNOWN;
+    unsigned int    blend_                  = UNKNOWN;
+    unsigned int    blend_src_              = UNKNOWN;
+    unsigned int    blend_dst_              = UNKNOWN;
+    int             viewport_[4];
+    int             unpack_alignment_;
+
+    StateCounters   frame_counters_;        // since the last endFrame()
+    StateCounters   last_frame_counters_;
+    StateCounters   total_counters_;
+    uint64_t        frames_                 = 0;
+
+private:
+    RenderState();
+
+    // Count one request, true if it has to be passed on.
+    inline bool change(bool changed) {
+        if (changed)
+            frame_counters_.issued++;
+        else
+            frame_counters_.elided++;
+        return changed;
+    }
+
+    void bindIndexed(unsigned int target, unsigned int index, unsigned int buffer, ptrdiff_t offset, ptrdiff_t size);
+    IndexedBinding* indexedBinding(unsigned int target, unsigned int index);
+    void forgetVertexArrayState();
+    static int bufferSlot(unsigned int target);
+    static int textureSlot(unsigned int target);
+
+public:
+    // The state of the current context. The samples have one context and one thread, so
+    // this is a single instance; Context::create() invalidates it for the new context.
+    static RenderState& current();
+
+    RenderState(const RenderState&) = delete;
+    RenderState& operator=(const RenderState&) = delete;
+
+    // Forget everything, the next request of every kind reaches GL.
+    void invalidate();
+
+    void useProgram(unsigned int program);
+    void bindVertexArray(unsigned int vertex_array);
+
+    // Targets without a slot above are passed on uncached.
+    void bindBuffer(unsigned int target, unsigned int buffer);
+    void bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+    void bindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, ptrdiff_t offset, ptrdiff_t size);
+
+    // glBindVertexBuffer into the bound vertex array (GL 4.3 or ARB_vertex_attrib_binding).
+    // Bindings past MAX_VERTEX_BINDINGS are passed on uncached.
+    void bindVertexBuffer(unsigned int binding, unsigned int buffer, ptrdiff_t offset, int stride);
+
+    // Binds on the given unit, switching the active unit only if the binding changes.
+    void bindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+    void bindSampler(unsigned int unit, unsigned int sampler);
+
+    void setDepthTest(bool enabled);
+    void setDepthMask(bool write);
+    void setDepthFunc(unsigned int func);
+    void setBlend(bool enabled);
+    void setBlendFunc(unsigned int src, unsigned int dst);
+    void setViewport(int x, int y, int width, int height);
+    // GL_UNPACK_ALIGNMENT, the row alignment client pixels are read with.
+    void setUnpackAlignment(int alignment);
+
+    // Delete the objects and forget them wherever they are bound, as GL does.
+    void deleteProgram(unsigned int program);
+    void deleteVertexArray(unsigned int vertex_array);
+    void deleteBuffer(unsigned int buffer);
+    void deleteTexture(unsigned int texture);
+    void deleteSampler(unsigned int sampler);
+
+    // Close the frame's counters, Context::endFrame() calls it.
+    void endFrame();
+
+    inline const StateCounters& frameCounters() const { return frame_counters_; }
+    inline const StateCounters& lastFrameCounters() const { return last_frame_counters_; }
+    inline const StateCounters& totalCounters() const { return total_counters_; }
+    inline uint64_t frames() const { return frames_; }
+
+    // Print the calls issued and elided per frame to stdout.
+    void report() const;
+};
+
+}
+
+#endif // !_OPENGL_RENDER_STATE_H_
@@ -0,0 +1,167 @@
+#include "ring_buffer.h"
+#include "render_state.h"
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdio>
+
+namespace opengl {
+
+RingBuffer::RingBuffer(unsigned int buffer_id, unsigned int target, size_t segment_size, unsigned int segment_count, bool persistent)
+    : buffer_id_(buffer_id), target_(target), segment_size_(segment_size), segment_count_(segment_count),
+      persistent_(persistent), fences_(segment_count, nullptr), segment_(segment_count - 1) {}
+
+RingBuffer*
+RingBuffer::create(unsigned int target, size_t segment_size, unsigned int segment_count) {
+    if (segment_size == 0 || segment_count == 0)
+        return nullptr;
+
+    // every segment has to start at an offset that glBindBufferRange accepts
+    GLint uniform_alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_alignment);
+    size_t alignment = uniform_alignment > 256 ? (size_t)uniform_alignment : 256;
+    segment_size = (segment_size + alignment - 1) / alignment * alignment;
+
+    GLuint id = 0;
+    glGenBuffers(1, &id);
+    if (!id)
+        return nullptr;
+    RenderState &state = RenderState::current();
+    state.bindBuffer(target, id);
+
+    GLsizeiptr size = (GLsizeiptr)(segment_size * segment_count);
+    bool persistent = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+    RingBuffer *ring = new RingBuffer(id, target, segment_size, segment_count, persistent);
+    if (persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, size, nullptr, flags);
+        ring->mapped_ = static_cast<char*>(glMapBufferRange(target, 0, size, flags));
+        if (!ring->mapped_) {
+            fprintf(stdout, "[Error] Failed to map the ring buffer persistently\n");
+            delete ring;
+            return nullptr;
+        }
+    } else {
+        glBufferData(target, size, nullptr, GL_STREAM_DRAW);
+    }
+    return ring;
+}
+
+RingBuffer::~RingBuffer() {
+    for (void *fence : fences_) {
+        if (fence)
+            glDeleteSync(static_cast<GLsync>(fence));
+    }
+    if (mapped_ || frame_mapped_) {
+        RenderState::current().bindBuffer(target_, buffer_id_);
+        glUnmapBuffer(target_);
+    }
+    RenderState::current().deleteBuffer(buffer_id_);
+    buffer_id_ = 0;
+}
+
+void
+RingBuffer::waitSegment(unsigned int segment) {
+    GLsync fence = static_cast<GLsync>(fences_[segment]);
+    if (!fence)
+        return;
+    // the common case, the GPU finished this segment frames ago
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        waits_++;
+        auto start = std::chrono::steady_clock::now();
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        wait_ms_ += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (result == GL_WAIT_FAILED)
+        fprintf(stdout, "[Error] Waiting for a ring buffer segment failed\n");
+    glDeleteSync(fence);
+    fences_[segment] = nullptr;
+}
+
+void
+RingBuffer::beginFrame() {
+    if (in_frame_)
+        endFrame();
+    segment_ = (segment_ + 1) % segment_count_;
+    waitSegment(segment_);
+    head_ = 0;
+    map_begin_ = 0;
+    in_frame_ = true;
+}
+
+RingAllocation
+RingBuffer::allocate(size_t size, size_t alignment) {
+    RingAllocation allocation;
+    if (!in_frame_ || size == 0)
+        return allocation;
+    if (alignment == 0)
+        alignment = 1;
+    size_t offset = (head_ + alignment - 1) / alignment * alignment;
+    if (offset + size > segment_size_) {
+        if (overflows_++ == 0)
+            fprintf(stdout, "[Error] Ring buffer segment full: %zu + %zu > %zu bytes\n", offset, size, segment_size_);
+        return allocation;
+    }
+
+    size_t segment_offset = segment_ * segment_size_;
+    char *base = nullptr;
+    if (persistent_) {
+        base = mapped_ + segment_offset;
+    } else {
+        if (!frame_mapped_) {
+            // map the rest of the segment, unsynchronized: the fence already waited for the GPU
+            RenderState::current().bindBuffer(target_, buffer_id_);
+            map_begin_ = offset;
+            frame_mapped_ = static_cast<char*>(glMapBufferRange(target_, segment_offset + map_begin_, segment_size_ - map_begin_,
+                GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_INVALIDATE_RANGE_BIT));
+            if (!frame_mapped_) {
+                fprintf(stdout, "[Error] Failed to map the ring buffer segment\n");
+                return allocation;
+            }
+        }
+        base = frame_mapped_ - map_begin_;
+    }
+    head_ = offset + size;
+    bytes_ += size;
+    allocation.data = base + offset;
+    allocation.offset = segment_offset + offset;
+    allocation.size = size;
+    return allocation;
+}
+
+void
+RingBuffer::flush() {
+    if (!frame_mapped_)
+        return;     // coherent, or nothing written since the last flush
+    RenderState::current().bindBuffer(target_, buffer_id_);
+    if (head_ > map_begin_)
+        glFlushMappedBufferRange(target_, 0, head_ - map_begin_);
+    glUnmapBuffer(target_);
+    frame_mapped_ = nullptr;
+}
+
+void
+RingBuffer::endFrame() {
+    if (!in_frame_)
+        return;
+    flush();
+    fences_[segment_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frames_++;
+    in_frame_ = false;
+}
+
+void
+RingBuffer::report() const {
+    if (frames_ == 0)
+        return;
+    fprintf(stdout, "[Info] Ring buffer: %s, %u x %.1f KiB, %.1f KiB streamed per frame, "
+                    "%llu waits (%.2f ms), %llu overflows\n",
+            persistent_ ? "persistent" : "mapped per frame", segment_count_, segment_size_ / 1024.0,
+            bytes_ / 1024.0 / frames_, (unsigned long long)waits_, wait_ms_, (unsigned long long)overflows_);
+}
+
+}
@@ -0,0 +1,100 @@
+/**
+ * @file ring_buffer.h
+ * @author l1ang70
+ * @brief Persistently mapped, fenced ring of per-frame segments for streaming dynamic data
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_RING_BUFFER_H_
+#define _OPENGL_RING_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace opengl {
+
+// A range handed out by RingBuffer::allocate(), writable until the flush() of its frame.
+struct RingAllocation {
+    void    *data   = nullptr;  // where to write, nullptr if the frame's segment is full
+    size_t  offset  = 0;        // offset in the GL buffer, for attribute pointers or glBindBufferRange
+    size_t  size    = 0;
+
+    inline bool isValid() const { return data != nullptr; }
+};
+
+// One buffer split into a segment per frame in flight. A frame sub-allocates from its own
+// segment and writes straight into mapped memory, and endFrame() fences the segment so it
+// is only reused once the GPU has finished reading it: no copies, no orphaning and no
+// implicit synchronization in the driver.
+//
+// With glBufferStorage (GL 4.4 or ARB_buffer_storage) the whole buffer stays mapped
+// persistent and coherent. Otherwise each frame maps its segment unsynchronized, and the
+// fences keep that safe just the same.
+//
+// Per frame:   beginFrame(), allocate() and write, flush(), draw, endFrame().
+class RingBuffer {
+    unsigned int        buffer_id_      = 0;
+    unsigned int        target_         = 0;
+    size_t              segment_size_   = 0;
+    unsigned int        segment_count_  = 0;
+    bool                persistent_     = false;
+
+    char                *mapped_        = nullptr;  // the whole buffer while persistent
+    std::vector<void*>  fences_;                    // GLsync of the last frame in each segment
+    unsigned int        segment_        = 0;
+    size_t              head_           = 0;        // bytes allocated in the current segment
+    size_t              map_begin_      = 0;        // start of the range mapped for this frame, when not persistent
+    char                *frame_mapped_  = nullptr;
+    bool                in_frame_       = false;
+
+    // Statistics of this run.
+    uint64_t            frames_         = 0;
+    uint64_t            bytes_          = 0;
+    uint64_t            waits_          = 0;        // frames that found their segment still in use
+    double              wait_ms_        = 0.0;
+    uint64_t            overflows_      = 0;
+
+private:
+    RingBuffer(unsigned int buffer_id, unsigned int target, size_t segment_size, unsigned int segment_count, bool persistent);
+
+    void waitSegment(unsigned int segment);
+
+public:
+    constexpr static unsigned int SEGMENTS = 3;     // the frame being written, one queued, one on the GPU
+
+    // Allocate segment_count segments of at least segment_size bytes for the target.
+    // Returns nullptr if the buffer can not be created or mapped.
+    static RingBuffer* create(unsigned int target, size_t segment_size, unsigned int segment_count = SEGMENTS);
+
+    ~RingBuffer();
+
+    inline unsigned int buffer() const { return buffer_id_; }
+    inline size_t segmentSize() const { return segment_size_; }
+    inline bool persistent() const { return persistent_; }
+
+    // Move to the next segment, waiting for the GPU only if it still reads that segment.
+    void beginFrame();
+
+    // Take size bytes from the frame's segment, offset aligned to alignment (e.g.
+    // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT for glBindBufferRange).
+    RingAllocation allocate(size_t size, size_t alignment = 16);
+
+    // Make what was written visible to the draws that follow. Nothing to do while the buffer
+    // is coherent, otherwise it unmaps the segment; allocating again maps it once more.
+    void flush();
+
+    // Fence the segment after the frame's last draw that reads it.
+    void endFrame();
+
+    // Print the stream rate and the waits on the GPU to stdout.
+    void report() const;
+};
+
+}
+
+#endif // !_OPENGL_RING_BUFFER_H_
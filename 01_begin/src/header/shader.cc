@@ -10,7 +10,13 @@
 namespace opengl {
 
 Shader::Shader(const char * path, ShaderType type) {
-    std::string     shader_code{};
+    std::string shader_code{};
+    readSource(path, shader_code);
+    compile(shader_code.c_str(), type);
+}
+
+bool
+Shader::readSource(const char * path, std::string &source) {
     std::ifstream   shader_file{};
     shader_file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     try {
@@ -18,23 +24,63 @@ Shader::Shader(const char * path, ShaderType type) {
         std::stringstream shader_stream;
         shader_stream << shader_file.rdbuf();
         shader_file.close();
-        shader_code = shader_stream.str();
+        source = shader_stream.str();
     } catch (std::ifstream::failure &e) {
         std::cout << "[Error] Fail to read shader file:\n" << path << "\n" << e.what() << std::endl;
+        return false;
     }
-    const char * source = shader_code.c_str();
+    return true;
+}
+
+Shader*
+Shader::createFromSource(const std::string &source, ShaderType type) {
+    Shader *shader = new Shader();
+    shader->compile(source.c_str(), type);
+    return shader;
+}
+
+void
+Shader::compile(const char * source, ShaderType type) {
+    // Only submit here, asking for the status right away would wait for the compile to finish.
     shader_id_ = glCreateShader(type);
     glShaderSource(shader_id_, 1, &source, nullptr);
     glCompileShader(shader_id_);
+}
+
+bool
+Shader::parallelCompile() {
+    return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+}
+
+bool
+Shader::compileCompleted() const {
+    if (compile_success_ >= 0 || !parallelCompile())
+        return true;
+    GLint completed = GL_FALSE;
+    glGetShaderiv(shader_id_, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+bool
+Shader::compileSuccess() {
+    if (compile_success_ >= 0)
+        return compile_success_ != 0;
+
     glGetShaderiv(shader_id_, GL_COMPILE_STATUS, &compile_success_);
     if (!compile_success_) {
         GLint info_len = 0;
         glGetShaderiv(shader_id_, GL_INFO_LOG_LENGTH, &info_len);
-        GLchar * info = new GLchar[info_len];
-        glGetShaderInfoLog(shader_id_, info_len, nullptr, info);
-        fprintf(stdout, "[Error] Failed to compile shader:\n %s\n", info);
-        delete[] info;
+        // the length counts the terminator, 0 or 1 is an empty log
+        if (info_len > 1) {
+            GLchar * info = new GLchar[info_len];
+            glGetShaderInfoLog(shader_id_, info_len, nullptr, info);
+            fprintf(stdout, "[Error] Failed to compile shader:\n %s\n", info);
+            delete[] info;
+        } else {
+            fprintf(stdout, "[Error] Failed to compile shader, no info log\n");
+        }
     }
+    return compile_success_ != 0;
 }
 
 Shader::~Shader() {
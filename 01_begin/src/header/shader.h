@@ -12,24 +12,45 @@
 #ifndef _SHADER_H_
 #define _SHADER_H_
 
+#include <string>
+
 namespace opengl {
 
 enum ShaderType : int {
     FRAGMENT_SHADER = 0x8B30,
-    VERTEX_SHADER = 0x8B31
+    VERTEX_SHADER = 0x8B31,
+    COMPUTE_SHADER = 0x91B9     // GL 4.3 or ARB_compute_shader
 };
 
 class Shader {
     friend class Program;
 
     unsigned int    shader_id_          = 0;
-    int             compile_success_    = 0;
+    int             compile_success_    = -1;   // -1 until the status has been queried
+
+private:
+    Shader() = default;
+
+    void compile(const char *source, ShaderType type);
 
 public:
     Shader(const char *file_path, ShaderType type = FRAGMENT_SHADER);
     ~Shader();
 
-    inline bool compileSuccess() { return compile_success_ != 0; }
+    // Read a whole shader file, returns false if it can not be read.
+    static bool readSource(const char *file_path, std::string &source);
+
+    // Compile a shader whose source is already in memory.
+    static Shader* createFromSource(const std::string &source, ShaderType type = FRAGMENT_SHADER);
+
+    // Whether the driver compiles shaders on its own threads (GL_KHR/ARB_parallel_shader_compile).
+    static bool parallelCompile();
+
+    // Non-blocking: false while the driver is still compiling. Always true without parallelCompile().
+    bool compileCompleted() const;
+
+    // Query the compile status once, printing the info log on failure. Blocks until compiled.
+    bool compileSuccess();
 };
 
 }
@@ -0,0 +1,3 @@
+// The one translation unit that compiles stb_image, for the samples and the texture loader.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
@@ -0,0 +1,434 @@
+#include "texture.h"
+#include "ktx2.h"
+#include "mipmap.h"
+#include "render_state.h"
+#include "stb_image.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// pshufb is SSSE3, past the x86-64 baseline, so both kernels are built with target attributes
+// and picked at runtime.
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define TEXTURE_SIMD 1
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace opengl {
+
+namespace {
+
+size_t s_memory_used    = 0;
+size_t s_memory_peak    = 0;
+size_t s_memory_budget  = 0;
+size_t s_live_count     = 0;
+
+unsigned int
+pixelFormat(int channels) {
+    switch (channels) {
+    case 1:     return GL_RED;
+    case 2:     return GL_RG;
+    case 3:     return GL_RGB;
+    default:    return GL_RGBA;
+    }
+}
+
+unsigned int
+sizedFormat(int channels, bool srgb) {
+    switch (channels) {
+    case 1:     return GL_R8;
+    case 2:     return GL_RG8;
+    case 3:     return srgb ? GL_SRGB8 : GL_RGB8;
+    default:    return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+    }
+}
+
+// The GL format of the blocks, 0 if this context can not sample them.
+unsigned int
+compressedFormat(CompressedFormat format, bool srgb) {
+    if (srgb && !(GLAD_GL_VERSION_2_1 || GLAD_GL_EXT_texture_sRGB))
+        return 0;
+    switch (format) {
+    case BC1:
+        if (!GLAD_GL_EXT_texture_compression_s3tc)
+            return 0;
+        return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case BC3:
+        if (!GLAD_GL_EXT_texture_compression_s3tc)
+            return 0;
+        return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case BC7:
+        if (!GLAD_GL_VERSION_4_2 && !GLAD_GL_ARB_texture_compression_bptc)
+            return 0;
+        return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+    case ETC2_RGB:
+        if (!GLAD_GL_VERSION_4_3 && !GLAD_GL_ARB_ES3_compatibility)
+            return 0;
+        return srgb ? GL_COMPRESSED_SRGB8_ETC2 : GL_COMPRESSED_RGB8_ETC2;
+    }
+    return 0;
+}
+
+// Largest of 4, 2 and 1 that divides the row, so GL reads the rows back to back.
+int
+unpackAlignment(size_t row_bytes) {
+    if ((row_bytes & 3) == 0)
+        return 4;
+    return (row_bytes & 1) == 0 ? 2 : 1;
+}
+
+void
+expandScalar(const uint8_t *rgb, uint8_t *rgba, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        rgba[i * 4 + 0] = rgb[i * 3 + 0];
+        rgba[i * 4 + 1] = rgb[i * 3 + 1];
+        rgba[i * 4 + 2] = rgb[i * 3 + 2];
+        rgba[i * 4 + 3] = 255;
+    }
+}
+
+#ifdef TEXTURE_SIMD
+
+// 16 pixels, 48 bytes in 64 out, per step. Each 12-byte run of 4 pixels is spread to 16
+// bytes with pshufb and the alpha bytes, left zero by the shuffle, are or-ed in.
+TARGET_SSSE3 size_t
+expandSSSE3(const uint8_t *rgb, uint8_t *rgba, size_t begin, size_t end) {
+    const __m128i spread = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+    size_t i = begin;
+    for (; i + 16 <= end; i += 16) {
+        const uint8_t *in = rgb + i * 3;
+        __m128i a = _mm_loadu_si128((const __m128i*)in);
+        __m128i b = _mm_loadu_si128((const __m128i*)(in + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(in + 32));
+        __m128i p0 = _mm_shuffle_epi8(a, spread);
+        __m128i p1 = _mm_shuffle_epi8(_mm_alignr_epi8(b, a, 12), spread);
+        __m128i p2 = _mm_shuffle_epi8(_mm_alignr_epi8(c, b, 8), spread);
+        __m128i p3 = _mm_shuffle_epi8(_mm_srli_si128(c, 4), spread);
+        __m128i *out = (__m128i*)(rgba + i * 4);
+        _mm_storeu_si128(out + 0, _mm_or_si128(p0, alpha));
+        _mm_storeu_si128(out + 1, _mm_or_si128(p1, alpha));
+        _mm_storeu_si128(out + 2, _mm_or_si128(p2, alpha));
+        _mm_storeu_si128(out + 3, _mm_or_si128(p3, alpha));
+    }
+    return i;
+}
+
+// 16 pixels per step as well, each 128-bit lane loaded from its own 12-byte run. The last
+// load reads 4 bytes past the 48 of the step, so the loop stops 2 pixels early.
+TARGET_AVX2 size_t
+expandAVX2(const uint8_t *rgb, uint8_t *rgba, size_t begin, size_t end) {
+    const __m256i spread = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m256i alpha = _mm256_set1_epi32((int)0xff000000);
+    size_t i = begin;
+    for (; i + 18 <= end; i += 16) {
+        const uint8_t *in = rgb + i * 3;
+        __m256i lo = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)in)),
+                                             _mm_loadu_si128((const __m128i*)(in + 12)), 1);
+        __m256i hi = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(in + 24))),
+                                             _mm_loadu_si128((const __m128i*)(in + 36)), 1);
+        __m256i *out = (__m256i*)(rgba + i * 4);
+        _mm256_storeu_si256(out + 0, _mm256_or_si256(_mm256_shuffle_epi8(lo, spread), alpha));
+        _mm256_storeu_si256(out + 1, _mm256_or_si256(_mm256_shuffle_epi8(hi, spread), alpha));
+    }
+    return i;
+}
+
+#endif // TEXTURE_SIMD
+
+}
+
+Texture::Texture(unsigned int id, int width, int height, int levels, int channels, unsigned int internal_format,
+                 size_t bytes, bool compressed)
+    : id_(id), width_(width), height_(height), levels_(levels), channels_(channels), internal_format_(internal_format),
+      bytes_(bytes), compressed_(compressed) {
+    s_memory_used += bytes_;
+    s_memory_peak = std::max(s_memory_peak, s_memory_used);
+    s_live_count++;
+}
+
+Texture*
+Texture::create(int width, int height, int channels, const TextureOptions &options) {
+    if (width <= 0 || height <= 0 || channels < 1 || channels > 4) {
+        fprintf(stdout, "[Error] Bad texture size %dx%d with %d channels\n", width, height, channels);
+        return nullptr;
+    }
+    int storage_channels = channels == 3 && options.expand_rgb ? 4 : channels;
+    // sRGB has no 1- and 2-channel formats in core GL
+    unsigned int internal_format = sizedFormat(storage_channels, options.srgb);
+    int levels = options.mipmaps ? MipChain::fullLevelCount(width, height) : 1;
+
+    unsigned int id = createStorage(width, height, levels, internal_format, pixelFormat(storage_channels));
+    if (!id)
+        return nullptr;
+    // RGB8 is counted as 4 bytes a texel, what the hardware allocates for it
+    size_t texel_bytes = storage_channels == 3 ? 4 : storage_channels;
+    size_t bytes = 0;
+    for (int level = 0; level < levels; level++)
+        bytes += (size_t)std::max(1, width >> level) * std::max(1, height >> level) * texel_bytes;
+    return new Texture(id, width, height, levels, storage_channels, internal_format, bytes, false);
+}
+
+unsigned int
+Texture::createStorage(int width, int height, int levels, unsigned int internal_format, unsigned int pixel_format) {
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    if (!id)
+        return 0;
+    RenderState::current().bindTexture(0, GL_TEXTURE_2D, id);
+    if (GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_storage) {
+        glTexStorage2D(GL_TEXTURE_2D, levels, internal_format, width, height);
+    } else {
+        // the same levels as mutable storage, capped so the texture is still complete; compressed
+        // levels can only be specified with their data, loadKTX2() does that
+        for (int level = 0; level < levels && pixel_format; level++)
+            glTexImage2D(GL_TEXTURE_2D, level, internal_format, std::max(1, width >> level), std::max(1, height >> level),
+                         0, pixel_format, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return id;
+}
+
+Texture*
+Texture::load(const std::string &path, const TextureOptions &options, bool flip_vertically) {
+    if (path.size() > 5 && path.compare(path.size() - 5, 5, ".ktx2") == 0)
+        return loadKTX2(path);
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load_thread(flip_vertically);
+    unsigned char *pixels = stbi_load(path.c_str(), &width, &height, &channels, 0);
+    if (!pixels) {
+        fprintf(stdout, "[Error] Fail to load texture: %s\n", path.c_str());
+        return nullptr;
+    }
+    Texture *texture = create(width, height, channels, options);
+    if (!texture || texture->levels() == 1) {
+        if (texture)
+            texture->upload(pixels, channels);
+        stbi_image_free(pixels);
+        return texture;
+    }
+
+    // the chain is filtered in the channels of the storage, so RGB is expanded first
+    const uint8_t *source = pixels;
+    std::vector<uint8_t> expanded;
+    if (channels != texture->channels()) {
+        expanded.resize((size_t)width * height * 4);
+        expandRGB(pixels, expanded.data(), (size_t)width * height);
+        source = expanded.data();
+    }
+    MipOptions mip_options;
+    mip_options.srgb = options.srgb;
+    mip_options.levels = texture->levels();
+    MipChain chain;
+    chain.generate(source, width, height, texture->channels(), mip_options);
+    stbi_image_free(pixels);
+    texture->upload(chain);
+    return texture;
+}
+
+Texture*
+Texture::loadKTX2(const std::string &path) {
+    Ktx2Image *image = Ktx2Image::open(path);
+    if (!image) {
+        fprintf(stdout, "[Error] Fail to load texture: %s\n", path.c_str());
+        return nullptr;
+    }
+    unsigned int internal_format = compressedFormat(image->format(), image->srgb());
+    if (!internal_format) {
+        fprintf(stdout, "[Error] The GL can not sample the compressed format of %s\n", path.c_str());
+        delete image;
+        return nullptr;
+    }
+
+    int levels = (int)image->levelCount();
+    unsigned int id = createStorage(image->width(), image->height(), levels, internal_format, 0);
+    if (!id) {
+        delete image;
+        return nullptr;
+    }
+    // straight from the mapping, no unpack buffer and no copy
+    RenderState::current().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    bool immutable = GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_storage;
+    size_t bytes = 0;
+    for (int i = 0; i < levels; i++) {
+        const Ktx2Level &level = image->level(i);
+        if (immutable)
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.width, level.height, internal_format,
+                                      (GLsizei)level.size, level.data);
+        else
+            glCompressedTexImage2D(GL_TEXTURE_2D, i, internal_format, level.width, level.height, 0,
+                                   (GLsizei)level.size, level.data);
+        bytes += level.size;
+    }
+    int channels = image->format() == BC1 || image->format() == ETC2_RGB ? 3 : 4;
+    Texture *texture = new Texture(id, image->width(), image->height(), levels, channels, internal_format, bytes, true);
+    delete image;
+    return texture;
+}
+
+Texture::~Texture() {
+    RenderState::current().deleteTexture(id_);
+    s_memory_used -= bytes_;
+    s_live_count--;
+}
+
+bool
+Texture::upload(const void *pixels, int channels, int y, int rows, int level) {
+    if (compressed_ || level < 0 || level >= levels_)
+        return false;
+    int width = std::max(1, width_ >> level), height = std::max(1, height_ >> level);
+    if (rows < 0)
+        rows = height - y;
+    if (y < 0 || y + rows > height || rows == 0)
+        return false;
+
+    static thread_local std::vector<uint8_t> s_expanded;
+    if (channels == 3 && channels_ == 4) {
+        size_t pixel_count = (size_t)width * rows;
+        s_expanded.resize(pixel_count * 4);
+        expandRGB((const uint8_t*)pixels, s_expanded.data(), pixel_count);
+        pixels = s_expanded.data();
+        channels = 4;
+    } else if (channels != channels_) {
+        fprintf(stdout, "[Error] Can not upload %d channels to a texture of %d\n", channels, channels_);
+        return false;
+    }
+
+    RenderState &state = RenderState::current();
+    state.bindTexture(0, GL_TEXTURE_2D, id_);
+    state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    state.setUnpackAlignment(unpackAlignment((size_t)width * channels));
+    glTexSubImage2D(GL_TEXTURE_2D, level, 0, y, width, rows, pixelFormat(channels), GL_UNSIGNED_BYTE, pixels);
+    return true;
+}
+
+bool
+Texture::upload(const MipChain &chain) {
+    if (chain.levelCount() == 0 || chain.level(0).width != width_ || chain.level(0).height != height_)
+        return false;
+    int levels = std::min(levels_, chain.levelCount());
+    for (int level = 0; level < levels; level++) {
+        if (!upload(chain.pixels(level), chain.channels(), 0, -1, level))
+            return false;
+    }
+    return true;
+}
+
+void
+Texture::uploadFromBuffer(size_t offset, int y, int rows, int level) {
+    int width = std::max(1, width_ >> level);
+    RenderState &state = RenderState::current();
+    state.bindTexture(0, GL_TEXTURE_2D, id_);
+    state.setUnpackAlignment(unpackAlignment((size_t)width * channels_));
+    glTexSubImage2D(GL_TEXTURE_2D, level, 0, y, width, rows, pixelFormat(channels_), GL_UNSIGNED_BYTE, (void*)offset);
+}
+
+void
+Texture::generateMipmaps() {
+    RenderState::current().bindTexture(0, GL_TEXTURE_2D, id_);
+    glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void
+Texture::setFilter(unsigned int min_filter, unsigned int mag_filter) {
+    RenderState::current().bindTexture(0, GL_TEXTURE_2D, id_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mag_filter);
+}
+
+void
+Texture::setWrap(unsigned int wrap_s, unsigned int wrap_t) {
+    RenderState::current().bindTexture(0, GL_TEXTURE_2D, id_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_t);
+}
+
+void
+Texture::bind(unsigned int unit) const {
+    RenderState::current().bindTexture(unit, GL_TEXTURE_2D, id_);
+}
+
+bool
+Texture::kernelSupported(Kernel kernel) {
+    switch (kernel) {
+    case SCALAR:
+    case BEST:
+        return true;
+    case SSE:
+#ifdef TEXTURE_SIMD
+        return __builtin_cpu_supports("ssse3");
+#else
+        return false;
+#endif
+    case AVX2:
+#ifdef TEXTURE_SIMD
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+void
+Texture::expandRGB(const uint8_t *rgb, uint8_t *rgba, size_t pixel_count, Kernel kernel) {
+    if (kernel == BEST)
+        kernel = kernelSupported(AVX2) ? AVX2 : (kernelSupported(SSE) ? SSE : SCALAR);
+
+    size_t done = 0;
+#ifdef TEXTURE_SIMD
+    if (kernel == AVX2)
+        done = expandAVX2(rgb, rgba, done, pixel_count);
+    if (kernel == SSE || kernel == AVX2)
+        done = expandSSSE3(rgb, rgba, done, pixel_count);
+#endif
+    // whatever is left over from the vector width
+    expandScalar(rgb, rgba, done, pixel_count);
+}
+
+size_t
+Texture::memoryUsed() {
+    return s_memory_used;
+}
+
+size_t
+Texture::memoryPeak() {
+    return s_memory_peak;
+}
+
+size_t
+Texture::liveCount() {
+    return s_live_count;
+}
+
+void
+Texture::setMemoryBudget(size_t bytes) {
+    s_memory_budget = bytes;
+}
+
+void
+Texture::reportMemory() {
+    fprintf(stdout, "[Info] Texture memory: %zu textures, %.2f MiB, at most %.2f MiB",
+            s_live_count, s_memory_used / 1048576.0, s_memory_peak / 1048576.0);
+    if (s_memory_budget)
+        fprintf(stdout, " of a %.2f MiB budget", s_memory_budget / 1048576.0);
+    fprintf(stdout, "\n");
+    if (s_memory_budget && s_memory_peak > s_memory_budget)
+        fprintf(stdout, "[Error] Texture memory went %.2f MiB over the budget\n",
+                (s_memory_peak - s_memory_budget) / 1048576.0);
+}
+
+}
@@ -0,0 +1,132 @@
+/**
+ * @file texture.h
+ * @author l1ang70
+ * @brief 2D textures with immutable storage, sized formats and alignment-safe uploads
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_TEXTURE_H_
+#define _OPENGL_TEXTURE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace opengl {
+
+class MipChain;
+
+struct TextureOptions {
+    bool    mipmaps     = true;     // a full chain built on the CPU, filtered trilinear
+    bool    srgb        = false;    // color data, decoded to linear when sampled
+    bool    expand_rgb  = true;     // store 3-channel images as RGBA8 and expand them on the CPU
+};
+
+// A 2D texture whose storage is allocated once, every level at once, in a sized internal
+// format picked from the channel count: R8, RG8, RGBA8 or SRGB8_ALPHA8. Three channels are
+// stored as RGBA by default, drivers pad RGB8 to 4 bytes anyway and expanding with SIMD
+// before the upload is cheaper than their per-texel conversion. Uploads set the unpack
+// alignment from the row size, so odd widths of 1- and 3-channel data come out right.
+// load() builds the mip chain with MipChain, sRGB in linear light, and uploads every level;
+// glGenerateMipmap is slow on software drivers and filters sRGB in gamma space on some.
+// KTX2 files from the texture cooker load their block-compressed levels as they are, with
+// no decode and no mipmap generation; such textures take no upload().
+// Every texture counts its storage into a process-wide total, reported against a budget.
+class Texture {
+    unsigned int    id_;
+    int             width_;
+    int             height_;
+    int             levels_;
+    int             channels_;          // of the storage, 4 once RGB is expanded
+    unsigned int    internal_format_;
+    size_t          bytes_;             // all levels
+    bool            compressed_;
+
+private:
+    Texture(unsigned int id, int width, int height, int levels, int channels, unsigned int internal_format,
+            size_t bytes, bool compressed);
+
+    // A bound texture of every level, pixel_format 0 for compressed formats.
+    static unsigned int createStorage(int width, int height, int levels, unsigned int internal_format,
+                                      unsigned int pixel_format);
+
+public:
+    enum Kernel {
+        SCALAR,
+        SSE,        // SSSE3
+        AVX2,
+        BEST        // the widest kernel this CPU runs
+    };
+
+    // Storage for a width x height image of 1 to 4 channels. Returns nullptr on bad sizes.
+    static Texture* create(int width, int height, int channels, const TextureOptions &options = TextureOptions());
+
+    // Decode an image file and upload it, blocking. Returns nullptr if it can not be read.
+    // A .ktx2 file goes to loadKTX2() and the options and flip do not apply.
+    static Texture* load(const std::string &path, const TextureOptions &options = TextureOptions(),
+                         bool flip_vertically = true);
+
+    // Upload a cooked KTX2 file, every level it has, straight from its memory mapping with
+    // glCompressedTexSubImage2D. Returns nullptr if it can not be read or the GL can not
+    // sample its format.
+    static Texture* loadKTX2(const std::string &path);
+
+    ~Texture();
+
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    // Upload rows [y, y + rows) of a level from tightly packed client pixels of the given
+    // channel count, rows < 0 for all of them. 3-channel pixels into RGBA storage are expanded
+    // first, the count must otherwise match the storage. Mipmaps are not rebuilt. Compressed
+    // textures take no uploads after loadKTX2().
+    bool upload(const void *pixels, int channels, int y = 0, int rows = -1, int level = 0);
+
+    // Every level of the chain into the level of the same index, as many as both have.
+    bool upload(const MipChain &chain);
+
+    // The same from the bound pixel-unpack buffer at offset, in the layout of the storage.
+    void uploadFromBuffer(size_t offset, int y, int rows, int level = 0);
+
+    // Rebuild every level below 0 from level 0 with glGenerateMipmap, on the GL thread. For
+    // textures rendered to; image data gets its levels from a MipChain.
+    void generateMipmaps();
+
+    void setFilter(unsigned int min_filter, unsigned int mag_filter);
+    void setWrap(unsigned int wrap_s, unsigned int wrap_t);
+
+    // Bind on the texture unit through the render state cache.
+    void bind(unsigned int unit) const;
+
+    inline unsigned int id() const { return id_; }
+    inline int width() const { return width_; }
+    inline int height() const { return height_; }
+    inline int levels() const { return levels_; }
+    inline int channels() const { return channels_; }
+    inline unsigned int internalFormat() const { return internal_format_; }
+    inline size_t bytes() const { return bytes_; }
+    inline bool compressed() const { return compressed_; }
+
+    // RGB to RGBA with alpha 255, pixel_count pixels. rgb and rgba must not overlap.
+    static void expandRGB(const uint8_t *rgb, uint8_t *rgba, size_t pixel_count, Kernel kernel = BEST);
+    static bool kernelSupported(Kernel kernel);
+
+    // Storage of every live texture, and the most there ever was.
+    static size_t memoryUsed();
+    static size_t memoryPeak();
+    static size_t liveCount();
+
+    // Texture memory the report measures against, 0 for none.
+    static void setMemoryBudget(size_t bytes);
+
+    // Print the texture memory in use to stdout, warning when it is over the budget.
+    static void reportMemory();
+};
+
+}
+
+#endif // !_OPENGL_TEXTURE_H_
@@ -0,0 +1,562 @@
+#include "texture_compress.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace opengl {
+
+namespace {
+
+inline int
+clampInt(int value, int low, int high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+inline int
+roundClamp(float value, int high) {
+    return clampInt((int)std::lround(value), 0, high);
+}
+
+// Mean and principal axis of the first `channels` components of 16 texels, by power iteration
+// on the covariance. The axis falls back to the diagonal when the block is flat.
+void
+principalAxis(const float texels[16][4], int channels, float mean[4], float axis[4]) {
+    for (int c = 0; c < 4; c++)
+        mean[c] = axis[c] = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < channels; c++)
+            mean[c] += texels[i][c] * (1.0f / 16.0f);
+    }
+    float covariance[4][4] = {};
+    for (int i = 0; i < 16; i++) {
+        float d[4];
+        for (int c = 0; c < channels; c++)
+            d[c] = texels[i][c] - mean[c];
+        for (int r = 0; r < channels; r++) {
+            for (int c = 0; c < channels; c++)
+                covariance[r][c] += d[r] * d[c];
+        }
+    }
+    // start from the column of the channel that varies most: a fixed (1, 1, 1) is orthogonal to
+    // e.g. a red to green gradient, whose first step would then be zero and leave the wrong axis
+    int widest = 0;
+    for (int c = 1; c < channels; c++) {
+        if (covariance[c][c] > covariance[widest][widest])
+            widest = c;
+    }
+    for (int c = 0; c < channels; c++)
+        axis[c] = covariance[widest][widest] > 0.0f ? covariance[c][widest] : 1.0f;
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[4] = {};
+        float length = 0.0f;
+        for (int r = 0; r < channels; r++) {
+            for (int c = 0; c < channels; c++)
+                next[r] += covariance[r][c] * axis[c];
+            length += next[r] * next[r];
+        }
+        if (length < 1e-12f)
+            break;
+        length = 1.0f / std::sqrt(length);
+        for (int c = 0; c < channels; c++)
+            axis[c] = next[c] * length;
+    }
+    float length = 0.0f;
+    for (int c = 0; c < channels; c++)
+        length += axis[c] * axis[c];
+    length = 1.0f / std::sqrt(length);
+    for (int c = 0; c < channels; c++)
+        axis[c] *= length;
+}
+
+// The two ends of the texels projected on the axis, pulled in by inset of the range.
+void
+axisEndpoints(const float texels[16][4], int channels, float inset, float end0[4], float end1[4]) {
+    float mean[4], axis[4];
+    principalAxis(texels, channels, mean, axis);
+    float low = 0.0f, high = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        float t = 0.0f;
+        for (int c = 0; c < channels; c++)
+            t += (texels[i][c] - mean[c]) * axis[c];
+        low = std::min(low, t);
+        high = std::max(high, t);
+    }
+    float pull = (high - low) * inset;
+    for (int c = 0; c < 4; c++) {
+        end0[c] = mean[c] + axis[c] * (high - pull);
+        end1[c] = mean[c] + axis[c] * (low + pull);
+    }
+}
+
+// Least squares endpoints for fixed indices: texel i is weight[i] * a + (1 - weight[i]) * b.
+bool
+fitEndpoints(const float texels[16][4], int channels, const float weight[16], float a[4], float b[4]) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ax[4] = {}, bx[4] = {};
+    for (int i = 0; i < 16; i++) {
+        float wa = weight[i], wb = 1.0f - weight[i];
+        aa += wa * wa;
+        ab += wa * wb;
+        bb += wb * wb;
+        for (int c = 0; c < channels; c++) {
+            ax[c] += wa * texels[i][c];
+            bx[c] += wb * texels[i][c];
+        }
+    }
+    float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f)
+        return false;
+    float inverse = 1.0f / determinant;
+    for (int c = 0; c < channels; c++) {
+        a[c] = (bb * ax[c] - ab * bx[c]) * inverse;
+        b[c] = (aa * bx[c] - ab * ax[c]) * inverse;
+    }
+    return true;
+}
+
+void
+loadTexels(const uint8_t texels[64], float out[16][4]) {
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++)
+            out[i][c] = texels[i * 4 + c];
+    }
+}
+
+// ---- BC1 ----
+
+inline uint16_t
+pack565(const float color[3]) {
+    return (uint16_t)(roundClamp(color[0] * 31.0f / 255.0f, 31) << 11 |
+                      roundClamp(color[1] * 63.0f / 255.0f, 63) << 5 |
+                      roundClamp(color[2] * 31.0f / 255.0f, 31));
+}
+
+inline void
+unpack565(uint16_t packed, int color[3]) {
+    int r = packed >> 11, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = r << 3 | r >> 2;
+    color[1] = g << 2 | g >> 4;
+    color[2] = b << 3 | b >> 2;
+}
+
+// Index per texel against the 4-color palette of c0 and c1, returns the squared error.
+float
+bc1Indices(const float texels[16][4], uint16_t c0, uint16_t c1, uint8_t indices[16]) {
+    int e0[3], e1[3];
+    unpack565(c0, e0);
+    unpack565(c1, e1);
+    float palette[4][3];
+    for (int c = 0; c < 3; c++) {
+        palette[0][c] = (float)e0[c];
+        palette[1][c] = (float)e1[c];
+        palette[2][c] = (float)((2 * e0[c] + e1[c]) / 3);
+        palette[3][c] = (float)((e0[c] + 2 * e1[c]) / 3);
+    }
+    float total = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        float best = 1e30f;
+        for (int p = 0; p < 4; p++) {
+            float error = 0.0f;
+            for (int c = 0; c < 3; c++) {
+                float d = texels[i][c] - palette[p][c];
+                error += d * d;
+            }
+            if (error < best) {
+                best = error;
+                indices[i] = (uint8_t)p;
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+// Always the 4-color mode (c0 > c1), the only one BC3 color blocks have.
+void
+compressBC1Color(const float texels[16][4], uint8_t *out) {
+    const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    float end0[4], end1[4];
+    axisEndpoints(texels, 3, 1.0f / 16.0f, end0, end1);
+    uint16_t c0 = pack565(end0), c1 = pack565(end1);
+    uint8_t indices[16];
+    float error = bc1Indices(texels, c0, c1, indices);
+
+    for (int iteration = 0; iteration < 2 && error > 0.0f; iteration++) {
+        float weight[16];
+        for (int i = 0; i < 16; i++)
+            weight[i] = weights[indices[i]];
+        float a[4], b[4];
+        if (!fitEndpoints(texels, 3, weight, a, b))
+            break;
+        uint16_t n0 = pack565(a), n1 = pack565(b);
+        uint8_t candidate[16];
+        float candidate_error = bc1Indices(texels, n0, n1, candidate);
+        if (candidate_error >= error)
+            break;
+        c0 = n0;
+        c1 = n1;
+        error = candidate_error;
+        memcpy(indices, candidate, sizeof(indices));
+    }
+
+    if (c0 < c1) {
+        std::swap(c0, c1);
+        for (auto &index : indices)
+            index ^= 1;
+    } else if (c0 == c1) {
+        memset(indices, 0, sizeof(indices));
+    }
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; i++)
+        bits |= (uint32_t)indices[i] << (2 * i);
+    out[0] = (uint8_t)c0;
+    out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)c1;
+    out[3] = (uint8_t)(c1 >> 8);
+    for (int i = 0; i < 4; i++)
+        out[4 + i] = (uint8_t)(bits >> (8 * i));
+}
+
+// ---- BC3 alpha ----
+
+void
+compressBC4Alpha(const float texels[16][4], uint8_t *out) {
+    int high = 0, low = 255;
+    for (int i = 0; i < 16; i++) {
+        int alpha = (int)texels[i][3];
+        high = std::max(high, alpha);
+        low = std::min(low, alpha);
+    }
+    // a0 > a1 selects the 8-value palette
+    int palette[8] = { high, low };
+    for (int i = 2; i < 8; i++)
+        palette[i] = ((8 - i) * high + (i - 1) * low) / 7;
+    uint64_t bits = 0;
+    for (int i = 0; i < 16 && high != low; i++) {
+        int alpha = (int)texels[i][3], best = 0, best_error = 256;
+        for (int p = 0; p < 8; p++) {
+            int error = std::abs(alpha - palette[p]);
+            if (error < best_error) {
+                best_error = error;
+                best = p;
+            }
+        }
+        bits |= (uint64_t)best << (3 * i);
+    }
+    out[0] = (uint8_t)high;
+    out[1] = (uint8_t)low;
+    for (int i = 0; i < 6; i++)
+        out[2 + i] = (uint8_t)(bits >> (8 * i));
+}
+
+// ---- BC7 mode 6 ----
+
+const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// 7 bits per channel and a shared p-bit make an 8-bit endpoint, the p-bit picked for the
+// smaller error. Opaque blocks keep p-bit 1, the only way alpha decodes to exactly 255.
+void
+quantizeBC7Endpoint(const float endpoint[4], bool opaque, int quantized[4], int &pbit) {
+    float best_error = 1e30f;
+    for (int p = opaque ? 1 : 0; p < 2; p++) {
+        int q[4];
+        float error = 0.0f;
+        for (int c = 0; c < 4; c++) {
+            q[c] = roundClamp((endpoint[c] - p) * 0.5f, 127);
+            float d = (float)(q[c] * 2 + p) - endpoint[c];
+            error += d * d;
+        }
+        if (error < best_error) {
+            best_error = error;
+            pbit = p;
+            memcpy(quantized, q, sizeof(q));
+        }
+    }
+}
+
+float
+bc7Indices(const float texels[16][4], const int q0[4], int p0, const int q1[4], int p1, uint8_t indices[16]) {
+    float palette[16][4];
+    for (int c = 0; c < 4; c++) {
+        int e0 = q0[c] * 2 + p0, e1 = q1[c] * 2 + p1;
+        for (int i = 0; i < 16; i++)
+            palette[i][c] = (float)(((64 - BC7_WEIGHTS[i]) * e0 + BC7_WEIGHTS[i] * e1 + 32) >> 6);
+    }
+    float total = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        float best = 1e30f;
+        for (int p = 0; p < 16; p++) {
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++) {
+                float d = texels[i][c] - palette[p][c];
+                error += d * d;
+            }
+            if (error < best) {
+                best = error;
+                indices[i] = (uint8_t)p;
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+class BitWriter {
+    uint8_t *out_;
+    int     position_ = 0;
+
+public:
+    explicit BitWriter(uint8_t *out, size_t bytes) : out_(out) { memset(out, 0, bytes); }
+
+    void write(uint32_t value, int bits) {
+        for (int i = 0; i < bits; i++, position_++) {
+            if (value >> i & 1)
+                out_[position_ >> 3] |= (uint8_t)(1 << (position_ & 7));
+        }
+    }
+};
+
+void
+compressBC7(const float texels[16][4], uint8_t *out) {
+    bool opaque = true;
+    for (int i = 0; i < 16; i++)
+        opaque = opaque && texels[i][3] == 255.0f;
+    float end0[4], end1[4];
+    axisEndpoints(texels, 4, 0.0f, end0, end1);
+    int q0[4], q1[4], p0, p1;
+    quantizeBC7Endpoint(end0, opaque, q0, p0);
+    quantizeBC7Endpoint(end1, opaque, q1, p1);
+    uint8_t indices[16];
+    float error = bc7Indices(texels, q0, p0, q1, p1, indices);
+
+    for (int iteration = 0; iteration < 2 && error > 0.0f; iteration++) {
+        float weight[16];
+        for (int i = 0; i < 16; i++)
+            weight[i] = (64 - BC7_WEIGHTS[indices[i]]) / 64.0f;
+        float a[4], b[4];
+        if (!fitEndpoints(texels, 4, weight, a, b))
+            break;
+        int n0[4], n1[4], np0, np1;
+        quantizeBC7Endpoint(a, opaque, n0, np0);
+        quantizeBC7Endpoint(b, opaque, n1, np1);
+        uint8_t candidate[16];
+        float candidate_error = bc7Indices(texels, n0, np0, n1, np1, candidate);
+        if (candidate_error >= error)
+            break;
+        memcpy(q0, n0, sizeof(q0));
+        memcpy(q1, n1, sizeof(q1));
+        p0 = np0;
+        p1 = np1;
+        error = candidate_error;
+        memcpy(indices, candidate, sizeof(indices));
+    }
+
+    // the first index is stored without its top bit, swap the ends so it is 0
+    if (indices[0] >= 8) {
+        for (int c = 0; c < 4; c++)
+            std::swap(q0[c], q1[c]);
+        std::swap(p0, p1);
+        for (auto &index : indices)
+            index = (uint8_t)(15 - index);
+    }
+
+    BitWriter writer(out, 16);
+    writer.write(1 << 6, 7);
+    for (int c = 0; c < 4; c++) {
+        writer.write((uint32_t)q0[c], 7);
+        writer.write((uint32_t)q1[c], 7);
+    }
+    writer.write((uint32_t)p0, 1);
+    writer.write((uint32_t)p1, 1);
+    writer.write(indices[0], 3);
+    for (int i = 1; i < 16; i++)
+        writer.write(indices[i], 4);
+}
+
+// ---- ETC2 RGB, in the individual and differential modes ----
+
+const int ETC_MODIFIERS[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+inline bool
+inSubblock(int x, int y, bool flip, int subblock) {
+    return (flip ? y : x) / 2 == subblock;
+}
+
+// Best modifier table for the 8 texels of a subblock around base, the indices of its texels
+// written by x * 4 + y, the order of the block's index bits.
+int
+etcSubblock(const float texels[16][4], bool flip, int subblock, const int base[3], int &table, uint8_t indices[16]) {
+    int best_total = 1 << 30;
+    for (int t = 0; t < 8; t++) {
+        const int modifiers[4] = { ETC_MODIFIERS[t][0], ETC_MODIFIERS[t][1], -ETC_MODIFIERS[t][0], -ETC_MODIFIERS[t][1] };
+        int total = 0;
+        uint8_t chosen[16];
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                if (!inSubblock(x, y, flip, subblock))
+                    continue;
+                const float *texel = texels[y * 4 + x];
+                int best = 1 << 30;
+                for (int m = 0; m < 4; m++) {
+                    int error = 0;
+                    for (int c = 0; c < 3; c++) {
+                        int d = (int)texel[c] - clampInt(base[c] + modifiers[m], 0, 255);
+                        error += d * d;
+                    }
+                    if (error < best) {
+                        best = error;
+                        chosen[x * 4 + y] = (uint8_t)m;
+                    }
+                }
+                total += best;
+            }
+        }
+        if (total < best_total) {
+            best_total = total;
+            table = t;
+            for (int y = 0; y < 4; y++) {
+                for (int x = 0; x < 4; x++) {
+                    if (inSubblock(x, y, flip, subblock))
+                        indices[x * 4 + y] = chosen[x * 4 + y];
+                }
+            }
+        }
+    }
+    return best_total;
+}
+
+void
+compressETC2(const float texels[16][4], uint8_t *out) {
+    uint64_t best_bits = 0;
+    int best_error = 1 << 30;
+    for (int flip = 0; flip < 2; flip++) {
+        float average[2][3] = {};
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                int subblock = inSubblock(x, y, flip, 0) ? 0 : 1;
+                for (int c = 0; c < 3; c++)
+                    average[subblock][c] += texels[y * 4 + x][c] / 8.0f;
+            }
+        }
+
+        for (int differential = 0; differential < 2; differential++) {
+            int stored[2][3], base[2][3];
+            for (int c = 0; c < 3; c++) {
+                if (differential) {
+                    // the second color is a 3-bit signed step from the first, kept inside 0..31
+                    // so ETC2 does not read the block as one of its T or H modes
+                    stored[0][c] = roundClamp(average[0][c] * 31.0f / 255.0f, 31);
+                    int second = roundClamp(average[1][c] * 31.0f / 255.0f, 31);
+                    stored[1][c] = stored[0][c] + clampInt(second - stored[0][c], -4, 3);
+                    for (int s = 0; s < 2; s++)
+                        base[s][c] = stored[s][c] << 3 | stored[s][c] >> 2;
+                } else {
+                    for (int s = 0; s < 2; s++) {
+                        stored[s][c] = roundClamp(average[s][c] * 15.0f / 255.0f, 15);
+                        base[s][c] = stored[s][c] * 17;
+                    }
+                }
+            }
+
+            int tables[2];
+            uint8_t indices[16];
+            int error = etcSubblock(texels, flip, 0, base[0], tables[0], indices) +
+                        etcSubblock(texels, flip, 1, base[1], tables[1], indices);
+            if (error >= best_error)
+                continue;
+            best_error = error;
+
+            uint64_t bits = 0;
+            for (int c = 0; c < 3; c++) {
+                int shift = 59 - 8 * c;
+                if (differential)
+                    bits |= (uint64_t)stored[0][c] << shift | (uint64_t)((stored[1][c] - stored[0][c]) & 7) << (shift - 3);
+                else
+                    bits |= (uint64_t)stored[0][c] << (shift + 1) | (uint64_t)stored[1][c] << (shift - 3);
+            }
+            bits |= (uint64_t)tables[0] << 37 | (uint64_t)tables[1] << 34;
+            bits |= (uint64_t)differential << 33 | (uint64_t)flip << 32;
+            for (int i = 0; i < 16; i++) {
+                // the modifier order +small, +large, -small, -large is the index value
+                bits |= (uint64_t)(indices[i] & 1) << i | (uint64_t)(indices[i] >> 1) << (i + 16);
+            }
+            best_bits = bits;
+        }
+    }
+    for (int i = 0; i < 8; i++)
+        out[i] = (uint8_t)(best_bits >> (56 - 8 * i));
+}
+
+}
+
+size_t
+compressedBlockBytes(CompressedFormat format) {
+    return format == BC3 || format == BC7 ? 16 : 8;
+}
+
+size_t
+compressedSize(CompressedFormat format, int width, int height) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * compressedBlockBytes(format);
+}
+
+void
+compressBlock(CompressedFormat format, const uint8_t texels[64], uint8_t *out) {
+    float block[16][4];
+    loadTexels(texels, block);
+    switch (format) {
+    case BC1:
+        compressBC1Color(block, out);
+        break;
+    case BC3:
+        compressBC4Alpha(block, out);
+        compressBC1Color(block, out + 8);
+        break;
+    case BC7:
+        compressBC7(block, out);
+        break;
+    case ETC2_RGB:
+        compressETC2(block, out);
+        break;
+    }
+}
+
+void
+compressImage(CompressedFormat format, const uint8_t *rgba, int width, int height, uint8_t *out, unsigned int threads) {
+    int blocks_x = (width + 3) / 4, blocks_y = (height + 3) / 4;
+    size_t block_bytes = compressedBlockBytes(format);
+    std::atomic<int> next_row(0);
+
+    auto work = [&]() {
+        uint8_t texels[64];
+        for (int by = next_row++; by < blocks_y; by = next_row++) {
+            for (int bx = 0; bx < blocks_x; bx++) {
+                for (int y = 0; y < 4; y++) {
+                    int sy = std::min(by * 4 + y, height - 1);
+                    for (int x = 0; x < 4; x++) {
+                        int sx = std::min(bx * 4 + x, width - 1);
+                        memcpy(texels + (y * 4 + x) * 4, rgba + ((size_t)sy * width + sx) * 4, 4);
+                    }
+                }
+                compressBlock(format, texels, out + ((size_t)by * blocks_x + bx) * block_bytes);
+            }
+        }
+    };
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, (unsigned int)blocks_y);
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; i++)
+        workers.emplace_back(work);
+    work();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+}
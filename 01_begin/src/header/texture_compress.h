@@ -0,0 +1,43 @@
+/**
+ * @file texture_compress.h
+ * @author l1ang70
+ * @brief CPU encoders for the GPU block-compressed formats BC1, BC3, BC7 and ETC2
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_TEXTURE_COMPRESS_H_
+#define _OPENGL_TEXTURE_COMPRESS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace opengl {
+
+// Every format codes 4x4 texel blocks. Nothing here needs a GL context, the cooker links it alone.
+enum CompressedFormat {
+    BC1,        // RGB, 8 bytes a block
+    BC3,        // RGBA, BC1 color and an 8-byte alpha block, 16 bytes
+    BC7,        // RGBA, 16 bytes, encoded in mode 6 only: one RGBA line with 16 steps
+    ETC2_RGB    // RGB, 8 bytes, encoded in the individual and differential modes ETC2 shares with ETC1
+};
+
+size_t compressedBlockBytes(CompressedFormat format);
+
+// Bytes of one width x height image, partial blocks at the edges rounded up.
+size_t compressedSize(CompressedFormat format, int width, int height);
+
+// Encode a tightly packed RGBA8 image to compressedSize() bytes at out, the block rows split
+// over threads (0 for every core). Blocks over the edge repeat the last row and column.
+void compressImage(CompressedFormat format, const uint8_t *rgba, int width, int height, uint8_t *out,
+                   unsigned int threads = 0);
+
+// One block of 16 RGBA texels, row by row.
+void compressBlock(CompressedFormat format, const uint8_t texels[64], uint8_t *out);
+
+}
+
+#endif // !_OPENGL_TEXTURE_COMPRESS_H_
@@ -0,0 +1,251 @@
+#include "texture_loader.h"
+#include "cpu_trace.h"
+#include "render_state.h"
+#include "ring_buffer.h"
+#include "stb_image.h"
+#include "texture.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace opengl {
+
+TextureLoader*
+TextureLoader::create(const TextureLoaderOptions &options) {
+    TextureLoader *loader = new TextureLoader(options);
+    if (!loader->createPlaceholder()) {
+        delete loader;
+        return nullptr;
+    }
+    loader->staging_ = RingBuffer::create(GL_PIXEL_UNPACK_BUFFER, options.upload_budget);
+    // a bound unpack buffer turns the pointer of every other texture upload into an offset
+    RenderState::current().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!loader->staging_) {
+        delete loader;
+        return nullptr;
+    }
+
+    unsigned int threads = options.threads;
+    if (threads == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threads = std::min(std::max(cores, 2u) - 1, 4u);
+    }
+    for (unsigned int i = 0; i < threads; i++)
+        loader->workers_.emplace_back(&TextureLoader::work, loader);
+    return loader;
+}
+
+TextureLoader::~TextureLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_)
+        worker.join();
+
+    for (auto &entry : entries_)
+        delete entry.texture;
+    delete placeholder_;
+    delete staging_;
+}
+
+bool
+TextureLoader::createPlaceholder() {
+    // a grey checker, obviously not the real texture but quiet enough for a frame or two
+    const unsigned char pixels[] = {
+        96, 96, 96, 255,    160, 160, 160, 255,
+        160, 160, 160, 255, 96, 96, 96, 255
+    };
+    TextureOptions options;
+    options.mipmaps = false;
+    placeholder_ = Texture::create(2, 2, 4, options);
+    if (!placeholder_)
+        return false;
+    placeholder_->setFilter(GL_NEAREST, GL_NEAREST);
+    return placeholder_->upload(pixels, 4);
+}
+
+void
+TextureLoader::work() {
+    // the flip flag of stb_image is global unless set per thread
+    stbi_set_flip_vertically_on_load_thread(options_.flip_vertically);
+    OPENGL_TRACE_THREAD("texture decode");
+    for (;;) {
+        std::pair<uint32_t, std::string> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (stopping_)
+                return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        OPENGL_TRACE_ZONE("decode");
+        auto start = std::chrono::steady_clock::now();
+        Image image;
+        image.index = job.first;
+        int width = 0, height = 0, channels = 0;
+        unsigned char *pixels = stbi_load(job.second.c_str(), &width, &height, &channels, 4);
+        auto decoded = std::chrono::steady_clock::now();
+        if (pixels) {
+            MipOptions mip_options;
+            mip_options.srgb = options_.srgb;
+            mip_options.levels = options_.mipmaps ? 0 : 1;
+            image.chain.generate(pixels, width, height, 4, mip_options);
+            stbi_image_free(pixels);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        decoded_.push_back(std::move(image));
+        decode_ms_ += std::chrono::duration<double, std::milli>(decoded - start).count();
+        mipmap_ms_ += std::chrono::duration<double, std::milli>(end - decoded).count();
+    }
+}
+
+TextureHandle
+TextureLoader::load(const std::string &path) {
+    uint32_t index = (uint32_t)entries_.size();
+    entries_.push_back(Entry{ path });
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.emplace_back(index, path);
+    }
+    wake_.notify_one();
+    return TextureHandle(index);
+}
+
+unsigned int
+TextureLoader::texture(TextureHandle handle) const {
+    if (!resident(handle))
+        return placeholder_->id();
+    return entries_[handle.index_].texture->id();
+}
+
+bool
+TextureLoader::resident(TextureHandle handle) const {
+    return handle.index_ < entries_.size() && entries_[handle.index_].state == RESIDENT;
+}
+
+size_t
+TextureLoader::pending() const {
+    return entries_.size() - resident_ - failed_;
+}
+
+bool
+TextureLoader::startUpload(const Image &image) {
+    // storage only, the rows follow over one or more frames
+    TextureOptions options;
+    options.mipmaps = options_.mipmaps;
+    options.srgb = options_.srgb;
+    Entry &entry = entries_[image.index];
+    entry.texture = Texture::create(image.chain.level(0).width, image.chain.level(0).height, 4, options);
+    entry.state = entry.texture ? UPLOADING : FAILED;
+    return entry.texture != nullptr;
+}
+
+bool
+TextureLoader::uploadRows(Upload &upload, size_t &budget) {
+    const MipChain &chain = upload.image.chain;
+    const MipLevel &level = chain.level(upload.level);
+    size_t row_bytes = (size_t)level.width * 4;
+    int rows = std::min<int>(level.height - upload.rows_done, (int)(budget / row_bytes));
+    if (rows == 0) {
+        // a row wider than the whole budget still has to get through, alone in its frame
+        if (budget < options_.upload_budget)
+            return false;
+        rows = 1;
+    }
+
+    Texture *texture = entries_[upload.image.index].texture;
+    const unsigned char *source = chain.pixels(upload.level) + upload.rows_done * row_bytes;
+    size_t size = rows * row_bytes;
+    RingAllocation staging = staging_->allocate(size, 4);
+    if (staging.isValid()) {
+        memcpy(staging.data, source, size);
+        staging_->flush();
+        RenderState::current().bindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_->buffer());
+        texture->uploadFromBuffer(staging.offset, upload.rows_done, rows, upload.level);
+    } else {
+        texture->upload(source, 4, upload.rows_done, rows, upload.level);
+    }
+    upload.rows_done += rows;
+    if (upload.rows_done == level.height) {
+        upload.level++;
+        upload.rows_done = 0;
+    }
+    budget -= std::min(budget, size);
+    return true;
+}
+
+void
+TextureLoader::update() {
+    OPENGL_TRACE_ZONE("texture upload");
+    std::deque<Image> decoded;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        decoded.swap(decoded_);
+    }
+    for (auto &image : decoded) {
+        if (image.chain.levelCount() == 0) {
+            entries_[image.index].state = FAILED;
+            failed_++;
+            fprintf(stdout, "[Error] Fail to load texture: %s\n", entries_[image.index].path.c_str());
+            continue;
+        }
+        uploads_.push_back(Upload{ std::move(image) });
+    }
+    if (uploads_.empty())
+        return;
+
+    RenderState &state = RenderState::current();
+    staging_->beginFrame();
+    size_t budget = options_.upload_budget;
+    while (!uploads_.empty() && budget > 0) {
+        Upload &upload = uploads_.front();
+        if (entries_[upload.image.index].state == DECODING && !startUpload(upload.image)) {
+            failed_++;
+            uploads_.pop_front();
+            continue;
+        }
+        if (!uploadRows(upload, budget))
+            break;
+        if (upload.level < upload.image.chain.levelCount())
+            continue;
+
+        // the last rows are queued, the GL orders every later use of the texture after them
+        Entry &entry = entries_[upload.image.index];
+        entry.state = RESIDENT;
+        resident_++;
+        uploads_.pop_front();
+    }
+    staging_->endFrame();
+    state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    size_t frame_bytes = options_.upload_budget - budget;
+    bytes_uploaded_ += frame_bytes;
+    upload_frames_++;
+    max_frame_bytes_ = std::max(max_frame_bytes_, frame_bytes);
+}
+
+void
+TextureLoader::report() {
+    double decode_ms, mipmap_ms;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        decode_ms = decode_ms_;
+        mipmap_ms = mipmap_ms_;
+    }
+    fprintf(stdout, "[Info] Texture loader: %zu resident, %zu failed, %zu pending, %.1f MiB uploaded over %llu frames, "
+                    "at most %.1f KiB per frame, %.1f ms decoding and %.1f ms building mipmaps on %zu threads\n",
+            resident_, failed_, pending(), bytes_uploaded_ / 1048576.0, (unsigned long long)upload_frames_,
+            max_frame_bytes_ / 1024.0, decode_ms, mipmap_ms, workers_.size());
+}
+
+}
@@ -0,0 +1,144 @@
+/**
+ * @file texture_loader.h
+ * @author l1ang70
+ * @brief Asynchronous texture loading: decode on worker threads, upload through pixel buffers under a per-frame budget
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_TEXTURE_LOADER_H_
+#define _OPENGL_TEXTURE_LOADER_H_
+
+#include "mipmap.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace opengl {
+
+class RingBuffer;
+class Texture;
+class TextureLoader;
+
+// A texture requested from a TextureLoader. TextureLoader::texture() resolves it to the
+// placeholder until the image is decoded and uploaded, then to the real texture.
+class TextureHandle {
+    friend class TextureLoader;
+
+    uint32_t index_ = ~0u;
+
+    explicit TextureHandle(uint32_t index) : index_(index) {}
+
+public:
+    TextureHandle() = default;
+
+    inline bool isValid() const { return index_ != ~0u; }
+};
+
+struct TextureLoaderOptions {
+    unsigned int    threads         = 0;                // decode threads, 0 for one less than the cores (at most 4)
+    size_t          upload_budget   = 4 << 20;          // bytes uploaded per frame at most
+    bool            flip_vertically = true;             // as the samples load their images
+    bool            mipmaps         = true;             // built on the decode threads
+    bool            srgb            = false;            // color data, its mipmaps filtered in linear light
+};
+
+// Keeps stb_image decoding and the blocking glTexImage2D off the frame. load() only queues
+// the file for the worker threads. update(), once per frame on the GL thread, streams the
+// decoded pixels row strips at a time through a fenced pixel-unpack ring buffer, so a frame
+// never uploads more than the budget however many textures are in flight. The workers also
+// build the mip chain, the frame uploads its levels like level 0 and generates none. Images
+// are decoded to RGBA, which keeps every row of every level 4-byte aligned for the unpack.
+class TextureLoader {
+    enum State {
+        DECODING,
+        UPLOADING,
+        RESIDENT,
+        FAILED
+    };
+
+    struct Entry {
+        std::string     path;
+        State           state       = DECODING;
+        Texture         *texture    = nullptr;
+    };
+
+    // Decoded on a worker, handed to the GL thread.
+    struct Image {
+        uint32_t        index       = 0;
+        MipChain        chain;      // RGBA, no levels if the file could not be read
+    };
+
+    struct Upload {
+        Image           image;
+        int             level       = 0;
+        int             rows_done   = 0;
+    };
+
+    TextureLoaderOptions    options_;
+    RingBuffer              *staging_       = nullptr;
+    Texture                 *placeholder_   = nullptr;
+    std::vector<Entry>      entries_;           // GL thread only
+    std::deque<Upload>      uploads_;           // GL thread only
+
+    // Shared with the workers.
+    std::mutex              mutex_;
+    std::condition_variable wake_;
+    std::deque<std::pair<uint32_t, std::string>> jobs_;
+    std::deque<Image>       decoded_;
+    bool                    stopping_       = false;
+    double                  decode_ms_      = 0.0;
+    double                  mipmap_ms_      = 0.0;
+    std::vector<std::thread> workers_;
+
+    // Statistics of this run.
+    size_t                  resident_       = 0;
+    size_t                  failed_         = 0;
+    uint64_t                bytes_uploaded_ = 0;
+    uint64_t                upload_frames_  = 0;
+    size_t                  max_frame_bytes_ = 0;
+
+private:
+    explicit TextureLoader(const TextureLoaderOptions &options) : options_(options) {}
+
+    bool createPlaceholder();
+    void work();
+    bool startUpload(const Image &image);
+    bool uploadRows(Upload &upload, size_t &budget);
+
+public:
+    // Returns nullptr if the staging buffer can not be created.
+    static TextureLoader* create(const TextureLoaderOptions &options = TextureLoaderOptions());
+
+    // Joins the workers and deletes every texture it loaded.
+    ~TextureLoader();
+
+    // Queue a file, returns at once.
+    TextureHandle load(const std::string &path);
+
+    // The GL texture to bind for the handle: the placeholder until it is resident or if it failed.
+    unsigned int texture(TextureHandle handle) const;
+    bool resident(TextureHandle handle) const;
+
+    // Once per frame on the GL thread: take what the workers decoded and upload up to the budget.
+    void update();
+
+    // Textures still decoding or uploading.
+    size_t pending() const;
+
+    // Print the textures loaded and the upload rate to stdout.
+    void report();
+};
+
+}
+
+#endif // !_OPENGL_TEXTURE_LOADER_H_
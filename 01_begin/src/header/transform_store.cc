@@ -0,0 +1,285 @@
+#include "transform_store.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TRANSFORM_STORE_SSE 1
+#include <immintrin.h>
+#endif
+
+// The AVX2 kernel is built with a target attribute and picked at runtime, so the rest of
+// the project does not need -mavx2.
+#if defined(TRANSFORM_STORE_SSE) && (defined(__GNUC__) || defined(__clang__))
+#define TRANSFORM_STORE_AVX2 1
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+namespace opengl {
+
+namespace {
+
+constexpr float TWO_PI          = 6.28318530717958647692f;
+constexpr float INV_TWO_PI      = 0.15915494309189533577f;
+// 2*pi split in two, so k * 2*pi loses no bits when k is small.
+constexpr float TWO_PI_HI       = 6.28125f;
+constexpr float TWO_PI_LO       = 1.9353071795864769e-3f;
+
+struct Fields {
+    const float *px, *py, *pz;
+    const float *ax, *ay, *az;
+    const float *angle, *speed;
+};
+
+void
+computeScalar(const Fields &f, float time, float *out, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        float a = f.angle[i] + f.speed[i] * time;
+        a -= std::floor(a * INV_TWO_PI) * TWO_PI;
+        float c = std::cos(a), s = std::sin(a), t = 1.0f - c;
+        float x = f.ax[i], y = f.ay[i], z = f.az[i];
+
+        float *m = out + i * 16;
+        m[0]  = c + t * x * x;      m[1]  = t * x * y + s * z;  m[2]  = t * x * z - s * y;  m[3]  = 0.0f;
+        m[4]  = t * y * x - s * z;  m[5]  = c + t * y * y;      m[6]  = t * y * z + s * x;  m[7]  = 0.0f;
+        m[8]  = t * z * x + s * y;  m[9]  = t * z * y - s * x;  m[10] = c + t * z * z;      m[11] = 0.0f;
+        m[12] = f.px[i];            m[13] = f.py[i];            m[14] = f.pz[i];            m[15] = 1.0f;
+    }
+}
+
+#ifdef TRANSFORM_STORE_SSE
+
+// sin and cos of 4 angles, the Cephes polynomials as in sse_mathfun. Accurate for |x| < 8192.
+inline void
+sincos4(__m128 x, __m128 &sin_out, __m128 &cos_out) {
+    const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    __m128 sign_sin = _mm_and_ps(x, sign_mask);
+    x = _mm_andnot_ps(sign_mask, x);
+
+    // octant j, rounded up to even, and x reduced to [-pi/4, pi/4]
+    __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+    j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    __m128 y = _mm_cvtepi32_ps(j);
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+
+    sign_sin = _mm_xor_ps(sign_sin, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+    __m128 sign_cos = _mm_castsi128_ps(
+        _mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+    __m128 poly_mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 yc = _mm_set1_ps(2.443315711809948e-5f);
+    yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(-1.388731625493765e-3f));
+    yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(4.166664568298827e-2f));
+    yc = _mm_mul_ps(_mm_mul_ps(yc, z), z);
+    yc = _mm_sub_ps(yc, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    yc = _mm_add_ps(yc, _mm_set1_ps(1.0f));
+    __m128 ys = _mm_set1_ps(-1.9515295891e-4f);
+    ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(8.3321608736e-3f));
+    ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(-1.6666654611e-1f));
+    ys = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ys, z), x), x);
+
+    sin_out = _mm_xor_ps(_mm_or_ps(_mm_and_ps(poly_mask, ys), _mm_andnot_ps(poly_mask, yc)), sign_sin);
+    cos_out = _mm_xor_ps(_mm_or_ps(_mm_and_ps(poly_mask, yc), _mm_andnot_ps(poly_mask, ys)), sign_cos);
+}
+
+// Transpose one column of 4 matrices from SoA registers and store it into each matrix.
+inline void
+storeColumn4(float *out, int column, __m128 x, __m128 y, __m128 z, __m128 w) {
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(out + 0 * 16 + column * 4, x);
+    _mm_storeu_ps(out + 1 * 16 + column * 4, y);
+    _mm_storeu_ps(out + 2 * 16 + column * 4, z);
+    _mm_storeu_ps(out + 3 * 16 + column * 4, w);
+}
+
+// Returns the index it stopped at, the rest is for the scalar loop.
+size_t
+computeSSE(const Fields &f, float time, float *out, size_t begin, size_t end) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(f.angle + i), _mm_mul_ps(_mm_loadu_ps(f.speed + i), _mm_set1_ps(time)));
+        // a -= floor(a / 2pi) * 2pi, the truncation corrected for negative angles
+        __m128 k = _mm_mul_ps(a, _mm_set1_ps(INV_TWO_PI));
+        __m128 turns = _mm_cvtepi32_ps(_mm_cvttps_epi32(k));
+        turns = _mm_sub_ps(turns, _mm_and_ps(_mm_cmpgt_ps(turns, k), one));
+        a = _mm_sub_ps(a, _mm_mul_ps(turns, _mm_set1_ps(TWO_PI_HI)));
+        a = _mm_sub_ps(a, _mm_mul_ps(turns, _mm_set1_ps(TWO_PI_LO)));
+
+        __m128 s, c;
+        sincos4(a, s, c);
+        __m128 t = _mm_sub_ps(one, c);
+        __m128 x = _mm_loadu_ps(f.ax + i), y = _mm_loadu_ps(f.ay + i), z = _mm_loadu_ps(f.az + i);
+        __m128 tx = _mm_mul_ps(t, x), ty = _mm_mul_ps(t, y), tz = _mm_mul_ps(t, z);
+        __m128 sx = _mm_mul_ps(s, x), sy = _mm_mul_ps(s, y), sz = _mm_mul_ps(s, z);
+        __m128 txy = _mm_mul_ps(tx, y), txz = _mm_mul_ps(tx, z), tyz = _mm_mul_ps(ty, z);
+
+        float *m = out + i * 16;
+        storeColumn4(m, 0, _mm_add_ps(c, _mm_mul_ps(tx, x)), _mm_add_ps(txy, sz), _mm_sub_ps(txz, sy), zero);
+        storeColumn4(m, 1, _mm_sub_ps(txy, sz), _mm_add_ps(c, _mm_mul_ps(ty, y)), _mm_add_ps(tyz, sx), zero);
+        storeColumn4(m, 2, _mm_add_ps(txz, sy), _mm_sub_ps(tyz, sx), _mm_add_ps(c, _mm_mul_ps(tz, z)), zero);
+        storeColumn4(m, 3, _mm_loadu_ps(f.px + i), _mm_loadu_ps(f.py + i), _mm_loadu_ps(f.pz + i), one);
+    }
+    return i;
+}
+
+#endif // TRANSFORM_STORE_SSE
+
+#ifdef TRANSFORM_STORE_AVX2
+
+// The same as sincos4 for 8 angles.
+TARGET_AVX2 inline void
+sincos8(__m256 x, __m256 &sin_out, __m256 &cos_out) {
+    const __m256 sign_mask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+    __m256 sign_sin = _mm256_and_ps(x, sign_mask);
+    x = _mm256_andnot_ps(sign_mask, x);
+
+    __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+    j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    __m256 y = _mm256_cvtepi32_ps(j);
+    x = _mm256_fmadd_ps(y, _mm256_set1_ps(-0.78515625f), x);
+    x = _mm256_fmadd_ps(y, _mm256_set1_ps(-2.4187564849853515625e-4f), x);
+    x = _mm256_fmadd_ps(y, _mm256_set1_ps(-3.77489497744594108e-8f), x);
+
+    sign_sin = _mm256_xor_ps(sign_sin, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29)));
+    __m256 sign_cos = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+    __m256 poly_mask = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+
+    __m256 z = _mm256_mul_ps(x, x);
+    __m256 yc = _mm256_set1_ps(2.443315711809948e-5f);
+    yc = _mm256_fmadd_ps(yc, z, _mm256_set1_ps(-1.388731625493765e-3f));
+    yc = _mm256_fmadd_ps(yc, z, _mm256_set1_ps(4.166664568298827e-2f));
+    yc = _mm256_mul_ps(_mm256_mul_ps(yc, z), z);
+    yc = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), yc);
+    yc = _mm256_add_ps(yc, _mm256_set1_ps(1.0f));
+    __m256 ys = _mm256_set1_ps(-1.9515295891e-4f);
+    ys = _mm256_fmadd_ps(ys, z, _mm256_set1_ps(8.3321608736e-3f));
+    ys = _mm256_fmadd_ps(ys, z, _mm256_set1_ps(-1.6666654611e-1f));
+    ys = _mm256_fmadd_ps(_mm256_mul_ps(ys, z), x, x);
+
+    sin_out = _mm256_xor_ps(_mm256_blendv_ps(yc, ys, poly_mask), sign_sin);
+    cos_out = _mm256_xor_ps(_mm256_blendv_ps(ys, yc, poly_mask), sign_cos);
+}
+
+// Transpose one column of 8 matrices, each 128-bit lane holds matrices i..i+3 and i+4..i+7.
+TARGET_AVX2 inline void
+storeColumn8(float *out, int column, __m256 x, __m256 y, __m256 z, __m256 w) {
+    __m256 t0 = _mm256_unpacklo_ps(x, y);
+    __m256 t1 = _mm256_unpackhi_ps(x, y);
+    __m256 t2 = _mm256_unpacklo_ps(z, w);
+    __m256 t3 = _mm256_unpackhi_ps(z, w);
+    __m256 m0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 m1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 m2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 m3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    out += column * 4;
+    _mm_storeu_ps(out + 0 * 16, _mm256_castps256_ps128(m0));
+    _mm_storeu_ps(out + 1 * 16, _mm256_castps256_ps128(m1));
+    _mm_storeu_ps(out + 2 * 16, _mm256_castps256_ps128(m2));
+    _mm_storeu_ps(out + 3 * 16, _mm256_castps256_ps128(m3));
+    _mm_storeu_ps(out + 4 * 16, _mm256_extractf128_ps(m0, 1));
+    _mm_storeu_ps(out + 5 * 16, _mm256_extractf128_ps(m1, 1));
+    _mm_storeu_ps(out + 6 * 16, _mm256_extractf128_ps(m2, 1));
+    _mm_storeu_ps(out + 7 * 16, _mm256_extractf128_ps(m3, 1));
+}
+
+TARGET_AVX2 size_t
+computeAVX2(const Fields &f, float time, float *out, size_t begin, size_t end) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 a = _mm256_fmadd_ps(_mm256_loadu_ps(f.speed + i), _mm256_set1_ps(time), _mm256_loadu_ps(f.angle + i));
+        __m256 turns = _mm256_floor_ps(_mm256_mul_ps(a, _mm256_set1_ps(INV_TWO_PI)));
+        a = _mm256_fnmadd_ps(turns, _mm256_set1_ps(TWO_PI_HI), a);
+        a = _mm256_fnmadd_ps(turns, _mm256_set1_ps(TWO_PI_LO), a);
+
+        __m256 s, c;
+        sincos8(a, s, c);
+        __m256 t = _mm256_sub_ps(one, c);
+        __m256 x = _mm256_loadu_ps(f.ax + i), y = _mm256_loadu_ps(f.ay + i), z = _mm256_loadu_ps(f.az + i);
+        __m256 tx = _mm256_mul_ps(t, x), ty = _mm256_mul_ps(t, y), tz = _mm256_mul_ps(t, z);
+        __m256 sx = _mm256_mul_ps(s, x), sy = _mm256_mul_ps(s, y), sz = _mm256_mul_ps(s, z);
+        __m256 txy = _mm256_mul_ps(tx, y), txz = _mm256_mul_ps(tx, z), tyz = _mm256_mul_ps(ty, z);
+
+        float *m = out + i * 16;
+        storeColumn8(m, 0, _mm256_fmadd_ps(tx, x, c), _mm256_add_ps(txy, sz), _mm256_sub_ps(txz, sy), zero);
+        storeColumn8(m, 1, _mm256_sub_ps(txy, sz), _mm256_fmadd_ps(ty, y, c), _mm256_add_ps(tyz, sx), zero);
+        storeColumn8(m, 2, _mm256_add_ps(txz, sy), _mm256_sub_ps(tyz, sx), _mm256_fmadd_ps(tz, z, c), zero);
+        storeColumn8(m, 3, _mm256_loadu_ps(f.px + i), _mm256_loadu_ps(f.py + i), _mm256_loadu_ps(f.pz + i), one);
+    }
+    return i;
+}
+
+#endif // TRANSFORM_STORE_AVX2
+
+}
+
+void
+TransformStore::reserve(size_t count) {
+    for (auto field : { &position_x_, &position_y_, &position_z_, &axis_x_, &axis_y_, &axis_z_, &angle_, &angular_speed_ })
+        field->reserve(count);
+}
+
+size_t
+TransformStore::add(const glm::vec3 &position, const glm::vec3 &axis, float angle, float angular_speed) {
+    glm::vec3 unit_axis = glm::normalize(axis);
+    position_x_.push_back(position.x);
+    position_y_.push_back(position.y);
+    position_z_.push_back(position.z);
+    axis_x_.push_back(unit_axis.x);
+    axis_y_.push_back(unit_axis.y);
+    axis_z_.push_back(unit_axis.z);
+    angle_.push_back(angle);
+    angular_speed_.push_back(angular_speed);
+    return angle_.size() - 1;
+}
+
+bool
+TransformStore::kernelSupported(Kernel kernel) {
+    switch (kernel) {
+    case SCALAR:
+    case BEST:
+        return true;
+    case SSE:
+#ifdef TRANSFORM_STORE_SSE
+        return true;
+#else
+        return false;
+#endif
+    case AVX2:
+#ifdef TRANSFORM_STORE_AVX2
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+void
+TransformStore::computeModels(float time, float *out, Kernel kernel) const {
+    if (kernel == BEST)
+        kernel = kernelSupported(AVX2) ? AVX2 : (kernelSupported(SSE) ? SSE : SCALAR);
+
+    Fields fields{ position_x_.data(), position_y_.data(), position_z_.data(),
+                   axis_x_.data(), axis_y_.data(), axis_z_.data(), angle_.data(), angular_speed_.data() };
+    size_t done = 0;
+#ifdef TRANSFORM_STORE_AVX2
+    if (kernel == AVX2)
+        done = computeAVX2(fields, time, out, done, size());
+#endif
+#ifdef TRANSFORM_STORE_SSE
+    if (kernel == SSE || kernel == AVX2)
+        done = computeSSE(fields, time, out, done, size());
+#endif
+    // whatever is left over from the vector width
+    computeScalar(fields, time, out, done, size());
+}
+
+}
\ No newline at end of file
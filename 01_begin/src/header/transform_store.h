@@ -0,0 +1,67 @@
+/**
+ * @file transform_store.h
+ * @author l1ang70
+ * @brief Structure-of-arrays transforms that build many model matrices at once
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_TRANSFORM_STORE_H_
+#define _OPENGL_TRANSFORM_STORE_H_
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace opengl {
+
+// Each object is translate(position) * rotate(angle + angular_speed * time, axis), the same
+// matrix the samples build with glm::translate and glm::rotate. The fields are kept in
+// separate arrays so SSE/AVX2 kernels can build 4 or 8 matrices per step.
+class TransformStore {
+    std::vector<float> position_x_;
+    std::vector<float> position_y_;
+    std::vector<float> position_z_;
+    std::vector<float> axis_x_;     // normalized in add()
+    std::vector<float> axis_y_;
+    std::vector<float> axis_z_;
+    std::vector<float> angle_;          // radians
+    std::vector<float> angular_speed_;  // radians per second
+
+public:
+    enum Kernel {
+        SCALAR,
+        SSE,
+        AVX2,
+        BEST    // the widest kernel this CPU runs
+    };
+
+    TransformStore() = default;
+
+    void reserve(size_t count);
+
+    // Returns the index of the new object.
+    size_t add(const glm::vec3 &position, const glm::vec3 &axis, float angle, float angular_speed = 0.0f);
+
+    inline size_t size() const { return angle_.size(); }
+
+    inline void setPosition(size_t index, const glm::vec3 &position) {
+        position_x_[index] = position.x;
+        position_y_[index] = position.y;
+        position_z_[index] = position.z;
+    }
+    inline void setAngle(size_t index, float angle) { angle_[index] = angle; }
+
+    static bool kernelSupported(Kernel kernel);
+
+    // Write size() column-major mat4s (16 floats each) to out, e.g. a mapped instance buffer.
+    // Angles are reduced to one turn first, so they stay usable up to about 1e9 radians.
+    void computeModels(float time, float *out, Kernel kernel = BEST) const;
+};
+
+}
+
+#endif // !_OPENGL_TRANSFORM_STORE_H_
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "uniform_buffer.h"
+#include "cpu_trace.h"
+#include "render_state.h"
+
+#include <glad/glad.h>
+
+#include <cstdio>
+
+namespace opengl {
+
+FrameData::FrameData(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &camera_position)
+    : view(view), projection(projection), view_projection(projection * view),
+      camera_position(camera_position, 1.0f) {}
+
+UniformBuffer::UniformBuffer(unsigned int buffer_id, size_t size, unsigned int binding)
+    : buffer_id_(buffer_id), size_(size), binding_(binding) {}
+
+UniformBuffer*
+UniformBuffer::create(size_t size, unsigned int binding) {
+    GLuint id = 0;
+    glGenBuffers(1, &id);
+    if (!id)
+        return nullptr;
+
+    RenderState &state = RenderState::current();
+    state.bindBuffer(GL_UNIFORM_BUFFER, id);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    state.bindBufferBase(GL_UNIFORM_BUFFER, binding, id);
+    return new UniformBuffer(id, size, binding);
+}
+
+UniformBuffer::~UniformBuffer() {
+    RenderState::current().deleteBuffer(buffer_id_);
+    buffer_id_ = 0;
+}
+
+void
+UniformBuffer::update(const void *data, size_t size, size_t offset) {
+    OPENGL_TRACE_ZONE("uniform upload");
+    if (offset + size > size_) {
+        fprintf(stdout, "[Error] Uniform buffer update out of range: %zu + %zu > %zu\n", offset, size, size_);
+        return;
+    }
+    // left bound, the state cache drops the bind when the same buffer is updated again
+    RenderState::current().bindBuffer(GL_UNIFORM_BUFFER, buffer_id_);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+}
+
+void
+UniformBuffer::bind() {
+    RenderState::current().bindBufferBase(GL_UNIFORM_BUFFER, binding_, buffer_id_);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+/**
+ * @file uniform_buffer.h
+ * @author l1ang70
+ * @brief The class that wraps the uniform buffer, and the per-frame uniform block
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_UNIFORM_BUFFER_H_
+#define _OPENGL_UNIFORM_BUFFER_H_
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace opengl {
+
+// Binding points of the uniform blocks shared by every program, set up in Program::link().
+enum UniformBinding : unsigned int {
+    FRAME_DATA_BINDING = 0
+};
+
+constexpr const char* FRAME_DATA_BLOCK = "FrameData";
+
+// std140 mirror of the "FrameData" block in the shaders, written once per frame.
+struct FrameData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 view_projection;
+    glm::vec4 camera_position;  // vec3 padded to 16 bytes as std140 does, w is unused
+
+    FrameData(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &camera_position);
+};
+
+static_assert(sizeof(FrameData) == 4 * 16 * 3 + 16, "FrameData must match the std140 block layout");
+
+class UniformBuffer {
+    unsigned int    buffer_id_  = 0;
+    size_t          size_       = 0;
+    unsigned int    binding_    = 0;
+
+private:
+    UniformBuffer(unsigned int buffer_id, size_t size, unsigned int binding);
+
+public:
+    // Allocate size bytes and keep them bound at the binding point.
+    static UniformBuffer* create(size_t size, unsigned int binding);
+
+    ~UniformBuffer();
+
+    inline size_t size() const { return size_; }
+    inline unsigned int binding() const { return binding_; }
+
+    void update(const void *data, size_t size, size_t offset = 0);
+
+    template <typename T>
+    inline void update(const T &data) { update(&data, sizeof(T)); }
+
+    // Rebind to the binding point, only needed if something else was bound there.
+    void bind();
+};
+
+}
+
+#endif // !_OPENGL_UNIFORM_BUFFER_H_
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "vertex_array_cache.h"
+#include "render_state.h"
+
+#include <glad/glad.h>
+
+#include <cstdio>
+
+namespace opengl {
+
+namespace {
+
+bool
+sameKeys(const std::vector<uint64_t> &keys, const LayoutDescriptor *layouts, size_t layout_count) {
+    if (keys.size() != layout_count)
+        return false;
+    for (size_t i = 0; i < layout_count; i++) {
+        if (keys[i] != layouts[i].key)
+            return false;
+    }
+    return true;
+}
+
+}
+
+VertexArrayCache&
+VertexArrayCache::current() {
+    static VertexArrayCache s_cache;
+    return s_cache;
+}
+
+bool
+VertexArrayCache::supported() {
+    return GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_vertex_attrib_binding;
+}
+
+unsigned int
+VertexArrayCache::vertexArray(const LayoutDescriptor *layouts, size_t layout_count) {
+    lookups_++;
+    if (last_ < entries_.size() && sameKeys(entries_[last_].keys, layouts, layout_count))
+        return entries_[last_].vertex_array;
+    for (size_t i = 0; i < entries_.size(); i++) {
+        if (sameKeys(entries_[i].keys, layouts, layout_count)) {
+            last_ = i;
+            return entries_[i].vertex_array;
+        }
+    }
+    if (!supported() || layout_count == 0)
+        return 0;
+
+    GLuint vertex_array = 0;
+    glGenVertexArrays(1, &vertex_array);
+    if (!vertex_array) {
+        fprintf(stdout, "[Error] Fail to create a vertex array\n");
+        return 0;
+    }
+    // every format and binding in one pass, the buffers come later with glBindVertexBuffer
+    RenderState::current().bindVertexArray(vertex_array);
+    Entry entry = { {}, vertex_array };
+    for (size_t binding = 0; binding < layout_count; binding++) {
+        const LayoutDescriptor &layout = layouts[binding];
+        for (size_t i = 0; i < layout.count; i++) {
+            const LayoutAttribute &attribute = layout.attributes[i];
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribFormat(attribute.location, attribute.components, attribute.type,
+                                 attribute.normalized ? GL_TRUE : GL_FALSE, attribute.offset);
+            glVertexAttribBinding(attribute.location, (GLuint)binding);
+        }
+        glVertexBindingDivisor((GLuint)binding, layout.divisor);
+        entry.keys.push_back(layout.key);
+    }
+    entries_.push_back(entry);
+    last_ = entries_.size() - 1;
+    created_++;
+    return vertex_array;
+}
+
+void
+VertexArrayCache::clear() {
+    RenderState &state = RenderState::current();
+    for (auto &entry : entries_)
+        state.deleteVertexArray(entry.vertex_array);
+    forget();
+}
+
+void
+VertexArrayCache::forget() {
+    entries_.clear();
+    last_ = 0;
+}
+
+void
+VertexArrayCache::report() const {
+    fprintf(stdout, "[Info] Vertex array cache: %zu vertex arrays for %llu lookups (%llu created)\n", entries_.size(),
+            (unsigned long long)lookups_, (unsigned long long)created_);
+}
+
+}
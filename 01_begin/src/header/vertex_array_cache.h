@@ -0,0 +1,71 @@
+/**
+ * @file vertex_array_cache.h
+ * @author l1ang70
+ * @brief One vertex array per vertex layout, shared by every mesh of that layout
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_VERTEX_ARRAY_CACHE_H_
+#define _OPENGL_VERTEX_ARRAY_CACHE_H_
+
+#include "vertex_layout.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace opengl {
+
+// With separate attribute formats (GL 4.3 or ARB_vertex_attrib_binding) a vertex array holds
+// the attribute formats apart from the buffers they read. So one vertex array per layout is
+// enough: it is set up once, in one pass, the first time the layout is asked for, and
+// switching between meshes of that layout rebinds only their buffers through the render
+// state, glBindVertexBuffer and the element buffer. Layouts are told apart by their keys,
+// binding i of a vertex array reads layouts[i].
+class VertexArrayCache {
+    struct Entry {
+        std::vector<uint64_t>   keys;
+        unsigned int            vertex_array;
+    };
+
+    std::vector<Entry>  entries_;
+    size_t              last_       = 0;    // the entry found last, most lookups ask for it again
+    uint64_t            lookups_    = 0;
+    uint64_t            created_    = 0;
+
+private:
+    VertexArrayCache() = default;
+
+public:
+    // The cache of the current context, one instance as for RenderState.
+    static VertexArrayCache& current();
+
+    VertexArrayCache(const VertexArrayCache&) = delete;
+    VertexArrayCache& operator=(const VertexArrayCache&) = delete;
+
+    // Without separate attribute formats every mesh sets up a vertex array of its own.
+    static bool supported();
+
+    // The vertex array reading layouts[i] from binding i, created the first time. 0 if not supported().
+    unsigned int vertexArray(const LayoutDescriptor *layouts, size_t layout_count);
+    inline unsigned int vertexArray(const LayoutDescriptor &layout) { return vertexArray(&layout, 1); }
+
+    // Delete every vertex array of the cache.
+    void clear();
+
+    // Drop the entries without deleting anything, for a new context where the names mean nothing.
+    void forget();
+
+    inline size_t size() const { return entries_.size(); }
+
+    // Print the vertex arrays created against the lookups to stdout.
+    void report() const;
+};
+
+}
+
+#endif // !_OPENGL_VERTEX_ARRAY_CACHE_H_
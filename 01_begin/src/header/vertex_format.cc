@@ -0,0 +1,378 @@
+#include "vertex_format.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace opengl {
+
+namespace {
+
+const char*
+encodingName(VertexEncoding encoding) {
+    switch (encoding) {
+    case FLOAT32:       return "float";
+    case HALF_FLOAT:    return "half";
+    case UNORM16:       return "unorm16";
+    case SNORM16:       return "snorm16";
+    case UNORM8:        return "unorm8";
+    case OCTAHEDRAL16:  return "octahedral16";
+    case OCTAHEDRAL8:   return "octahedral8";
+    }
+    return "?";
+}
+
+// The GL 4.2 conversion, which every current driver uses for snorm whatever the context version.
+inline float
+snormToFloat(int32_t value, int bits) {
+    return std::max((float)value / (float)((1 << (bits - 1)) - 1), -1.0f);
+}
+
+void
+octahedralDecode(float x, float y, float *normal) {
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+    float length = std::sqrt(x * x + y * y + z * z);
+    normal[0] = x / length;
+    normal[1] = y / length;
+    normal[2] = z / length;
+}
+
+// Undo the bias, scale onto the integer range and round, multiplier being max / scale.
+template <typename T>
+inline void
+encodeNormalized(const float *vertex, const VertexAttribute &attribute, const float *multiplier, float low, float max,
+                 uint8_t *field) {
+    for (int c = 0; c < attribute.components; c++) {
+        float x = std::min(std::max((vertex[c] - attribute.bias[c]) * multiplier[c], low), max);
+        T q = (T)(int32_t)(x + (x >= 0.0f ? 0.5f : -0.5f));
+        memcpy(field + c * sizeof(T), &q, sizeof(T));
+    }
+}
+
+// The fold, then the sign of a 4th component.
+template <typename T>
+inline void
+encodeOctahedral(const float *vertex, const VertexAttribute &attribute, int bits, uint8_t *field) {
+    T max = (T)((1 << (bits - 1)) - 1);
+    int32_t encoded[2];
+    VertexFormat::octahedralEncode(vertex, bits, encoded);
+    T q[3] = { (T)encoded[0], (T)encoded[1], (T)(attribute.components == 4 && vertex[3] < 0.0f ? -max : max) };
+    memcpy(field, q, attribute.gl_size * sizeof(T));
+}
+
+}
+
+const char *VertexFormat::OCTAHEDRAL_GLSL = R"(
+vec3 octahedralDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+)";
+
+VertexFormat&
+VertexFormat::add(unsigned int location, int components, VertexEncoding encoding, bool fit) {
+    components = std::min(std::max(components, 1), 4);
+    if ((encoding == OCTAHEDRAL16 || encoding == OCTAHEDRAL8) && components < 3) {
+        fprintf(stdout, "[Error] Octahedral attribute %u needs 3 or 4 components, kept as float\n", location);
+        encoding = FLOAT32;
+    }
+
+    VertexAttribute attribute = {};
+    attribute.location = location;
+    attribute.components = components;
+    attribute.encoding = encoding;
+    attribute.fit = fit && (encoding == UNORM16 || encoding == SNORM16 || encoding == UNORM8);
+    attribute.offset = stride_;
+    attribute.gl_size = components;
+    size_t bytes = 0;
+    switch (encoding) {
+    case FLOAT32:
+        attribute.gl_type = GL_FLOAT;
+        bytes = components * sizeof(float);
+        break;
+    case HALF_FLOAT:
+        attribute.gl_type = GL_HALF_FLOAT;
+        bytes = components * sizeof(uint16_t);
+        break;
+    case UNORM16:
+    case SNORM16:
+        attribute.gl_type = encoding == UNORM16 ? GL_UNSIGNED_SHORT : GL_SHORT;
+        attribute.gl_normalized = true;
+        bytes = components * sizeof(uint16_t);
+        break;
+    case UNORM8:
+        attribute.gl_type = GL_UNSIGNED_BYTE;
+        attribute.gl_normalized = true;
+        bytes = components;
+        break;
+    case OCTAHEDRAL16:
+    case OCTAHEDRAL8:
+        // x and y of the fold, then the sign of the 4th component when there is one
+        attribute.gl_size = components == 4 ? 3 : 2;
+        attribute.gl_type = encoding == OCTAHEDRAL16 ? GL_SHORT : GL_BYTE;
+        attribute.gl_normalized = true;
+        bytes = attribute.gl_size * (encoding == OCTAHEDRAL16 ? sizeof(int16_t) : sizeof(int8_t));
+        break;
+    }
+    for (int c = 0; c < 4; c++) {
+        attribute.scale[c] = 1.0f;
+        attribute.bias[c] = 0.0f;
+    }
+    attributes_.push_back(attribute);
+    layout_.push_back({ location, attribute.gl_size, (AttributeType)attribute.gl_type, attribute.gl_normalized,
+                        (uint32_t)attribute.offset });
+    stride_ += alignAttribute((uint32_t)bytes);
+    source_floats_ += components;
+    return *this;
+}
+
+void
+VertexFormat::encode(const float *vertices, size_t vertex_count, std::vector<uint8_t> &packed) {
+    // the bounds of every fitted attribute in one pass, onto [0, 1] for unorm and [-1, 1] for snorm
+    std::vector<float> low(source_floats_, FLT_MAX), high(source_floats_, -FLT_MAX);
+    bool any_fit = false;
+    for (auto &attribute : attributes_)
+        any_fit |= attribute.fit;
+    for (size_t v = 0; any_fit && v < vertex_count; v++) {
+        const float *vertex = vertices + v * source_floats_;
+        for (size_t f = 0; f < source_floats_; f++) {
+            low[f] = std::min(low[f], vertex[f]);
+            high[f] = std::max(high[f], vertex[f]);
+        }
+    }
+    // the multipliers from the scale onto the integer range of each normalized attribute
+    std::vector<float> multiplier(source_floats_, 0.0f);
+    size_t first = 0;
+    for (auto &attribute : attributes_) {
+        float max = attribute.encoding == UNORM16 ? 65535.0f : attribute.encoding == SNORM16 ? 32767.0f : 255.0f;
+        for (int c = 0; c < attribute.components; c++) {
+            if (attribute.fit && vertex_count > 0) {
+                float l = low[first + c], h = high[first + c];
+                attribute.scale[c] = attribute.encoding == SNORM16 ? (h - l) * 0.5f : h - l;
+                attribute.bias[c] = attribute.encoding == SNORM16 ? (h + l) * 0.5f : l;
+            }
+            multiplier[first + c] = attribute.scale[c] != 0.0f ? max / attribute.scale[c] : 0.0f;
+        }
+        first += attribute.components;
+    }
+
+    packed.assign(vertex_count * stride_, 0);
+    for (size_t v = 0; v < vertex_count; v++) {
+        const float *vertex = vertices + v * source_floats_;
+        const float *vertex_multiplier = multiplier.data();
+        uint8_t *out = packed.data() + v * stride_;
+        for (auto &attribute : attributes_) {
+            uint8_t *field = out + attribute.offset;
+            switch (attribute.encoding) {
+            case FLOAT32:
+                memcpy(field, vertex, attribute.components * sizeof(float));
+                break;
+            case HALF_FLOAT:
+                for (int c = 0; c < attribute.components; c++) {
+                    uint16_t half = toHalf(vertex[c]);
+                    memcpy(field + c * sizeof(uint16_t), &half, sizeof(uint16_t));
+                }
+                break;
+            case UNORM16:
+                encodeNormalized<uint16_t>(vertex, attribute, vertex_multiplier, 0.0f, 65535.0f, field);
+                break;
+            case SNORM16:
+                encodeNormalized<int16_t>(vertex, attribute, vertex_multiplier, -32767.0f, 32767.0f, field);
+                break;
+            case UNORM8:
+                encodeNormalized<uint8_t>(vertex, attribute, vertex_multiplier, 0.0f, 255.0f, field);
+                break;
+            case OCTAHEDRAL16:
+                encodeOctahedral<int16_t>(vertex, attribute, 16, field);
+                break;
+            case OCTAHEDRAL8:
+                encodeOctahedral<int8_t>(vertex, attribute, 8, field);
+                break;
+            }
+            vertex += attribute.components;
+            vertex_multiplier += attribute.components;
+        }
+    }
+}
+
+void
+VertexFormat::decode(const uint8_t *packed, size_t vertex_count, float *vertices) const {
+    for (size_t v = 0; v < vertex_count; v++) {
+        const uint8_t *in = packed + v * stride_;
+        float *vertex = vertices + v * source_floats_;
+        for (auto &attribute : attributes_) {
+            const uint8_t *field = in + attribute.offset;
+            switch (attribute.encoding) {
+            case FLOAT32:
+                memcpy(vertex, field, attribute.components * sizeof(float));
+                break;
+            case HALF_FLOAT:
+                for (int c = 0; c < attribute.components; c++) {
+                    uint16_t half;
+                    memcpy(&half, field + c * sizeof(uint16_t), sizeof(uint16_t));
+                    vertex[c] = fromHalf(half);
+                }
+                break;
+            case UNORM16:
+            case SNORM16:
+            case UNORM8:
+                for (int c = 0; c < attribute.components; c++) {
+                    float value;
+                    if (attribute.encoding == UNORM8) {
+                        value = field[c] / 255.0f;
+                    } else {
+                        uint16_t q;
+                        memcpy(&q, field + c * sizeof(uint16_t), sizeof(uint16_t));
+                        value = attribute.encoding == UNORM16 ? q / 65535.0f : snormToFloat((int16_t)q, 16);
+                    }
+                    vertex[c] = value * attribute.scale[c] + attribute.bias[c];
+                }
+                break;
+            case OCTAHEDRAL16:
+            case OCTAHEDRAL8: {
+                float e[3];
+                for (int c = 0; c < attribute.gl_size; c++) {
+                    if (attribute.encoding == OCTAHEDRAL16) {
+                        int16_t s;
+                        memcpy(&s, field + c * sizeof(int16_t), sizeof(int16_t));
+                        e[c] = snormToFloat(s, 16);
+                    } else {
+                        e[c] = snormToFloat((int8_t)field[c], 8);
+                    }
+                }
+                octahedralDecode(e[0], e[1], vertex);
+                if (attribute.components == 4)
+                    vertex[3] = e[2];
+                break;
+            }
+            }
+            vertex += attribute.components;
+        }
+    }
+}
+
+LayoutDescriptor
+VertexFormat::descriptor(unsigned int divisor) const {
+    return { layout_.data(), layout_.size(), (uint32_t)stride_, divisor,
+             layoutKey(layout_.data(), layout_.size(), (uint32_t)stride_, divisor) };
+}
+
+void
+VertexFormat::setup(size_t offset) const {
+    setupVertexAttributes(descriptor(), offset);
+}
+
+void
+VertexFormat::report() const {
+    std::string layout;
+    for (auto &attribute : attributes_) {
+        char text[64];
+        snprintf(text, sizeof(text), "%s%u %s x%d%s", layout.empty() ? "" : ", ", attribute.location,
+                 encodingName(attribute.encoding), attribute.components, attribute.fit ? " fit" : "");
+        layout += text;
+    }
+    fprintf(stdout, "[Info] Vertex format: %s; %zu bytes a vertex, %zu as floats\n", layout.c_str(), stride_,
+            source_floats_ * sizeof(float));
+}
+
+VertexFormat
+VertexFormat::positionTexture() {
+    return VertexFormat().add(0, 3, FLOAT32).add(1, 2, FLOAT32);
+}
+
+uint16_t
+VertexFormat::toHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+    uint16_t half;
+    if (bits >= 0x47800000u) {
+        // too large for a half, or infinity or NaN already
+        half = bits > 0x7f800000u ? 0x7e00 : 0x7c00;
+    } else if (bits < 0x38800000u) {
+        // a half denormal: adding 0.5 lines its 10 bits up at the bottom of the float, rounded by the FPU
+        float denormal;
+        memcpy(&denormal, &bits, sizeof(denormal));
+        denormal += 0.5f;
+        uint32_t shifted;
+        memcpy(&shifted, &denormal, sizeof(shifted));
+        half = (uint16_t)(shifted - 0x3f000000u);
+    } else {
+        // rebias the exponent and round the 13 dropped bits to nearest even, carrying into the exponent
+        uint32_t odd = (bits >> 13) & 1;
+        bits += 0xc8000fffu + odd;
+        half = (uint16_t)(bits >> 13);
+    }
+    return (uint16_t)((sign >> 16) | half);
+}
+
+float
+VertexFormat::fromHalf(uint16_t half) {
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    float value;
+    if (exponent == 0) {
+        value = std::ldexp((float)mantissa, -24);
+        return sign ? -value : value;
+    }
+    uint32_t bits = exponent == 31 ? sign | 0x7f800000u | (mantissa << 13)
+                                   : sign | ((exponent + 112) << 23) | (mantissa << 13);
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void
+VertexFormat::octahedralEncode(const float *normal, int bits, int32_t *encoded) {
+    float length = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    if (length == 0.0f) {
+        encoded[0] = encoded[1] = 0;
+        return;
+    }
+    float x = normal[0] / length, y = normal[1] / length;
+    if (normal[2] < 0.0f) {
+        float folded_x = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float folded_y = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = folded_x;
+        y = folded_y;
+    }
+
+    // of the 4 snorm pairs around the fold, the one that unfolds closest to the normal
+    int32_t max = (1 << (bits - 1)) - 1;
+    float inverse_max = 1.0f / max;
+    x *= max;
+    y *= max;
+    int32_t base_x = (int32_t)x - (x < (int32_t)x), base_y = (int32_t)y - (y < (int32_t)y);
+    float best = -FLT_MAX;
+    for (int32_t dy = 0; dy <= 1; dy++) {
+        for (int32_t dx = 0; dx <= 1; dx++) {
+            int32_t qx = std::min(std::max(base_x + dx, -max), max);
+            int32_t qy = std::min(std::max(base_y + dy, -max), max);
+            // unfolded as the shader does, compared by the cosine to the normal
+            float ex = qx * inverse_max, ey = qy * inverse_max;
+            float ez = 1.0f - std::fabs(ex) - std::fabs(ey);
+            float t = std::max(-ez, 0.0f);
+            ex += ex >= 0.0f ? -t : t;
+            ey += ey >= 0.0f ? -t : t;
+            float cosine = (ex * normal[0] + ey * normal[1] + ez * normal[2]) / std::sqrt(ex * ex + ey * ey + ez * ez);
+            if (cosine > best) {
+                best = cosine;
+                encoded[0] = qx;
+                encoded[1] = qy;
+            }
+        }
+    }
+}
+
+}
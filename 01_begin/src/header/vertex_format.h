@@ -0,0 +1,104 @@
+/**
+ * @file vertex_format.h
+ * @author l1ang70
+ * @brief Vertex formats: float vertices packed into half-float, normalized and octahedral attributes
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_VERTEX_FORMAT_H_
+#define _OPENGL_VERTEX_FORMAT_H_
+
+#include "vertex_layout.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace opengl {
+
+enum VertexEncoding {
+    FLOAT32,        // as is
+    HALF_FLOAT,     // IEEE half, 11 significant bits, positions within a few units of the origin
+    UNORM16,        // [0, 1] on 16 bits, texture coordinates
+    SNORM16,        // [-1, 1] on 16 bits
+    UNORM8,         // [0, 1] on 8 bits, colors
+    OCTAHEDRAL16,   // a unit vector folded onto the octahedron, 2 x snorm16, normals
+    OCTAHEDRAL8     // the same on 2 x snorm8, tangents
+};
+
+struct VertexAttribute {
+    unsigned int    location;
+    int             components;     // floats of the source vertex, 1 to 4
+    VertexEncoding  encoding;
+    bool            fit;            // normalized encodings: remap the bounds of the data instead of clamping
+    size_t          offset;         // bytes into the packed vertex
+    int             gl_size;        // components the shader reads
+    unsigned int    gl_type;
+    bool            gl_normalized;
+    float           scale[4];       // the shader gets the source value back as value * scale + bias
+    float           bias[4];
+};
+
+// How a vertex of float attributes is packed for the GPU. add() the attributes in the order
+// they appear in the source vertex, encode() packs float vertices to stride() bytes each and
+// setup() points the attributes of the bound vertex array at them. Every attribute starts on
+// 4 bytes, padded where it is shorter, which is what the fetch hardware wants.
+//
+// Normalized attributes are clamped to their range unless fit, then encode() measures the
+// bounds of the data and maps those onto the range instead: positions on UNORM16 keep 16
+// bits across the mesh whatever its size, and the shader undoes the mapping with the scale
+// and bias of its attribute(). Octahedral attributes need OCTAHEDRAL_GLSL to unfold; a 4th
+// component, the handedness of a tangent, is kept as its sign in the 3rd.
+class VertexFormat {
+    std::vector<VertexAttribute>    attributes_;
+    std::vector<LayoutAttribute>    layout_;        // what the vertex array reads of them
+    size_t                          stride_         = 0;
+    size_t                          source_floats_  = 0;
+
+public:
+    VertexFormat& add(unsigned int location, int components, VertexEncoding encoding, bool fit = false);
+
+    inline size_t stride() const { return stride_; }
+    inline size_t sourceFloats() const { return source_floats_; }
+    inline size_t attributeCount() const { return attributes_.size(); }
+    inline const VertexAttribute& attribute(size_t index) const { return attributes_[index]; }
+
+    // Pack vertex_count vertices of sourceFloats() floats into stride() bytes each. Measures
+    // the bounds of the fitted attributes first, so the scale and bias are those of this data.
+    void encode(const float *vertices, size_t vertex_count, std::vector<uint8_t> &packed);
+
+    // Unpack to floats again, what the shader sees after the scale and bias and unfolding.
+    void decode(const uint8_t *packed, size_t vertex_count, float *vertices) const;
+
+    // The packed layout, for setupVertexAttributes() or the VertexArrayCache. Points into the
+    // format, which has to outlive it and not change.
+    LayoutDescriptor descriptor(unsigned int divisor = 0) const;
+
+    // glVertexAttribPointer and enable every attribute, reading the bound GL_ARRAY_BUFFER from offset.
+    void setup(size_t offset = 0) const;
+
+    // Print the layout and the bytes per vertex against all floats to stdout.
+    void report() const;
+
+    // The float layout of every sample vertex: vec3 position at 0, vec2 texture coordinate at 1.
+    static VertexFormat positionTexture();
+
+    // float to IEEE half, rounding to nearest even, and back.
+    static uint16_t toHalf(float value);
+    static float fromHalf(uint16_t half);
+
+    // Fold a unit vector onto the octahedron, (x, y) in [-1, 1] each, rounded to bits of
+    // snorm so the unfolded vector is the closest there is.
+    static void octahedralEncode(const float *normal, int bits, int32_t *encoded);
+
+    // GLSL: vec3 octahedralDecode(vec2 e) unfolds an OCTAHEDRAL attribute in the shader.
+    static const char *OCTAHEDRAL_GLSL;
+};
+
+}
+
+#endif // !_OPENGL_VERTEX_FORMAT_H_
@@ -0,0 +1,19 @@
+#include "vertex_layout.h"
+
+#include <glad/glad.h>
+
+namespace opengl {
+
+void
+setupVertexAttributes(const LayoutDescriptor &layout, size_t offset) {
+    for (size_t i = 0; i < layout.count; i++) {
+        const LayoutAttribute &attribute = layout.attributes[i];
+        glVertexAttribPointer(attribute.location, attribute.components, attribute.type,
+                              attribute.normalized ? GL_TRUE : GL_FALSE, (GLsizei)layout.stride,
+                              (void*)(offset + attribute.offset));
+        glEnableVertexAttribArray(attribute.location);
+        glVertexAttribDivisor(attribute.location, layout.divisor);
+    }
+}
+
+}
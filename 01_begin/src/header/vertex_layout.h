@@ -0,0 +1,162 @@
+/**
+ * @file vertex_layout.h
+ * @author l1ang70
+ * @brief Vertex layouts declared as types: stride, offsets and GL types worked out at compile time
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _OPENGL_VERTEX_LAYOUT_H_
+#define _OPENGL_VERTEX_LAYOUT_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace opengl {
+
+// Component types of vertex attributes, valued as their GL enums.
+enum AttributeType : unsigned int {
+    BYTE_ATTRIBUTE              = 0x1400,
+    UNSIGNED_BYTE_ATTRIBUTE     = 0x1401,
+    SHORT_ATTRIBUTE             = 0x1402,
+    UNSIGNED_SHORT_ATTRIBUTE    = 0x1403,
+    INT_ATTRIBUTE               = 0x1404,
+    UNSIGNED_INT_ATTRIBUTE      = 0x1405,
+    FLOAT_ATTRIBUTE             = 0x1406,
+    HALF_FLOAT_ATTRIBUTE        = 0x140B
+};
+
+// A 16-bit float as stored, VertexFormat::toHalf() makes one.
+struct Half {
+    uint16_t    bits;
+};
+
+template <typename T> struct AttributeTraits;
+template <> struct AttributeTraits<int8_t>   { constexpr static AttributeType TYPE = BYTE_ATTRIBUTE; };
+template <> struct AttributeTraits<uint8_t>  { constexpr static AttributeType TYPE = UNSIGNED_BYTE_ATTRIBUTE; };
+template <> struct AttributeTraits<int16_t>  { constexpr static AttributeType TYPE = SHORT_ATTRIBUTE; };
+template <> struct AttributeTraits<uint16_t> { constexpr static AttributeType TYPE = UNSIGNED_SHORT_ATTRIBUTE; };
+template <> struct AttributeTraits<int32_t>  { constexpr static AttributeType TYPE = INT_ATTRIBUTE; };
+template <> struct AttributeTraits<uint32_t> { constexpr static AttributeType TYPE = UNSIGNED_INT_ATTRIBUTE; };
+template <> struct AttributeTraits<float>    { constexpr static AttributeType TYPE = FLOAT_ATTRIBUTE; };
+template <> struct AttributeTraits<Half>     { constexpr static AttributeType TYPE = HALF_FLOAT_ATTRIBUTE; };
+
+// One attribute as the vertex array sees it. Integer types reach the shader as float, mapped
+// onto [0, 1] or [-1, 1] when normalized.
+struct LayoutAttribute {
+    unsigned int    location;
+    int             components;
+    AttributeType   type;
+    bool            normalized;
+    uint32_t        offset;         // bytes into the vertex
+};
+
+// The attributes of one vertex buffer binding, with their stride and instancing divisor, and
+// a key over all of it so equal layouts are found without comparing them field by field.
+struct LayoutDescriptor {
+    const LayoutAttribute   *attributes;
+    size_t                  count;
+    uint32_t                stride;
+    unsigned int            divisor;    // 0 per vertex, n to advance once every n instances
+    uint64_t                key;
+};
+
+// FNV-1a over every field that reaches GL.
+constexpr uint64_t
+layoutKey(const LayoutAttribute *attributes, size_t count, uint32_t stride, unsigned int divisor) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int byte = 0; byte < 8; byte++)
+            hash = (hash ^ ((value >> (byte * 8)) & 0xff)) * 1099511628211ull;
+    };
+    for (size_t i = 0; i < count; i++) {
+        mix(attributes[i].location);
+        mix((uint64_t)attributes[i].components);
+        mix(attributes[i].type);
+        mix(attributes[i].normalized);
+        mix(attributes[i].offset);
+    }
+    mix(stride);
+    mix(divisor);
+    return hash;
+}
+
+// Components values of T read at Location.
+template <unsigned int Location, typename T, int Components, bool Normalized = false>
+struct Attribute {
+    static_assert(Components >= 1 && Components <= 4, "an attribute has 1 to 4 components");
+
+    using Type = T;
+    constexpr static unsigned int   LOCATION    = Location;
+    constexpr static int            COMPONENTS  = Components;
+    constexpr static AttributeType  TYPE        = AttributeTraits<T>::TYPE;
+    constexpr static bool           NORMALIZED  = Normalized;
+    constexpr static uint32_t       SIZE        = (uint32_t)(sizeof(T) * Components);
+};
+
+// Every attribute starts on 4 bytes.
+constexpr uint32_t
+alignAttribute(uint32_t size) {
+    return (size + 3) & ~3u;
+}
+
+template <typename... Attributes>
+constexpr std::array<LayoutAttribute, sizeof...(Attributes)>
+buildLayout() {
+    std::array<LayoutAttribute, sizeof...(Attributes)> attributes = {};
+    size_t index = 0;
+    uint32_t offset = 0;
+    ((attributes[index++] = LayoutAttribute{ Attributes::LOCATION, Attributes::COMPONENTS, Attributes::TYPE,
+                                             Attributes::NORMALIZED, offset },
+      offset += alignAttribute(Attributes::SIZE)), ...);
+    return attributes;
+}
+
+template <size_t Count>
+constexpr bool
+uniqueLocations(const std::array<LayoutAttribute, Count> &attributes) {
+    for (size_t i = 0; i < Count; i++) {
+        for (size_t j = i + 1; j < Count; j++) {
+            if (attributes[i].location == attributes[j].location)
+                return false;
+        }
+    }
+    return true;
+}
+
+// A vertex declared as its attributes in memory order, e.g. the samples' cube:
+//
+//     using CubeLayout = VertexLayout<Attribute<0, float, 3>, Attribute<1, float, 2>>;
+//
+// Each attribute is padded to 4 bytes as VertexFormat packs them. The stride, offsets and GL
+// types are constants, setupVertexAttributes() or the VertexArrayCache take descriptor().
+template <typename... Attributes>
+struct VertexLayout {
+    constexpr static size_t COUNT = sizeof...(Attributes);
+    constexpr static uint32_t STRIDE = (alignAttribute(Attributes::SIZE) + ... + 0);
+    constexpr static std::array<LayoutAttribute, sizeof...(Attributes)> ATTRIBUTES = buildLayout<Attributes...>();
+
+    static_assert(COUNT > 0, "a vertex layout needs an attribute");
+    static_assert(uniqueLocations(ATTRIBUTES), "two attributes of a vertex layout share a location");
+
+    // Byte offset of the attribute at index in the vertex.
+    template <size_t Index>
+    constexpr static uint32_t offset() { return ATTRIBUTES[Index].offset; }
+
+    constexpr static LayoutDescriptor descriptor(unsigned int divisor = 0) {
+        return { ATTRIBUTES.data(), COUNT, STRIDE, divisor, layoutKey(ATTRIBUTES.data(), COUNT, STRIDE, divisor) };
+    }
+};
+
+// glVertexAttribPointer, enable and divisor for every attribute of layout, reading the bound
+// GL_ARRAY_BUFFER from offset into the bound vertex array. What a GL 3.3 context without
+// ARB_vertex_attrib_binding does, one vertex array per mesh.
+void setupVertexAttributes(const LayoutDescriptor &layout, size_t offset = 0);
+
+}
+
+#endif // !_OPENGL_VERTEX_LAYOUT_H_
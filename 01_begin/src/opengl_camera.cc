@@ -1,7 +1,21 @@
-#define STB_IMAGE_IMPLEMENTATION
-#include "header/stb_image.h"
+#include "header/camera.h"
+#include "header/context.h"
+#include "header/cpu_trace.h"
+#include "header/mesh.h"
+#include "header/frustum.h"
+#include "header/gpu_profiler.h"
+#include "header/indirect_draw.h"
 #include "header/program.h"
+#include "header/program_cache.h"
+#include "header/render_state.h"
+#include "header/ring_buffer.h"
 #include "header/shader.h"
+#include "header/texture.h"
+#include "header/texture_loader.h"
+#include "header/transform_store.h"
+#include "header/uniform_buffer.h"
+#include "header/vertex_array_cache.h"
+#include "header/vertex_layout.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -11,28 +25,42 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <random>
 #include <unistd.h>
+#include <vector>
 
 // settings
 const unsigned int g_screen_width  = 800;
 const unsigned int g_screen_height = 600;
 
 // camera
-glm::vec3 camera_position   = glm::vec3(0.0f, 0.0f,  3.0f);
-glm::vec3 camera_front      = glm::vec3(0.0f, 0.0f, -1.0f);
-glm::vec3 camera_up         = glm::vec3(0.0f, 1.0f,  0.0f);
+opengl::Camera g_camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
 // timing
 GLdouble g_delta_time = 0.0f;	// time between current frame and last frame
 GLdouble g_last_frame = 0.0f;
 
-// mouse
-GLdouble fov = 55.0f;
+// cube field, set from the command line
+const unsigned int g_min_cube_count = 10;
+const unsigned int g_max_cube_count = 1000000;
+unsigned int g_cube_count   = g_min_cube_count;
+bool         g_instanced    = false;    // one glDrawElementsInstanced instead of a draw call per cube
+bool         g_indirect     = false;    // cubes and pyramids culled on the GPU and drawn with one glMultiDrawElementsIndirect
+bool         g_cull         = true;     // skip the draw calls of cubes outside the view frustum
+
+// per-instance model matrix, a mat4 takes the four attribute slots 2..5, advancing once an instance
+using InstanceLayout = opengl::VertexLayout<opengl::Attribute<2, float, 4>, opengl::Attribute<3, float, 4>,
+                                            opengl::Attribute<4, float, 4>, opengl::Attribute<5, float, 4>>;
+static_assert(InstanceLayout::STRIDE == sizeof(glm::mat4), "the instance layout is one mat4");
+constexpr opengl::LayoutDescriptor g_instance_layout = InstanceLayout::descriptor(1);
 
 void FrameBufferSizeChangedCB(GLFWwindow* gl_window, GLint width, GLint height) {
     // Change view port
-    glViewport(0, 0, width, height);
+    opengl::RenderState::current().setViewport(0, 0, width, height);
+    g_camera.setViewport(width, height);
 }
 
 void MouseCB(GLFWwindow* gl_window, GLdouble x_pos, GLdouble y_pos) {
@@ -40,8 +68,6 @@ void MouseCB(GLFWwindow* gl_window, GLdouble x_pos, GLdouble y_pos) {
     static GLboolean    s_first_mouse = true;
     static GLdouble     s_last_x = g_screen_width / 2;
     static GLdouble     s_last_y = g_screen_height / 2;
-    static GLdouble     yaw    = 0.0;
-    static GLdouble     pitch  = 0.0;
 
     if (s_first_mouse) {
         s_last_x = x_pos;
@@ -53,96 +79,123 @@ void MouseCB(GLFWwindow* gl_window, GLdouble x_pos, GLdouble y_pos) {
     s_last_x = x_pos;
     s_last_y = y_pos;
 
-    GLdouble sensitivity = 0.05;
-    x_offset *= sensitivity;
-    y_offset *= sensitivity;
-
-    yaw   += x_offset;
-    pitch += y_offset;
-
-    if(pitch > 89.0f)
-        pitch = 89.0f;
-    if(pitch < -89.0f)
-        pitch = -89.0f;
-
-    glm::vec3 front;
-    front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
-    front.y = sin(glm::radians(pitch));
-    front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
-    camera_front = glm::normalize(front);
+    g_camera.processMouseMove(static_cast<float>(x_offset), static_cast<float>(y_offset));
 }
 
 void ScrollCB(GLFWwindow *gl_window, GLdouble xoffset, GLdouble yoffset) {
-    if (fov >= 1.0f && fov <= 55.0f)
-        fov -= yoffset;
-    if (fov <= 1.0f)
-        fov = 1.0f;
-    if (fov >= 55.0f)
-        fov = 55.0f;
+    g_camera.processMouseScroll(static_cast<float>(yoffset));
 }
 
 void ProcessInput(GLFWwindow* gl_window) {
+    if (!gl_window)
+        return;     // headless, there is no input
     if(glfwGetKey(gl_window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(gl_window, true);
     
-    float camera_speed = static_cast<float>(2.5 * g_delta_time);
+    float delta_time = static_cast<float>(g_delta_time);
     if (glfwGetKey(gl_window, GLFW_KEY_W) == GLFW_PRESS)
-        camera_position += camera_speed * camera_front;
+        g_camera.processKeyboard(opengl::Camera::FORWARD, delta_time);
     if (glfwGetKey(gl_window, GLFW_KEY_S) == GLFW_PRESS)
-        camera_position -= camera_speed * camera_front;
+        g_camera.processKeyboard(opengl::Camera::BACKWARD, delta_time);
     if (glfwGetKey(gl_window, GLFW_KEY_A) == GLFW_PRESS)
-        camera_position -= glm::normalize(glm::cross(camera_front, camera_up)) * camera_speed;
+        g_camera.processKeyboard(opengl::Camera::LEFT, delta_time);
     if (glfwGetKey(gl_window, GLFW_KEY_D) == GLFW_PRESS)
-        camera_position += glm::normalize(glm::cross(camera_front, camera_up)) * camera_speed;
+        g_camera.processKeyboard(opengl::Camera::RIGHT, delta_time);
 }
 
-int main(int argc, char **argv) {
+void ParseArguments(int argc, char **argv) {
+    // usage: 01_opengl_camera [--instanced | --indirect] [--count N] [--no-cull]
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--instanced") == 0) {
+            g_instanced = true;
+        } else if (strcmp(argv[i], "--indirect") == 0) {
+            g_indirect = true;
+        } else if (strcmp(argv[i], "--no-cull") == 0) {
+            g_cull = false;
+        } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            long count = strtol(argv[++i], nullptr, 10);
+            if (count < (long)g_min_cube_count)
+                count = g_min_cube_count;
+            if (count > (long)g_max_cube_count)
+                count = g_max_cube_count;
+            g_cube_count = static_cast<unsigned int>(count);
+        }
+    }
+    if (g_indirect)
+        g_instanced = false;
+}
 
-    // Initialize the glfw3 library.
-    if (!glfwInit())
-        return -1;
-    
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* gl_window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
-    if (!gl_window) {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
+// The cube again, indexed: four corners per face.
+void CubeMesh(std::vector<float> &vertices, std::vector<uint32_t> &indices) {
+    const float corners[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+    for (int axis = 0; axis < 3; axis++) {
+        for (float side : { -0.5f, 0.5f }) {
+            uint32_t first = static_cast<uint32_t>(vertices.size() / 5);
+            for (auto &corner : corners) {
+                float position[3];
+                position[axis] = side;
+                position[(axis + 1) % 3] = corner[0] - 0.5f;
+                position[(axis + 2) % 3] = corner[1] - 0.5f;
+                vertices.insert(vertices.end(), { position[0], position[1], position[2], corner[0], corner[1] });
+            }
+            indices.insert(indices.end(), { first, first + 1, first + 2, first + 2, first + 3, first });
+        }
     }
-    glfwMakeContextCurrent(gl_window);
+}
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        return -1;
+// A square pyramid in the same unit box, so the cube's bounding sphere still holds.
+void PyramidMesh(std::vector<float> &vertices, std::vector<uint32_t> &indices) {
+    const float base[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+    for (auto &corner : base)
+        vertices.insert(vertices.end(), { corner[0], -0.5f, corner[1], corner[0] + 0.5f, corner[1] + 0.5f });
+    indices.insert(indices.end(), { 0, 1, 2, 2, 3, 0 });
+    for (uint32_t side = 0; side < 4; side++) {
+        uint32_t first = static_cast<uint32_t>(vertices.size() / 5);
+        const float *a = base[side], *b = base[(side + 1) % 4];
+        vertices.insert(vertices.end(), { a[0], -0.5f, a[1], 0.0f, 0.0f });
+        vertices.insert(vertices.end(), { b[0], -0.5f, b[1], 1.0f, 0.0f });
+        vertices.insert(vertices.end(), { 0.0f,  0.5f, 0.0f, 0.5f, 1.0f });
+        indices.insert(indices.end(), { first, first + 1, first + 2 });
     }
+}
 
-    glfwSetInputMode(gl_window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+int main(int argc, char **argv) {
+    ParseArguments(argc, argv);
 
-    glfwSetFramebufferSizeCallback(gl_window, FrameBufferSizeChangedCB);
-    glfwSetCursorPosCallback(gl_window, MouseCB);
-    glfwSetScrollCallback(gl_window, ScrollCB);
+    // Open the window, or render offscreen with --headless or OPENGL_HEADLESS=1.
+    opengl::Context *context = opengl::Context::create(opengl::Context::parseOptions(argc, argv));
+    if (!context)
+        return -1;
+    GLFWwindow* gl_window = context->window();
 
+    if (gl_window) {
+        glfwSetInputMode(gl_window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
-    std::string running_path = getcwd(nullptr, 0);
+        glfwSetFramebufferSizeCallback(gl_window, FrameBufferSizeChangedCB);
+        glfwSetCursorPosCallback(gl_window, MouseCB);
+        glfwSetScrollCallback(gl_window, ScrollCB);
+    }
 
-    // configure global opengl state
-    glEnable(GL_DEPTH_TEST);
 
-    // Build and compile our shader program.
-    opengl::Program *program = opengl::Program::create();
-    {
-        running_path += "/resource/";
-        opengl::Shader vertex_shader((running_path + "shader/camera.vs").c_str(), opengl::VERTEX_SHADER);
-        opengl::Shader fragment_shader((running_path + "shader/camera.fs").c_str(), opengl::FRAGMENT_SHADER);
+    std::string running_path = getcwd(nullptr, 0);
 
-        program->attachShader(&vertex_shader);
-        program->attachShader(&fragment_shader);
+    // configure global opengl state, every bind and state change of the loop goes through the cache
+    opengl::RenderState &render_state = opengl::RenderState::current();
+    render_state.setDepthTest(true);
+
+    // Build and compile our shader program, reusing the driver binary cached by an earlier run.
+    running_path += "/resource/";
+    opengl::ProgramCache program_cache(running_path + "cache/");
+    if (g_indirect && !opengl::IndirectDrawList::supported()) {
+        fprintf(stdout, "[Info] --indirect needs GL 4.3 and GL_ARB_shader_draw_parameters, drawing the cubes instanced\n");
+        g_indirect = false;
+        g_instanced = true;
     }
-    if (!program->link())
+    const char *vertex_shader = g_indirect ? "shader/camera_indirect.vs" : g_instanced ? "shader/camera_instanced.vs" : "shader/camera.vs";
+    opengl::Program *program = program_cache.load(running_path + vertex_shader, running_path + "shader/camera.fs");
+    if (!program)
         return -1;
+    program_cache.report();
 
     // Set up vertex data (and buffer(s)) and configure vertex attributes
     GLint  error_code;
@@ -194,8 +247,8 @@ int main(int argc, char **argv) {
         -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
     };
 
-    // world space positions of our cubes
-    glm::vec3 cube_positions[] = {
+    // world space positions of our cubes, the first ten are the classic scene
+    std::vector<glm::vec3> cube_positions = {
         glm::vec3( 0.0f,  0.0f,  0.0f),
         glm::vec3( 2.0f,  5.0f, -15.0f),
         glm::vec3(-1.5f, -2.2f, -2.5f),
@@ -207,107 +260,238 @@ int main(int argc, char **argv) {
         glm::vec3( 1.5f,  0.2f, -1.5f),
         glm::vec3(-1.3f,  1.0f, -1.5f)
     };
+    {
+        // scatter the rest in front of the camera, about one cube per 8 units of volume
+        std::mt19937 generator(42);
+        float half_extent = std::cbrt(static_cast<float>(g_cube_count) * 8.0f) * 0.5f;
+        std::uniform_real_distribution<float> xy(-half_extent, half_extent);
+        std::uniform_real_distribution<float> z(-2.0f * half_extent, 0.0f);
+        cube_positions.reserve(g_cube_count);
+        while (cube_positions.size() < g_cube_count)
+            cube_positions.push_back(glm::vec3(xy(generator), xy(generator), z(generator)));
+    }
+
+    // bounding spheres for culling, a unit cube spinning about its center stays within sqrt(3) / 2
+    std::vector<float> cube_x, cube_y, cube_z, cube_radius(g_cube_count, std::sqrt(3.0f) * 0.5f);
+    for (auto &position : cube_positions) {
+        cube_x.push_back(position.x);
+        cube_y.push_back(position.y);
+        cube_z.push_back(position.z);
+    }
+    opengl::FrustumCuller culler;
+    // with --no-cull every cube is drawn, the same list every frame
+    std::vector<uint32_t> all_cubes;
+    if (!g_cull) {
+        all_cubes.resize(g_cube_count);
+        for (unsigned int i = 0; i < g_cube_count; i++)
+            all_cubes[i] = i;
+    }
 
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // texture coord attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0); 
-    glBindVertexArray(0);
-
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    // Set texture warpping parameters.
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // Set texture filtering parameters.
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Load texture
-    int texture_width, texture_height, nr_channels;
-    stbi_set_flip_vertically_on_load(true);
-    GLubyte *data = stbi_load((running_path + "texture/wall.jpg").c_str(), &texture_width, &texture_height, &nr_channels, 0);
-    if (!data) {
-        fprintf(stdout, "[Error] Fail to load texture!");
+    // the 36 corners welded into shared vertices, drawn indexed in cache-friendly order, 12 bytes a vertex:
+    // half positions are exact for the corners at 0.5 and unorm16 for the texture coordinates at 0 and 1
+    opengl::MeshOptions mesh_options;
+    mesh_options.format = opengl::VertexFormat().add(0, 3, opengl::HALF_FLOAT).add(1, 2, opengl::UNORM16);
+    opengl::Mesh *cube = opengl::Mesh::create(vertices, sizeof(vertices) / sizeof(float) / opengl::Mesh::VERTEX_FLOATS,
+                                              mesh_options);
+    if (!cube)
         return -1;
-    } else {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texture_width, texture_height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    cube->report();
+
+    // per-instance model matrices, streamed through a ring of frame segments so a frame never waits for the previous one's draw
+    opengl::RingBuffer *instance_ring = nullptr;
+    opengl::TransformStore cube_transforms;
+    if (g_instanced) {
+        cube_transforms.reserve(g_cube_count);
+        for (unsigned int i = 0; i < g_cube_count; i++)
+            cube_transforms.add(cube_positions[i], glm::vec3(1.0f, 0.3f, 0.5f), 0.0f, glm::radians(20.0f * i));
+        instance_ring = opengl::RingBuffer::create(GL_ARRAY_BUFFER, g_cube_count * sizeof(glm::mat4));
+        if (!instance_ring)
+            return -1;
+    }
+
+    render_state.bindBuffer(GL_ARRAY_BUFFER, 0);
+    render_state.bindVertexArray(0);
+
+    // cubes and pyramids sub-allocated from one vertex and index buffer, the GPU culls them and writes the draw commands
+    opengl::MeshArena *mesh_arena = nullptr;
+    opengl::Program *cull_program = nullptr;
+    opengl::IndirectDrawList *draw_list = nullptr;
+    opengl::RingBuffer *model_ring = nullptr;
+    GLint storage_alignment = 0;
+    if (g_indirect) {
+        std::vector<float> mesh_vertices;
+        std::vector<uint32_t> mesh_indices;
+        CubeMesh(mesh_vertices, mesh_indices);
+        mesh_arena = opengl::MeshArena::create();
+        if (!mesh_arena)
+            return -1;
+        uint32_t cube_mesh = mesh_arena->add(mesh_vertices.data(), mesh_vertices.size() / 5, mesh_indices.data(), mesh_indices.size());
+        mesh_vertices.clear();
+        mesh_indices.clear();
+        PyramidMesh(mesh_vertices, mesh_indices);
+        uint32_t pyramid_mesh = mesh_arena->add(mesh_vertices.data(), mesh_vertices.size() / 5, mesh_indices.data(), mesh_indices.size());
+        if (cube_mesh == opengl::MeshArena::INVALID_MESH || pyramid_mesh == opengl::MeshArena::INVALID_MESH)
+            return -1;
+
+        // every third object past the classic ten is a pyramid
+        std::vector<uint32_t> meshes(g_cube_count);
+        std::vector<glm::vec4> spheres(g_cube_count);
+        for (unsigned int i = 0; i < g_cube_count; i++) {
+            meshes[i] = (i >= 10 && i % 3 == 2) ? pyramid_mesh : cube_mesh;
+            spheres[i] = glm::vec4(cube_positions[i], cube_radius[i]);
+        }
+        cull_program = program_cache.load({ { running_path + "shader/cull_draws.cs", opengl::COMPUTE_SHADER } });
+        if (!cull_program)
+            return -1;
+        draw_list = opengl::IndirectDrawList::create(*mesh_arena, meshes, spheres, cull_program);
+        if (!draw_list)
+            return -1;
+
+        cube_transforms.reserve(g_cube_count);
+        for (unsigned int i = 0; i < g_cube_count; i++)
+            cube_transforms.add(cube_positions[i], glm::vec3(1.0f, 0.3f, 0.5f), 0.0f, glm::radians(20.0f * i));
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storage_alignment);
+        model_ring = opengl::RingBuffer::create(GL_SHADER_STORAGE_BUFFER, g_cube_count * sizeof(glm::mat4));
+        if (!model_ring)
+            return -1;
     }
-    stbi_image_free(data);
+
+    // Load texture, decoded on a worker thread and uploaded by update() while the placeholder shows.
+    opengl::TextureLoader *texture_loader = opengl::TextureLoader::create();
+    if (!texture_loader)
+        return -1;
+    opengl::TextureHandle texture = texture_loader->load(running_path + "texture/wall.jpg");
 
     program->use();
     program->setParam1("texture_sampler", 0);
 
+    // resolve the per-object uniform once, so the render loop does no name lookups
+    auto model_uniform = g_instanced || g_indirect ? opengl::Uniform<glm::mat4>() : program->uniform<glm::mat4>("model");
+
+    // view and projection go into the per-frame block that every program shares
+    opengl::UniformBuffer *frame_buffer = opengl::UniformBuffer::create(sizeof(opengl::FrameData), opengl::FRAME_DATA_BINDING);
+    uint64_t frame_generation = ~0ull;  // camera generation the block was written for
+
+    // the GPU time of each pass of the frame, with --gpu-profile
+    opengl::GpuProfiler &profiler = opengl::GpuProfiler::current();
+
     // Check whether the GLFW is required to exit.
-    while (!glfwWindowShouldClose(gl_window)) {
+    while (!context->shouldClose()) {
         // per-frame time logic
-        float current_frame = static_cast<float>(glfwGetTime());
+        double current_frame = context->time();
         g_delta_time = current_frame - g_last_frame;
         g_last_frame = current_frame;
 
         // Process Input
-        ProcessInput(gl_window);
+        {
+            OPENGL_TRACE_ZONE("input");
+            ProcessInput(gl_window);
+        }
 
         // Render 
+        profiler.begin("clear");
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // also clear the depth buffer now!
+        profiler.end();
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        profiler.begin("texture upload");
+        texture_loader->update();
+        profiler.end();
+        render_state.bindTexture(0, GL_TEXTURE_2D, texture_loader->texture(texture));
 
         // Use program
         program->use();
 
-        // create transformations
-        glm::mat4 view = glm::mat4(1.0f);
-        view = glm::lookAt(camera_position, camera_position + camera_front, camera_up);
-        // pass transformation matrices to the shader
-        program->setMatrix4("view", view);
-        glm::mat4 projection = glm::perspective(glm::radians(fov), (GLdouble)g_screen_width / (GLdouble)g_screen_height, 0.1, 100.0);
-        program->setMatrix4("projection", projection); // note: currently we set the projection matrix each frame, but since the projection matrix rarely changes it's often best practice to set it outside the main loop only once.
+        // write the per-frame block once, whatever number of programs read it, and only when the camera moved
+        if (g_camera.generation() != frame_generation) {
+            frame_buffer->update(opengl::FrameData(g_camera.viewMatrix(), g_camera.projectionMatrix(), g_camera.position()));
+            frame_generation = g_camera.generation();
+        }
 
         // render boxes
-        for (unsigned int i = 0; i < 10; i++) {
-            glBindVertexArray(VAO);
-
-            // calculate the model matrix for each object and pass it to shader before drawing
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, cube_positions[i]);
-            float angle = 20.0f * i;
-            model = glm::rotate(model, (float)glfwGetTime() * glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-            program->setMatrix4("model", model);
-
-            glDrawArrays(GL_TRIANGLES, 0, 36);
-            glBindVertexArray(0);
+        profiler.begin("boxes");
+        if (g_instanced) {
+            OPENGL_TRACE_ZONE("draw instanced");
+            // build every model matrix straight into this frame's segment, then draw the whole field with one call
+            instance_ring->beginFrame();
+            opengl::RingAllocation instance_models = instance_ring->allocate(g_cube_count * sizeof(glm::mat4));
+            if (instance_models.isValid()) {
+                cube_transforms.computeModels((float)context->time(), static_cast<float*>(instance_models.data));
+                instance_ring->flush();
+
+                // the instance attributes read the segment, a rebind of the instance buffer at its offset
+                cube->drawInstanced(g_cube_count, g_instance_layout, instance_ring->buffer(), instance_models.offset);
+            }
+            instance_ring->endFrame();
+        } else if (g_indirect) {
+            OPENGL_TRACE_ZONE("draw indirect");
+            // the CPU only streams the model matrices, culling and the commands of every draw are left to the GPU
+            model_ring->beginFrame();
+            opengl::RingAllocation models = model_ring->allocate(g_cube_count * sizeof(glm::mat4), storage_alignment);
+            if (models.isValid()) {
+                cube_transforms.computeModels((float)context->time(), static_cast<float*>(models.data));
+                model_ring->flush();
+                render_state.bindBufferRange(GL_SHADER_STORAGE_BUFFER, opengl::DRAW_MODELS_BINDING, model_ring->buffer(),
+                                             models.offset, models.size);
+                if (g_cull) {
+                    profiler.begin("cull");
+                    draw_list->cull();
+                    profiler.end();
+                }
+                program->use();
+                draw_list->draw(*mesh_arena);
+            }
+            model_ring->endFrame();
+        } else {
+            OPENGL_TRACE_ZONE("draw");
+            // only the cubes that can be on screen get a draw call
+            const std::vector<uint32_t> &cubes = g_cull ? culler.cullSpheres(g_camera.frustum(),
+                cube_x.data(), cube_y.data(), cube_z.data(), cube_radius.data(), g_cube_count) : all_cubes;
+            for (unsigned int i : cubes) {
+                // calculate the model matrix for each object and pass it to shader before drawing
+                glm::mat4 model = glm::mat4(1.0f);
+                model = glm::translate(model, cube_positions[i]);
+                float angle = 20.0f * i;
+                model = glm::rotate(model, (float)context->time() * glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+                program->set(model_uniform, model);
+
+                cube->draw();
+            }
         }
+        profiler.end();
 
         // Check and call the event, swapping the buffer.
-        glfwPollEvents();
-        glfwSwapBuffers(gl_window);
+        context->endFrame();
     }
 
     // Optional: de-allocate all resources once they've outlived their purpose:
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
+    delete cube;
+    opengl::VertexArrayCache::current().report();
+    opengl::VertexArrayCache::current().clear();
+    texture_loader->report();
+    opengl::Texture::reportMemory();
+    delete texture_loader;
+    if (instance_ring) {
+        instance_ring->report();
+        delete instance_ring;
+    }
+    if (draw_list) {
+        fprintf(stdout, "[Info] Indirect draws: %zu draws in one call, %zu visible in the last frame\n",
+                draw_list->drawCount(), draw_list->countVisible());
+        model_ring->report();
+        mesh_arena->report();
+        delete model_ring;
+        delete draw_list;
+        delete mesh_arena;
+        delete cull_program;
+    }
 
+    culler.stats().report();
+    delete frame_buffer;
     delete program;
 
     // Terminate, clearing all previously allocated GLFW resources.
-    glfwTerminate();
+    context->report();
+    delete context;
     return 0;
 }
\ No newline at end of file
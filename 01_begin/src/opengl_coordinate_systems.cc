@@ -1,7 +1,13 @@
-#define STB_IMAGE_IMPLEMENTATION
-#include "header/stb_image.h"
+#include "header/context.h"
+#include "header/cpu_trace.h"
+#include "header/gpu_profiler.h"
+#include "header/mesh.h"
 #include "header/program.h"
+#include "header/program_cache.h"
+#include "header/render_state.h"
 #include "header/shader.h"
+#include "header/texture.h"
+#include "header/uniform_buffer.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -20,58 +26,42 @@ const unsigned int g_screen_height = 600;
 
 void frameBufferSizeChangedCallBack(GLFWwindow* gl_window, int width, int height) {
     // Change view port
-    glViewport(0, 0, width, height);
+    opengl::RenderState::current().setViewport(0, 0, width, height);
 }
 
 void processInput(GLFWwindow* gl_window) {
+    if (!gl_window)
+        return;     // headless, there is no input
     if(glfwGetKey(gl_window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(gl_window, true);
 }
 
 int main(int argc, char **argv) {
 
-    // Initialize the glfw3 library.
-    if (!glfwInit())
+    // Open the window, or render offscreen with --headless or OPENGL_HEADLESS=1.
+    opengl::Context *context = opengl::Context::create(opengl::Context::parseOptions(argc, argv));
+    if (!context)
         return -1;
-    
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* gl_window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
-    if (!gl_window) {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
-    }
-    glfwMakeContextCurrent(gl_window);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        return -1;
-    }
+    GLFWwindow* gl_window = context->window();
 
-    // Change view port
-    glViewport(0, 0, g_screen_width, g_screen_height);
-    glfwSetFramebufferSizeCallback(gl_window, frameBufferSizeChangedCallBack);
+    // Change view port, the render state cache drops the call while the size stays the same
+    opengl::RenderState &render_state = opengl::RenderState::current();
+    render_state.setViewport(0, 0, g_screen_width, g_screen_height);
+    if (gl_window)
+        glfwSetFramebufferSizeCallback(gl_window, frameBufferSizeChangedCallBack);
 
     std::string running_path = getcwd(nullptr, 0);
 
     // configure global opengl state
-    glEnable(GL_DEPTH_TEST);
-
-    // Build and compile our shader program.
-    opengl::Program *program = opengl::Program::create();
-    {
-        running_path += "/resource/";
-        opengl::Shader vertex_shader((running_path + "shader/coordinate_systems.vs").c_str(), opengl::VERTEX_SHADER);
-        opengl::Shader fragment_shader((running_path + "shader/coordinate_systems.fs").c_str(), opengl::FRAGMENT_SHADER);
+    render_state.setDepthTest(true);
 
-        program->attachShader(&vertex_shader);
-        program->attachShader(&fragment_shader);
-    }
-    if (!program->link())
+    // Build and compile our shader program, reusing the driver binary cached by an earlier run.
+    running_path += "/resource/";
+    opengl::ProgramCache program_cache(running_path + "cache/");
+    opengl::Program *program = program_cache.load(running_path + "shader/coordinate_systems.vs", running_path + "shader/coordinate_systems.fs");
+    if (!program)
         return -1;
+    program_cache.report();
 
     // Set up vertex data (and buffer(s)) and configure vertex attributes
     GLint  error_code;
@@ -137,102 +127,88 @@ int main(int argc, char **argv) {
         glm::vec3(-1.3f,  1.0f, -1.5f)
     };
 
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // texture coord attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0); 
-    glBindVertexArray(0);
-
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    // Set texture warpping parameters.
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // Set texture filtering parameters.
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Load texture
-    int texture_width, texture_height, nr_channels;
-    stbi_set_flip_vertically_on_load(true);
-    GLubyte *data = stbi_load((running_path + "texture/wall.jpg").c_str(), &texture_width, &texture_height, &nr_channels, 0);
-    if (!data) {
-        fprintf(stdout, "[Error] Fail to load texture!");
+    // weld the 36 corners into shared vertices and draw them indexed, in cache-friendly order,
+    // packed to half positions and unorm16 texture coordinates which hold the cube exactly
+    opengl::MeshOptions mesh_options;
+    mesh_options.format = opengl::VertexFormat().add(0, 3, opengl::HALF_FLOAT).add(1, 2, opengl::UNORM16);
+    opengl::Mesh *cube = opengl::Mesh::create(vertices, sizeof(vertices) / sizeof(float) / opengl::Mesh::VERTEX_FLOATS,
+                                              mesh_options);
+    if (!cube)
         return -1;
-    } else {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texture_width, texture_height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    cube->report();
+
+    // Prefer the cooked texture, its compressed levels are uploaded straight from the file;
+    // when it is missing or its format is not supported by the driver, decode the JPEG into
+    // immutable RGBA8 storage and build the mipmaps.
+    opengl::Texture *texture = opengl::Texture::load(running_path + "texture/wall.ktx2");
+    if (!texture) {
+        fprintf(stdout, "[Info] Falling back to wall.jpg\n");
+        texture = opengl::Texture::load(running_path + "texture/wall.jpg");
     }
-    stbi_image_free(data);
+    if (!texture)
+        return -1;
 
     glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)g_screen_width / (float)g_screen_height, 0.1f, 100.0f);
+    // The camera never moves here, so the per-frame block is written only once.
+    glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f));
+    opengl::UniformBuffer *frame_buffer = opengl::UniformBuffer::create(sizeof(opengl::FrameData), opengl::FRAME_DATA_BINDING);
+    frame_buffer->update(opengl::FrameData(view, projection, glm::vec3(0.0f, 0.0f, 3.0f)));
 
     program->use();
     program->setParam1("texture_sampler", 0);
-    program->setMatrix4("projection", projection); // note: currently we set the projection matrix each frame, but since the projection matrix rarely changes it's often best practice to set it outside the main loop only once.
+
+    // resolve the per-object uniform once, so the render loop does no name lookups
+    auto model_uniform = program->uniform<glm::mat4>("model");
 
     // Check whether the GLFW is required to exit.
-    while (!glfwWindowShouldClose(gl_window)) {
+    while (!context->shouldClose()) {
         // Process Input
-        processInput(gl_window);
+        {
+            OPENGL_TRACE_ZONE("input");
+            processInput(gl_window);
+        }
 
         // Render 
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // also clear the depth buffer now!
+        {
+            opengl::GpuScope scope("clear");
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // also clear the depth buffer now!
+        }
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        texture->bind(0);
 
         // Use program
         program->use();
 
-        // create transformations
-        glm::mat4 view = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-        view = glm::translate(view, glm::vec3(0.0f, 0.0f, -3.0f));
-        // pass transformation matrices to the shader
-        program->setMatrix4("view", view);
-
         // render boxes
+        opengl::GpuProfiler::current().begin("boxes");
         for (unsigned int i = 0; i < 10; i++) {
-            glBindVertexArray(VAO);
-
+            OPENGL_TRACE_ZONE("draw box");
             // calculate the model matrix for each object and pass it to shader before drawing
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, cube_positions[i]);
             float angle = 20.0f * i;
-            model = glm::rotate(model, (float)glfwGetTime() * glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-            program->setMatrix4("model", model);
+            model = glm::rotate(model, (float)context->time() * glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+            program->set(model_uniform, model);
 
-            glDrawArrays(GL_TRIANGLES, 0, 36);
-            glBindVertexArray(0);
+            cube->draw();
         }
+        opengl::GpuProfiler::current().end();
 
         // Check and call the event, swapping the buffer.
-        glfwPollEvents();
-        glfwSwapBuffers(gl_window);
+        context->endFrame();
     }
 
     // Optional: de-allocate all resources once they've outlived their purpose:
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
+    delete cube;
+    opengl::Texture::reportMemory();
+    delete texture;
 
+    delete frame_buffer;
     delete program;
 
     // Terminate, clearing all previously allocated GLFW resources.
-    glfwTerminate();
+    context->report();
+    delete context;
     return 0;
 }
\ No newline at end of file
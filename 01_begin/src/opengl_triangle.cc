@@ -1,5 +1,11 @@
+#include "header/context.h"
+#include "header/cpu_trace.h"
+#include "header/gpu_profiler.h"
 #include "header/program.h"
+#include "header/program_cache.h"
+#include "header/render_state.h"
 #include "header/shader.h"
+#include "header/vertex_layout.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -11,54 +17,38 @@
 
 void frameBufferSizeChangedCallBack(GLFWwindow* gl_window, int width, int height) {
     // Change view port
-    glViewport(0, 0, width, height);
+    opengl::RenderState::current().setViewport(0, 0, width, height);
 }
 
 void processInput(GLFWwindow* gl_window) {
+    if (!gl_window)
+        return;     // headless, there is no input
     if(glfwGetKey(gl_window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(gl_window, true);
 }
 
 int main(int argc, char **argv) {
 
-    // Initialize the glfw3 library.
-    if (!glfwInit())
+    // Open the window, or render offscreen with --headless or OPENGL_HEADLESS=1.
+    opengl::Context *context = opengl::Context::create(opengl::Context::parseOptions(argc, argv));
+    if (!context)
         return -1;
-    
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* gl_window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
-    if (!gl_window) {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
-    }
-    glfwMakeContextCurrent(gl_window);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        return -1;
-    } 
-
-    // Change view port
-    glViewport(0, 0, 800, 600);
-    glfwSetFramebufferSizeCallback(gl_window, frameBufferSizeChangedCallBack);
-
-    // Build and compile our shader program.
-    opengl::Program *program = opengl::Program::create();
-    {
-        std::string running_path = getcwd(nullptr, 0);
-        running_path += "/resource/shader/";
-        opengl::Shader vertex_shader((running_path + "triangle.vs").c_str(), opengl::VERTEX_SHADER);
-        opengl::Shader fragment_shader((running_path + "triangle.fs").c_str(), opengl::FRAGMENT_SHADER);
-
-        program->attachShader(&vertex_shader);
-        program->attachShader(&fragment_shader);
-    }
-    if (!program->link())
+    GLFWwindow* gl_window = context->window();
+
+    // Change view port, the render state cache drops the call while the size stays the same
+    opengl::RenderState &render_state = opengl::RenderState::current();
+    render_state.setViewport(0, 0, 800, 600);
+    if (gl_window)
+        glfwSetFramebufferSizeCallback(gl_window, frameBufferSizeChangedCallBack);
+
+    // Build and compile our shader program, reusing the driver binary cached by an earlier run.
+    std::string running_path = getcwd(nullptr, 0);
+    running_path += "/resource/";
+    opengl::ProgramCache program_cache(running_path + "cache/");
+    opengl::Program *program = program_cache.load(running_path + "shader/triangle.vs", running_path + "shader/triangle.fs");
+    if (!program)
         return -1;
+    program_cache.report();
 
     // Set up vertex data (and buffer(s)) and configure vertex attributes
     GLint error_code;
@@ -85,11 +75,10 @@ int main(int argc, char **argv) {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    // Position and color attributes, the stride and offsets follow from the layout
+    using Layout = opengl::VertexLayout<opengl::Attribute<0, float, 3>, opengl::Attribute<1, float, 3>>;
+    static_assert(Layout::STRIDE == 6 * sizeof(float), "a vertex is 6 floats");
+    opengl::setupVertexAttributes(Layout::descriptor());
 
     // Note that this is allowed, the call to glVertexAttribPointer registered VBO as the vertex attribute's bound vertex buffer object so afterwards we can safely unbind
     glBindBuffer(GL_ARRAY_BUFFER, 0); 
@@ -102,38 +91,45 @@ int main(int argc, char **argv) {
     glBindVertexArray(0);
 
     // Check whether the GLFW is required to exit.
-    while (!glfwWindowShouldClose(gl_window)) {
+    while (!context->shouldClose()) {
         // Process Input
-        processInput(gl_window);
+        {
+            OPENGL_TRACE_ZONE("input");
+            processInput(gl_window);
+        }
 
         // Render background
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        {
+            opengl::GpuScope scope("clear");
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
 
         // Use program.
         program->use();
 
-        // Seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
-        glBindVertexArray(VAO);
-        // glDrawArrays(GL_TRIANGLES, 0, 3);
-        glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, 0);
-        // No need to unbind it every time
-        glBindVertexArray(0);
+        // Seeing as we only have a single VAO there's no need to bind it every time, the cache only binds it on the first frame
+        render_state.bindVertexArray(VAO);
+        {
+            opengl::GpuScope scope("triangle");
+            OPENGL_TRACE_ZONE("draw");
+            // glDrawArrays(GL_TRIANGLES, 0, 3);
+            glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, 0);
+        }
 
         // Check and call the event, swapping the buffer.
-        glfwPollEvents();
-        glfwSwapBuffers(gl_window);
+        context->endFrame();
     }
 
     // Optional: de-allocate all resources once they've outlived their purpose:
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    render_state.deleteVertexArray(VAO);
+    render_state.deleteBuffer(VBO);
+    render_state.deleteBuffer(EBO);
     
     delete program;
 
     // Terminate, clearing all previously allocated GLFW resources.
-    glfwTerminate();
+    context->report();
+    delete context;
     return 0;
 }
\ No newline at end of file
@@ -1,3 +1,7 @@
+#include "header/context.h"
+#include "header/cpu_trace.h"
+#include "header/gpu_profiler.h"
+
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
@@ -9,52 +13,46 @@ void frameBufferSizeChangedCallBack(GLFWwindow* window, int width, int height) {
 }
 
 void processInput(GLFWwindow* window) {
+    if (!window)
+        return;     // headless, there is no input
     if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 }
 
 int main(int argc, char **argv) {
 
-    /* Initialize the glfw3 library */
-    if (!glfwInit())
-        return -1;
-    
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
-    if (!window) {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
-    }
-    glfwMakeContextCurrent(window);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // Open the window, or render offscreen with --headless or OPENGL_HEADLESS=1.
+    opengl::Context *context = opengl::Context::create(opengl::Context::parseOptions(argc, argv));
+    if (!context)
         return -1;
-    }
+    GLFWwindow* window = context->window();
 
     // Change view port
     glViewport(0, 0, 800, 600);
-    glfwSetFramebufferSizeCallback(window, frameBufferSizeChangedCallBack);
+    if (window)
+        glfwSetFramebufferSizeCallback(window, frameBufferSizeChangedCallBack);
 
     // Check whether the GLFW is required to exit.
-    while (!glfwWindowShouldClose(window)) {
+    while (!context->shouldClose()) {
         // Process Input
-        processInput(window);
+        {
+            OPENGL_TRACE_ZONE("input");
+            processInput(window);
+        }
 
         // Render 
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        {
+            opengl::GpuScope scope("clear");
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
 
         // Check and call the event, swapping the buffer.
-        glfwPollEvents();
-        glfwSwapBuffers(window);
+        context->endFrame();
     }
 
-    glfwTerminate();
+    context->report();
+    delete context;
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "header/ktx2.h"
+#include "header/mipmap.h"
+#include "header/stb_image.h"
+#include "header/texture_compress.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Cook an image into a KTX2 file of GPU-compressed blocks with its whole mip chain, so the
+// samples upload it as is instead of decoding a JPEG and building mipmaps at every launch.
+//
+//   01_texture_cooker [--format bc1|bc3|bc7|etc2] [--filter box|kaiser] [--srgb] [--no-mipmaps] [--no-flip]
+//                     [--threads N] in out.ktx2
+
+struct CookOptions {
+    opengl::CompressedFormat    format      = opengl::BC1;
+    opengl::MipFilter           filter      = opengl::KAISER_FILTER;
+    bool                        srgb        = false;    // also filters the mipmaps in linear light
+    bool                        mipmaps     = true;
+    bool                        flip        = true;     // as the samples load their images
+    unsigned int                threads     = 0;
+    std::string                 input;
+    std::string                 output;
+};
+
+static bool
+parseFormat(const char *name, opengl::CompressedFormat &format) {
+    if (strcmp(name, "bc1") == 0)
+        format = opengl::BC1;
+    else if (strcmp(name, "bc3") == 0)
+        format = opengl::BC3;
+    else if (strcmp(name, "bc7") == 0)
+        format = opengl::BC7;
+    else if (strcmp(name, "etc2") == 0)
+        format = opengl::ETC2_RGB;
+    else
+        return false;
+    return true;
+}
+
+static const char*
+formatName(opengl::CompressedFormat format) {
+    switch (format) {
+    case opengl::BC1:       return "BC1";
+    case opengl::BC3:       return "BC3";
+    case opengl::BC7:       return "BC7";
+    case opengl::ETC2_RGB:  return "ETC2";
+    }
+    return "?";
+}
+
+static bool
+parseOptions(int argc, char **argv, CookOptions &options) {
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            if (!parseFormat(argv[++i], options.format))
+                return false;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "box") == 0)
+                options.filter = opengl::BOX_FILTER;
+            else if (strcmp(argv[i], "kaiser") == 0)
+                options.filter = opengl::KAISER_FILTER;
+            else
+                return false;
+        } else if (strcmp(argv[i], "--srgb") == 0) {
+            options.srgb = true;
+        } else if (strcmp(argv[i], "--no-mipmaps") == 0) {
+            options.mipmaps = false;
+        } else if (strcmp(argv[i], "--no-flip") == 0) {
+            options.flip = false;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = (unsigned int)atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            return false;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.size() != 2)
+        return false;
+    options.input = files[0];
+    options.output = files[1];
+    return true;
+}
+
+int main(int argc, char **argv) {
+    CookOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stdout, "Usage: %s [--format bc1|bc3|bc7|etc2] [--filter box|kaiser] [--srgb] [--no-mipmaps] [--no-flip] "
+                        "[--threads N] input output.ktx2\n", argv[0]);
+        return -1;
+    }
+
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(options.flip);
+    uint8_t *pixels = stbi_load(options.input.c_str(), &width, &height, &channels, 4);
+    if (!pixels) {
+        fprintf(stdout, "[Error] Fail to load texture: %s\n", options.input.c_str());
+        return -1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    opengl::MipOptions mip_options;
+    mip_options.filter = options.filter;
+    mip_options.srgb = options.srgb;
+    mip_options.levels = options.mipmaps ? 0 : 1;
+    opengl::MipChain chain;
+    chain.generate(pixels, width, height, 4, mip_options);
+    stbi_image_free(pixels);
+
+    std::vector<std::vector<uint8_t>> levels;
+    for (int i = 0; i < chain.levelCount(); i++) {
+        const opengl::MipLevel &level = chain.level(i);
+        std::vector<uint8_t> blocks(opengl::compressedSize(options.format, level.width, level.height));
+        opengl::compressImage(options.format, chain.pixels(i), level.width, level.height, blocks.data(), options.threads);
+        levels.push_back(std::move(blocks));
+    }
+    size_t raw_bytes = chain.bytes();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (!opengl::writeKtx2(options.output, options.format, options.srgb, width, height, levels))
+        return -1;
+    size_t bytes = 0;
+    for (auto &level : levels)
+        bytes += level.size();
+    unsigned int threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    fprintf(stdout, "[Info] Cooked %s: %dx%d %s%s, %zu levels, %.1f KiB (%.1f%% of RGBA8) in %.1f ms on %u threads\n",
+            options.output.c_str(), width, height, formatName(options.format), options.srgb ? " sRGB" : "",
+            levels.size(), bytes / 1024.0, 100.0 * bytes / raw_bytes, elapsed_ms, threads);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texture_coord;
+
+out vec2 tex_coord;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 view_projection;
+    vec4 camera_position;
+};
+
+// model matrix of every draw of the multi-draw call, written by the CPU each frame
+layout (std430, binding = 2) readonly buffer DrawModels {
+    mat4 models[];
+};
+
+void main() {
+    gl_Position = view_projection * models[gl_DrawIDARB] * vec4(position, 1.0f);
+    tex_coord = vec2(texture_coord.x, texture_coord.y);
+}
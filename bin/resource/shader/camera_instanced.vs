@@ -0,0 +1,19 @@
+#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texture_coord;
+layout (location = 2) in mat4 instance_model;
+
+out vec2 tex_coord;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 view_projection;
+    vec4 camera_position;
+};
+
+void main() {
+    gl_Position = view_projection * instance_model * vec4(position, 1.0f);
+    tex_coord = vec2(texture_coord.x, texture_coord.y);
+}
\ No newline at end of file
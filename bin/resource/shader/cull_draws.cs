@@ -0,0 +1,71 @@
+#version 430 core
+
+// One invocation per draw of an IndirectDrawList: test its bounding sphere against the
+// frustum of this frame and write its command, instance count 0 when it is culled.
+layout (local_size_x = 64) in;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 view_projection;
+    vec4 camera_position;
+};
+
+struct DrawBounds {
+    vec4 sphere;
+    uint index_count;
+    uint first_index;
+    int  base_vertex;
+    uint padding;
+};
+
+struct DrawCommand {
+    uint count;
+    uint instance_count;
+    uint first_index;
+    int  base_vertex;
+    uint base_instance;
+};
+
+layout (std430, binding = 0) readonly buffer DrawBoundsBuffer {
+    DrawBounds bounds[];
+};
+
+layout (std430, binding = 1) writeonly buffer DrawCommandBuffer {
+    DrawCommand commands[];
+};
+
+uniform int draw_count;
+
+vec4 row(int i) {
+    return vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+}
+
+void main() {
+    uint draw = gl_GlobalInvocationID.x;
+    if (draw >= uint(draw_count))
+        return;
+
+    // the planes of the view-projection matrix, normals pointing into the frustum
+    vec4 planes[6];
+    planes[0] = row(3) + row(0);
+    planes[1] = row(3) - row(0);
+    planes[2] = row(3) + row(1);
+    planes[3] = row(3) - row(1);
+    planes[4] = row(3) + row(2);
+    planes[5] = row(3) - row(2);
+
+    DrawBounds draw_bounds = bounds[draw];
+    bool visible = true;
+    for (int i = 0; i < 6; i++) {
+        vec4 plane = planes[i] / length(planes[i].xyz);
+        if (dot(plane.xyz, draw_bounds.sphere.xyz) + plane.w < -draw_bounds.sphere.w)
+            visible = false;
+    }
+
+    commands[draw].count = draw_bounds.index_count;
+    commands[draw].instance_count = visible ? 1u : 0u;
+    commands[draw].first_index = draw_bounds.first_index;
+    commands[draw].base_vertex = draw_bounds.base_vertex;
+    commands[draw].base_instance = draw;
+}